@@ -0,0 +1,521 @@
+/**
+ * @file lightgui_bench.c
+ * @brief Reproducible performance scenarios for the LightGUI framework
+ *
+ * Each scenario is run once to warm up and then a number of timed
+ * repetitions. Results are printed one JSON object per line so runs of
+ * different builds can be compared with a script:
+ *
+ *   {"scenario":"relabel","size":500,"ops":10000,"min_ns_per_op":...}
+ *
+ * Runs on the display, or without one with LIGHTGUI_BACKEND=headless
+ * (or under xvfb-run to measure the native backend).
+ * Synthetic input is fed straight into the core's dispatch, so it
+ * measures LightGUI rather than the display server.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define WINDOW_WIDTH 1024
+#define WINDOW_HEIGHT 768
+#define CANVAS_SIZE 512
+#define BENCH_WINDOWS 6  // Windows of the multi-window scenarios
+#define MAX_REPS 64
+#define DEFAULT_REPS 5
+
+/**
+ * @brief A benchmark scenario
+ *
+ * setup and teardown are not timed. run performs the workload once and
+ * returns the number of operations it did, which results are divided by.
+ */
+typedef struct {
+    const char* name;
+    const char* unit;  // What one operation is
+    int size;  // Widgets, events or frames, scaled by --scale
+    bool (*setup)(int size);
+    uint64_t (*run)(int size);
+    void (*teardown)(void);
+} Scenario;
+
+// State shared by the scenarios; only one scenario is set up at a time
+static LG_WindowHandle g_window = NULL;
+static LG_WindowHandle g_bench_windows[BENCH_WINDOWS];  // Windows beyond g_window
+static LG_WidgetHandle* g_widgets = NULL;
+static int g_widget_count = 0;
+static LG_WidgetHandle g_canvas = NULL;
+static uint64_t g_events_seen = 0;
+static uint32_t g_random = 1;
+
+/**
+ * @brief Fixed-seed generator so every run does the same work
+ */
+static uint32_t NextRandom(void) {
+    g_random = g_random * 1664525u + 1013904223u;
+    return g_random >> 8;
+}
+
+static void CountEvents(const LG_Event* event, void* user_data) {
+    (void)event;
+    (void)user_data;
+    g_events_seen++;
+}
+
+/* ========================================================================= */
+/*                              Scenario Helpers                             */
+/* ========================================================================= */
+
+static bool CreateBenchWindow(bool windowless) {
+    g_window = LG_CreateWindow("LightGUI Bench", WINDOW_WIDTH, WINDOW_HEIGHT, false);
+    if (!g_window) {
+        return false;
+    }
+
+    LG_SetEventCallback(g_window, CountEvents, NULL);
+    LG_SetWindowlessWidgets(g_window, windowless);
+    LG_ShowWindow(g_window);
+    LG_ProcessEvents();
+    g_events_seen = 0;
+    g_random = 1;
+    return true;
+}
+
+/**
+ * @brief Create a grid of labels covering the window
+ */
+static bool CreateLabels(int count) {
+    g_widgets = (LG_WidgetHandle*)calloc((size_t)count, sizeof(LG_WidgetHandle));
+    if (!g_widgets) {
+        return false;
+    }
+
+    int columns = WINDOW_WIDTH / 100;
+    for (int i = 0; i < count; i++) {
+        int x = (i % columns) * 100;
+        int y = ((i / columns) * 20) % WINDOW_HEIGHT;
+
+        char text[32];
+        snprintf(text, sizeof(text), "Label %d", i);
+        g_widgets[i] = LG_CreateLabel(g_window, text, x, y, 96, 18);
+        if (!g_widgets[i]) {
+            return false;
+        }
+        g_widget_count++;
+    }
+
+    LG_ProcessEvents();
+    return true;
+}
+
+static void DestroyBenchWindow(void) {
+    free(g_widgets);
+    g_widgets = NULL;
+    g_widget_count = 0;
+    g_canvas = NULL;
+
+    if (g_window) {
+        LG_DestroyWindow(g_window);
+        g_window = NULL;
+    }
+    for (int i = 0; i < BENCH_WINDOWS; i++) {
+        if (g_bench_windows[i]) {
+            LG_DestroyWindow(g_bench_windows[i]);
+            g_bench_windows[i] = NULL;
+        }
+    }
+    LG_SetRenderThreads(1);
+    LG_ProcessEvents();
+}
+
+/* ========================================================================= */
+/*                              Scenarios                                    */
+/* ========================================================================= */
+
+static bool SetupWindow(int size) {
+    (void)size;
+    return CreateBenchWindow(false);
+}
+
+static bool SetupNativeLabels(int size) {
+    return CreateBenchWindow(false) && CreateLabels(size);
+}
+
+static bool SetupWindowlessLabels(int size) {
+    return CreateBenchWindow(true) && CreateLabels(size);
+}
+
+static bool SetupMotionCoalesced(int size) {
+    (void)size;
+    if (!CreateBenchWindow(false)) {
+        return false;
+    }
+    LG_SetMotionMode(g_window, LG_MOTION_COALESCE);
+    return true;
+}
+
+static bool SetupCanvas(int size) {
+    (void)size;
+    if (!CreateBenchWindow(false)) {
+        return false;
+    }
+    g_canvas = LG_CreateCanvas(g_window, 0, 0, CANVAS_SIZE, CANVAS_SIZE);
+    LG_ProcessEvents();
+    return g_canvas != NULL;
+}
+
+/**
+ * @brief Create and destroy size native labels
+ */
+static uint64_t RunWidgetChurn(int size) {
+    LG_WidgetHandle* widgets = (LG_WidgetHandle*)malloc((size_t)size * sizeof(LG_WidgetHandle));
+    if (!widgets) {
+        return 0;
+    }
+
+    for (int i = 0; i < size; i++) {
+        widgets[i] = LG_CreateLabel(g_window, "Churn", (i % 10) * 100, (i / 10 % 38) * 20, 96, 18);
+    }
+    for (int i = size; i-- > 0;) {
+        LG_DestroyWidget(widgets[i]);
+    }
+    LG_Flush();
+
+    free(widgets);
+    return (uint64_t)size;
+}
+
+#define FORM_PAGES 10
+
+/**
+ * @brief Create and destroy a form of size native labels on FORM_PAGES
+ *        pages, of which only the first is shown
+ */
+static uint64_t RunPagedForm(int size) {
+    LG_WidgetDesc* descs = (LG_WidgetDesc*)calloc((size_t)size, sizeof(LG_WidgetDesc));
+    LG_WidgetHandle* widgets = (LG_WidgetHandle*)malloc((size_t)size * sizeof(LG_WidgetHandle));
+    if (!descs || !widgets) {
+        free(descs);
+        free(widgets);
+        return 0;
+    }
+
+    int per_page = size / FORM_PAGES > 0 ? size / FORM_PAGES : 1;
+    for (int i = 0; i < size; i++) {
+        descs[i].type = LG_WIDGET_LABEL;
+        descs[i].flags = i >= per_page ? LG_WIDGET_DESC_HIDDEN : 0;
+        descs[i].rect.x = (i % 10) * 100;
+        descs[i].rect.y = (i / 10 % 38) * 20;
+        descs[i].rect.width = 96;
+        descs[i].rect.height = 18;
+        descs[i].text = "Field";
+    }
+
+    uint64_t ops = 0;
+    if (LG_CreateWidgets(g_window, descs, (size_t)size, widgets)) {
+        for (int i = size; i-- > 0;) {
+            LG_DestroyWidget(widgets[i]);
+        }
+        LG_Flush();
+        ops = (uint64_t)size;
+    }
+
+    free(descs);
+    free(widgets);
+    return ops;
+}
+
+#define RELABEL_FRAMES 20
+
+/**
+ * @brief Give every label new text in each of RELABEL_FRAMES batched frames
+ */
+static uint64_t RunRelabel(int size) {
+    (void)size;
+    for (int frame = 0; frame < RELABEL_FRAMES; frame++) {
+        LG_BeginUpdate(g_window);
+        for (int i = 0; i < g_widget_count; i++) {
+            char text[32];
+            snprintf(text, sizeof(text), "Item %d.%d", i, frame);
+            LG_SetWidgetText(g_widgets[i], text);
+        }
+        LG_EndUpdate(g_window);
+        LG_RenderWindow(g_window);
+    }
+    return (uint64_t)g_widget_count * RELABEL_FRAMES;
+}
+
+/**
+ * @brief Dispatch size motion events, one callback each
+ */
+static uint64_t RunMotionDispatch(int size) {
+    for (int i = 0; i < size; i++) {
+        DispatchMouseMotion(g_window, (int)(NextRandom() % WINDOW_WIDTH),
+                            (int)(NextRandom() % WINDOW_HEIGHT));
+    }
+    return (uint64_t)size;
+}
+
+#define MOTION_BATCH 16
+
+/**
+ * @brief Dispatch size motion samples, coalesced MOTION_BATCH to a callback
+ */
+static uint64_t RunMotionCoalesced(int size) {
+    for (int i = 0; i < size; i++) {
+        DispatchMouseMotion(g_window, (int)(NextRandom() % WINDOW_WIDTH),
+                            (int)(NextRandom() % WINDOW_HEIGHT));
+        if (i % MOTION_BATCH == MOTION_BATCH - 1) {
+            FlushPendingMotion();
+        }
+    }
+    FlushPendingMotion();
+    return (uint64_t)size;
+}
+
+/**
+ * @brief Repaint the whole window size times
+ */
+static uint64_t RunRepaintFull(int size) {
+    for (int i = 0; i < size; i++) {
+        LG_RequestRedraw(g_window);
+        LG_RenderWindow(g_window);
+    }
+    return (uint64_t)size;
+}
+
+/**
+ * @brief Change one random label per frame and repaint only what it damaged
+ */
+static uint64_t RunRepaintPartial(int size) {
+    for (int i = 0; i < size; i++) {
+        char text[32];
+        snprintf(text, sizeof(text), "Partial %d", i);
+        LG_SetWidgetText(g_widgets[NextRandom() % (uint32_t)g_widget_count], text);
+        LG_RenderWindow(g_window);
+    }
+    return (uint64_t)size;
+}
+
+/**
+ * @brief Open BENCH_WINDOWS windows of windowless labels; size labels each
+ */
+static bool SetupWindows(int size, int render_threads) {
+    for (int i = 0; i < BENCH_WINDOWS; i++) {
+        g_bench_windows[i] = LG_CreateWindow("LightGUI Bench", WINDOW_WIDTH, WINDOW_HEIGHT, false);
+        if (!g_bench_windows[i]) {
+            return false;
+        }
+        LG_SetWindowlessWidgets(g_bench_windows[i], true);
+        LG_ShowWindow(g_bench_windows[i]);
+
+        int columns = WINDOW_WIDTH / 100;
+        for (int j = 0; j < size; j++) {
+            char text[32];
+            snprintf(text, sizeof(text), "Window %d label %d", i, j);
+            if (!LG_CreateLabel(g_bench_windows[i], text, (j % columns) * 100,
+                                ((j / columns) * 20) % WINDOW_HEIGHT, 96, 18)) {
+                return false;
+            }
+        }
+    }
+
+    LG_ProcessEvents();
+    return LG_SetRenderThreads(render_threads);
+}
+
+static bool SetupWindowsSerial(int size) {
+    return SetupWindows(size, 1);
+}
+
+static bool SetupWindowsParallel(int size) {
+    return SetupWindows(size, 0);
+}
+
+#define WINDOWS_FRAMES 20
+
+/**
+ * @brief Repaint every window in full, WINDOWS_FRAMES times
+ */
+static uint64_t RunRepaintWindows(int size) {
+    (void)size;
+    for (int frame = 0; frame < WINDOWS_FRAMES; frame++) {
+        for (int i = 0; i < BENCH_WINDOWS; i++) {
+            LG_RequestRedraw(g_bench_windows[i]);
+        }
+        RenderDamagedWindows();
+        LG_Flush();
+    }
+    return WINDOWS_FRAMES;
+}
+
+static uint64_t FillCanvas(int frames, uint8_t alpha) {
+    LG_Rect rect = {0, 0, CANVAS_SIZE, CANVAS_SIZE};
+    for (int i = 0; i < frames; i++) {
+        LG_Color color = LG_CreateColor((uint8_t)i, (uint8_t)(i * 3), (uint8_t)(i * 7), alpha);
+        LG_CanvasFillRect(g_canvas, rect, color);
+    }
+    LG_UpdateCanvas(g_canvas);
+    LG_Flush();
+    return (uint64_t)frames * CANVAS_SIZE * CANVAS_SIZE;
+}
+
+static uint64_t RunCanvasFill(int size) {
+    return FillCanvas(size, 255);
+}
+
+static uint64_t RunCanvasBlend(int size) {
+    return FillCanvas(size, 128);
+}
+
+/**
+ * @brief Fill and present the canvas in full size times
+ */
+static uint64_t RunCanvasPresent(int size) {
+    LG_Rect rect = {0, 0, CANVAS_SIZE, CANVAS_SIZE};
+    for (int i = 0; i < size; i++) {
+        LG_CanvasFillRect(g_canvas, rect, LG_CreateColor((uint8_t)i, 0, 0, 255));
+        LG_UpdateCanvas(g_canvas);
+        LG_Flush();
+    }
+    return (uint64_t)size * CANVAS_SIZE * CANVAS_SIZE;
+}
+
+static const Scenario g_scenarios[] = {
+    {"widget_churn", "widget", 1000, SetupWindow, RunWidgetChurn, DestroyBenchWindow},
+    {"paged_form", "widget", 1000, SetupWindow, RunPagedForm, DestroyBenchWindow},
+    {"relabel", "label update", 500, SetupNativeLabels, RunRelabel, DestroyBenchWindow},
+    {"relabel_windowless", "label update", 500, SetupWindowlessLabels, RunRelabel, DestroyBenchWindow},
+    {"motion_dispatch", "event", 100000, SetupWindow, RunMotionDispatch, DestroyBenchWindow},
+    {"motion_coalesced", "event", 100000, SetupMotionCoalesced, RunMotionCoalesced, DestroyBenchWindow},
+    {"repaint_full", "frame", 100, SetupWindowlessLabels, RunRepaintFull, DestroyBenchWindow},
+    {"repaint_partial", "frame", 1000, SetupWindowlessLabels, RunRepaintPartial, DestroyBenchWindow},
+    {"repaint_windows", "frame", 500, SetupWindowsSerial, RunRepaintWindows, DestroyBenchWindow},
+    {"repaint_windows_parallel", "frame", 500, SetupWindowsParallel, RunRepaintWindows, DestroyBenchWindow},
+    {"canvas_fill", "pixel", 200, SetupCanvas, RunCanvasFill, DestroyBenchWindow},
+    {"canvas_blend", "pixel", 200, SetupCanvas, RunCanvasBlend, DestroyBenchWindow},
+    {"canvas_present", "pixel", 100, SetupCanvas, RunCanvasPresent, DestroyBenchWindow},
+};
+
+#define SCENARIO_COUNT (sizeof(g_scenarios) / sizeof(g_scenarios[0]))
+
+/* ========================================================================= */
+/*                              Runner                                       */
+/* ========================================================================= */
+
+static int CompareTimes(const void* a, const void* b) {
+    uint64_t ta = *(const uint64_t*)a;
+    uint64_t tb = *(const uint64_t*)b;
+    return (ta > tb) - (ta < tb);
+}
+
+static bool RunScenario(const Scenario* scenario, double scale, int reps) {
+    int size = (int)(scenario->size * scale);
+    if (size < 1) size = 1;
+
+    if (!scenario->setup(size)) {
+        fprintf(stderr, "lightgui_bench: Failed to set up %s\n", scenario->name);
+        scenario->teardown();
+        return false;
+    }
+
+    // Warm up caches, pools and server-side resources
+    scenario->run(size);
+
+    uint64_t times[MAX_REPS];
+    uint64_t ops = 0;
+    LG_Stats before, after;
+    for (int rep = 0; rep < reps; rep++) {
+        LG_GetStats(&before);
+        g_events_seen = 0;
+        uint64_t start = LG_PlatformGetTime();
+        ops = scenario->run(size);
+        times[rep] = LG_PlatformGetTime() - start;
+        LG_GetStats(&after);
+    }
+
+    scenario->teardown();
+    if (ops == 0) {
+        fprintf(stderr, "lightgui_bench: %s did no work\n", scenario->name);
+        return false;
+    }
+
+    qsort(times, (size_t)reps, sizeof(uint64_t), CompareTimes);
+    double min_ns = times[0] * 1000.0 / (double)ops;
+    double median_ns = times[reps / 2] * 1000.0 / (double)ops;
+
+    // Counters are from the last repetition
+    printf("{\"scenario\":\"%s\",\"unit\":\"%s\",\"size\":%d,\"ops\":%llu,\"reps\":%d,"
+           "\"min_ns_per_op\":%.2f,\"median_ns_per_op\":%.2f,\"ops_per_sec\":%.0f,"
+           "\"heap_allocations\":%llu,\"widget_updates\":%llu,\"pixels_presented\":%llu,"
+           "\"events\":%llu}\n",
+           scenario->name, scenario->unit, size, (unsigned long long)ops, reps,
+           min_ns, median_ns, min_ns > 0 ? 1e9 / min_ns : 0.0,
+           (unsigned long long)(after.heap_allocations - before.heap_allocations),
+           (unsigned long long)(after.widget_updates - before.widget_updates),
+           (unsigned long long)(after.pixels_presented - before.pixels_presented),
+           (unsigned long long)g_events_seen);
+    fflush(stdout);
+    return true;
+}
+
+static void PrintUsage(void) {
+    fprintf(stderr, "Usage: lightgui_bench [--reps N] [--scale X] [--list] [scenario...]\n");
+}
+
+int main(int argc, char* argv[]) {
+    int reps = DEFAULT_REPS;
+    double scale = 1.0;
+    const char* selected[SCENARIO_COUNT];
+    size_t selected_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            reps = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc) {
+            scale = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--list") == 0) {
+            for (size_t s = 0; s < SCENARIO_COUNT; s++) {
+                printf("%s\n", g_scenarios[s].name);
+            }
+            return 0;
+        } else if (argv[i][0] != '-' && selected_count < SCENARIO_COUNT) {
+            selected[selected_count++] = argv[i];
+        } else {
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (reps < 1 || reps > MAX_REPS || scale <= 0) {
+        PrintUsage();
+        return 1;
+    }
+
+    if (!LG_Initialize()) {
+        fprintf(stderr, "lightgui_bench: Failed to initialize LightGUI (no display? set LIGHTGUI_BACKEND=headless)\n");
+        return 1;
+    }
+
+    LG_Stats stats;
+    LG_GetStats(&stats);
+    printf("{\"bench\":\"lightgui\",\"raster_kernels\":\"%s\",\"reps\":%d,\"scale\":%.3f}\n",
+           stats.raster_kernels, reps, scale);
+
+    int failures = 0;
+    for (size_t s = 0; s < SCENARIO_COUNT; s++) {
+        bool wanted = selected_count == 0;
+        for (size_t i = 0; i < selected_count && !wanted; i++) {
+            wanted = strcmp(selected[i], g_scenarios[s].name) == 0;
+        }
+        if (wanted && !RunScenario(&g_scenarios[s], scale, reps)) {
+            failures++;
+        }
+    }
+
+    LG_Terminate();
+    return failures ? 1 : 0;
+}
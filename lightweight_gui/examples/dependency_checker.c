@@ -43,6 +43,9 @@ LG_WidgetHandle generate_cmakelist_button;
 LG_WidgetHandle status_label;
 
 char cmd_output[MAX_CMD_OUTPUT];
+LG_ProcessHandle install_process = NULL;
+LG_TimerHandle install_pulse = NULL;
+bool install_pulse_dim = false;
 
 /**
  * @brief Execute a command and get its output
@@ -288,28 +291,71 @@ void check_vcpkg() {
     update_output(cmd_output);
 }
 
+/**
+ * @brief Fade the status label in and out while the install runs
+ */
+void pulse_status(LG_TimerHandle timer, void* user_data) {
+    (void)timer;
+    (void)user_data;
+    
+    install_pulse_dim = !install_pulse_dim;
+    LG_AnimateColor(status_label, LG_ANIMATE_TEXT_COLOR,
+                    install_pulse_dim ? LG_CreateColor(170, 170, 170, 255) : LG_COLOR_BLACK, 400);
+}
+
 /**
  * @brief Install dependencies via vcpkg
  */
 void install_vcpkg_deps() {
+    if (install_process) {
+        return;  // Still installing
+    }
+    
     clear_output();
     strcpy(cmd_output, "Installing dependencies via vcpkg...\n\n");
     update_output(cmd_output);
     
-    char install_output[MAX_CMD_OUTPUT];
-    bool success = execute_command("vcpkg install glew:x64-windows assimp:x64-windows", 
-                                   install_output, sizeof(install_output));
+    // This takes minutes, so stream the output instead of waiting for it
+    install_process = LG_SpawnProcess(window, "vcpkg install glew:x64-windows assimp:x64-windows");
+    if (!install_process) {
+        strcat(cmd_output, "Error: Failed to execute vcpkg\n");
+        update_output(cmd_output);
+        return;
+    }
     
-    if (success) {
-        strcat(cmd_output, "Dependencies installed successfully:\n");
-    } else {
-        strcat(cmd_output, "Error installing dependencies:\n");
+    install_pulse = LG_AddTimer(500, pulse_status, NULL);
+}
+
+/**
+ * @brief Append installer output, as much as fits
+ */
+void append_install_output(const char* data, size_t size) {
+    size_t length = strlen(cmd_output);
+    if (size > MAX_CMD_OUTPUT - 1 - length) {
+        size = MAX_CMD_OUTPUT - 1 - length;
     }
     
-    strcat(cmd_output, install_output);
+    memcpy(cmd_output + length, data, size);
+    cmd_output[length + size] = '\0';
     update_output(cmd_output);
 }
 
+/**
+ * @brief Report the result of the vcpkg install
+ */
+void finish_install(int exit_code) {
+    const char* result = exit_code == 0 ? "\nDependencies installed successfully\n"
+                                        : "\nError installing dependencies\n";
+    append_install_output(result, strlen(result));
+    LG_SetWidgetText(status_label, exit_code == 0 ? "Dependencies installed" : "Installation failed");
+    install_process = NULL;
+    
+    LG_RemoveTimer(install_pulse);
+    install_pulse = NULL;
+    install_pulse_dim = false;
+    LG_AnimateColor(status_label, LG_ANIMATE_TEXT_COLOR, LG_COLOR_BLACK, 0);
+}
+
 /**
  * @brief Check CMake configuration
  */
@@ -486,6 +532,10 @@ void generate_minimal_cmakelist() {
 void event_callback(LG_Event* event, void* user_data) {
     if (event->type == LG_EVENT_WINDOW_CLOSE) {
         printf("Window close event received\n");
+    } else if (event->type == LG_EVENT_PROCESS_OUTPUT) {
+        append_install_output(event->data.process_output.data, event->data.process_output.size);
+    } else if (event->type == LG_EVENT_PROCESS_EXIT) {
+        finish_install(event->data.process_exit.exit_code);
     } else if (event->type == LG_EVENT_WIDGET_CLICKED) {
         LG_WidgetHandle widget = event->data.widget_clicked.widget;
         
@@ -500,7 +550,7 @@ void event_callback(LG_Event* event, void* user_data) {
             LG_SetWidgetText(status_label, "Assimp dependencies checked");
         } else if (widget == vcpkg_install_button) {
             install_vcpkg_deps();
-            LG_SetWidgetText(status_label, "Installation command executed");
+            LG_SetWidgetText(status_label, "Installing dependencies...");
         } else if (widget == clear_button) {
             clear_output();
             LG_SetWidgetText(status_label, "Output cleared");
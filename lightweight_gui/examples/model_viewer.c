@@ -3,7 +3,8 @@
  * @brief 3D Model Viewer using the LightGUI framework and OpenGL
  * 
  * This example demonstrates how to integrate OpenGL with LightGUI to create
- * a simple 3D model viewer for FBX files.
+ * a simple 3D model viewer for FBX files. Models are loaded on a background
+ * thread and drawn progressively as they stream into the GPU buffers.
  * 
  * Dependencies:
  * - OpenGL (GL/glew.h, GL/gl.h)
@@ -17,6 +18,9 @@
 #include <string.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
 
 // Include platform-specific OpenGL headers
 #ifdef _WIN32
@@ -25,9 +29,11 @@
 #include <GL/gl.h>
 #elif defined(__APPLE__)
 #include <OpenGL/gl.h>
+#include <pthread.h>
 #else
 #include <GL/glew.h>
 #include <GL/gl.h>
+#include <pthread.h>
 #endif
 
 // Include assimp headers for model loading
@@ -41,6 +47,93 @@
 #define CANVAS_HEIGHT 600
 #define MAX_FILENAME 256
 
+/* ========================================================================= */
+/*                        Mesh Format                                        */
+/* ========================================================================= */
+
+/*
+ * All meshes of a model are converted into one interleaved, quantized
+ * vertex buffer and one index buffer. A background thread imports the file
+ * and streams the meshes in chunks straight into persistently mapped GL
+ * buffers, or into staging memory that is uploaded as it fills when
+ * ARB_buffer_storage is missing. The canvas draws whatever has arrived.
+ *
+ * The same chunks are written to "<model>.lgmesh", so reopening an
+ * unchanged model skips assimp and reads them back in order.
+ */
+
+#define MESH_CHUNK_VERTICES 65536
+#define MESH_CHUNK_FACES 65536
+#define MESH_CACHE_EXTENSION ".lgmesh"
+#define MESH_CACHE_VERTICES 0
+#define MESH_CACHE_INDICES 1
+
+/**
+ * @brief One vertex as stored in the vertex buffer, 20 bytes
+ */
+typedef struct PackedVertex {
+    float position[3];
+    uint32_t normal;       // Signed normalized 10:10:10:2, w unused
+    uint16_t texcoord[2];  // Half floats
+} PackedVertex;
+
+/**
+ * @brief Cache file header
+ *
+ * Followed by MeshCacheRecords, each with its vertices or indices, in the
+ * order they were streamed. The cache is in native byte order since it is
+ * only read back on the machine that wrote it.
+ */
+typedef struct MeshCacheHeader {
+    char magic[4];  // "LGM1"
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint32_t reserved;
+    uint64_t source_size;  // Size and modification time of the model file
+    uint64_t source_mtime;
+} MeshCacheHeader;
+
+typedef struct MeshCacheRecord {
+    uint32_t kind;  // MESH_CACHE_VERTICES or MESH_CACHE_INDICES
+    uint32_t count;
+} MeshCacheRecord;
+
+/**
+ * @brief A model being loaded
+ */
+typedef struct MeshLoad {
+    char path[MAX_FILENAME];
+    char cache_path[MAX_FILENAME + sizeof(MESH_CACHE_EXTENSION)];
+    MeshCacheHeader header;       // Totals and source stamp
+    const struct aiScene* scene;  // Source when importing
+    FILE* cache;                  // Source when reading the cache back
+
+    PackedVertex* vertices;  // Mapped vertex buffer, or staging memory
+    uint32_t* indices;
+    bool mapped;
+    uint32_t uploaded_vertices;  // Staging data already uploaded
+    uint32_t uploaded_indices;
+
+    void (*step)(struct MeshLoad* load);
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+    bool thread_active;
+    volatile bool cancel;  // Checked by the thread once per chunk
+    bool failed;
+} MeshLoad;
+
+/**
+ * @brief Data streamed so far, posted to the main thread after each chunk
+ */
+typedef struct MeshProgress {
+    MeshLoad* load;
+    uint32_t vertices;
+    uint32_t indices;
+} MeshProgress;
+
 // Application state
 LG_WindowHandle window = NULL;
 LG_WidgetHandle canvas = NULL;
@@ -58,17 +151,11 @@ LG_WidgetHandle zoom_out = NULL;
 // OpenGL and 3D model state
 GLuint shader_program = 0;
 GLuint vao = 0;
-GLuint vbo_positions = 0;
-GLuint vbo_normals = 0;
-GLuint vbo_texcoords = 0;
+GLuint vbo = 0;  // Interleaved PackedVertex data
 GLuint ebo = 0;
 
-// Model data
-const struct aiScene* scene = NULL;
-struct aiVector3D* vertices = NULL;
-struct aiVector3D* normals = NULL;
-struct aiVector3D* texcoords = NULL;
-unsigned int* indices = NULL;
+// Model data, drawn as far as it has streamed in
+MeshLoad* mesh_load = NULL;  // Model being loaded, if any
 unsigned int num_vertices = 0;
 unsigned int num_indices = 0;
 
@@ -80,7 +167,6 @@ bool wireframe_mode = false;
 
 // Other state
 char model_filename[MAX_FILENAME] = "";
-bool model_loaded = false;
 bool gl_initialized = false;
 
 // Shader source code
@@ -192,12 +278,8 @@ bool init_opengl() {
     glDeleteShader(vertex_shader);
     glDeleteShader(fragment_shader);
     
-    // Create VAO, VBO, and EBO
+    // Create the VAO; each model gets its own buffers
     glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo_positions);
-    glGenBuffers(1, &vbo_normals);
-    glGenBuffers(1, &vbo_texcoords);
-    glGenBuffers(1, &ebo);
     
     // Set up OpenGL viewport
     glViewport(0, 0, CANVAS_WIDTH, CANVAS_HEIGHT);
@@ -208,156 +290,604 @@ bool init_opengl() {
     return true;
 }
 
+/* ========================================================================= */
+/*                        Mesh Streaming                                     */
+/* ========================================================================= */
+
+static void on_model_imported(void* user_data);
+static void on_mesh_progress(void* user_data);
+static void on_model_streamed(void* user_data);
+
+#ifdef _WIN32
+static DWORD WINAPI mesh_thread_main(LPVOID arg) {
+    MeshLoad* load = (MeshLoad*)arg;
+    load->step(load);
+    return 0;
+}
+#else
+static void* mesh_thread_main(void* arg) {
+    MeshLoad* load = (MeshLoad*)arg;
+    load->step(load);
+    return NULL;
+}
+#endif
+
 /**
- * @brief Clean up OpenGL resources
+ * @brief Run one step of a load on a new thread
  */
-void cleanup_opengl() {
-    if (vao) glDeleteVertexArrays(1, &vao);
-    if (vbo_positions) glDeleteBuffers(1, &vbo_positions);
-    if (vbo_normals) glDeleteBuffers(1, &vbo_normals);
-    if (vbo_texcoords) glDeleteBuffers(1, &vbo_texcoords);
-    if (ebo) glDeleteBuffers(1, &ebo);
-    if (shader_program) glDeleteProgram(shader_program);
-    
-    // Free model data
-    if (vertices) free(vertices);
-    if (normals) free(normals);
-    if (texcoords) free(texcoords);
-    if (indices) free(indices);
-    
-    // Release the scene
-    if (scene) aiReleaseImport(scene);
-    
-    // Reset state
-    vertices = NULL;
-    normals = NULL;
-    texcoords = NULL;
-    indices = NULL;
-    scene = NULL;
-    num_vertices = 0;
-    num_indices = 0;
+static bool start_mesh_thread(MeshLoad* load, void (*step)(MeshLoad* load)) {
+    load->step = step;
+#ifdef _WIN32
+    load->thread = CreateThread(NULL, 0, mesh_thread_main, load, 0, NULL);
+    load->thread_active = load->thread != NULL;
+#else
+    load->thread_active = pthread_create(&load->thread, NULL, mesh_thread_main, load) == 0;
+#endif
+    return load->thread_active;
+}
+
+static void join_mesh_thread(MeshLoad* load) {
+    if (!load->thread_active) {
+        return;
+    }
+#ifdef _WIN32
+    WaitForSingleObject(load->thread, INFINITE);
+    CloseHandle(load->thread);
+#else
+    pthread_join(load->thread, NULL);
+#endif
+    load->thread_active = false;
 }
 
 /**
- * @brief Load a 3D model
+ * @brief Convert a float to a half float, rounding to nearest
  */
-bool load_model(const char* filename) {
-    // Clean up previous model if any
-    if (vertices) free(vertices);
-    if (normals) free(normals);
-    if (texcoords) free(texcoords);
-    if (indices) free(indices);
-    if (scene) aiReleaseImport(scene);
+static uint16_t float_to_half(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
     
-    // Reset state
-    vertices = NULL;
-    normals = NULL;
-    texcoords = NULL;
-    indices = NULL;
-    scene = NULL;
-    num_vertices = 0;
-    num_indices = 0;
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (exponent <= 0) {
+        return (uint16_t)sign;  // Below the smallest normal half; flush to zero
+    }
+    if (exponent >= 31) {
+        return (uint16_t)(sign | 0x7BFF);  // Clamp to the largest half
+    }
     
-    // Load the model
-    scene = aiImportFile(filename, 
-                        aiProcess_Triangulate | 
-                        aiProcess_GenSmoothNormals | 
-                        aiProcess_FlipUVs | 
-                        aiProcess_JoinIdenticalVertices);
+    // A rounding carry into the exponent still gives the right value
+    uint32_t half = sign | (uint32_t)exponent << 10 | mantissa >> 13;
+    return (uint16_t)(half + ((mantissa >> 12) & 1));
+}
+
+static uint32_t pack_snorm10(float value) {
+    if (!(value > -1.0f)) value = -1.0f;  // Also catches NaN
+    if (value > 1.0f) value = 1.0f;
+    return (uint32_t)lrintf(value * 511.0f) & 0x3FF;
+}
+
+static uint32_t pack_normal(const struct aiVector3D* normal) {
+    return pack_snorm10(normal->x) | pack_snorm10(normal->y) << 10 |
+           pack_snorm10(normal->z) << 20;
+}
+
+static void pack_vertices(const struct aiMesh* mesh, unsigned int first, uint32_t count,
+                          PackedVertex* out) {
+    const struct aiVector3D* texcoords = mesh->mTextureCoords[0];
+    for (uint32_t i = 0; i < count; i++) {
+        unsigned int v = first + i;
+        out[i].position[0] = mesh->mVertices[v].x;
+        out[i].position[1] = mesh->mVertices[v].y;
+        out[i].position[2] = mesh->mVertices[v].z;
+        out[i].normal = mesh->mNormals ? pack_normal(&mesh->mNormals[v]) : 0;
+        out[i].texcoord[0] = texcoords ? float_to_half(texcoords[v].x) : 0;
+        out[i].texcoord[1] = texcoords ? float_to_half(texcoords[v].y) : 0;
+    }
+}
+
+static bool is_triangle_mesh(const struct aiMesh* mesh) {
+    // aiProcess_SortByPType leaves one primitive type per mesh
+    return mesh->mPrimitiveTypes == aiPrimitiveType_TRIANGLE;
+}
+
+static void post_mesh_progress(MeshLoad* load, uint32_t vertices, uint32_t indices) {
+    MeshProgress* progress = (MeshProgress*)malloc(sizeof(MeshProgress));
+    if (!progress) {
+        return;  // A later chunk reports it
+    }
     
-    if (!scene) {
-        fprintf(stderr, "Failed to load model: %s\n", aiGetErrorString());
+    progress->load = load;
+    progress->vertices = vertices;
+    progress->indices = indices;
+    if (!LG_PostToMainThread(on_mesh_progress, progress)) {
+        free(progress);
+    }
+}
+
+/**
+ * @brief Use the cache if it was written from the current model file
+ */
+static bool open_mesh_cache(MeshLoad* load) {
+    FILE* cache = fopen(load->cache_path, "rb");
+    if (!cache) {
         return false;
     }
     
-    // Process the first mesh (for simplicity)
-    if (scene->mNumMeshes == 0) {
-        fprintf(stderr, "Model has no meshes\n");
-        aiReleaseImport(scene);
-        scene = NULL;
+    MeshCacheHeader header;
+    bool valid = fread(&header, sizeof(header), 1, cache) == 1 &&
+                 memcmp(header.magic, load->header.magic, sizeof(header.magic)) == 0 &&
+                 header.source_size == load->header.source_size &&
+                 header.source_mtime == load->header.source_mtime &&
+                 header.vertex_count > 0 && header.index_count > 0;
+    if (!valid) {
+        fclose(cache);
         return false;
     }
     
-    struct aiMesh* mesh = scene->mMeshes[0];
+    load->header = header;
+    load->cache = cache;
+    return true;
+}
+
+static bool write_cache_record(FILE* cache, uint32_t kind, const void* data, uint32_t count,
+                               size_t size) {
+    MeshCacheRecord record = {kind, count};
+    return fwrite(&record, sizeof(record), 1, cache) == 1 &&
+           fwrite(data, size, count, cache) == count;
+}
+
+/**
+ * @brief Load thread: import the model, or open its cache, and size it
+ */
+static void import_model(MeshLoad* load) {
+    if (!open_mesh_cache(load)) {
+        load->scene = aiImportFile(load->path,
+                                   aiProcess_Triangulate | 
+                                   aiProcess_GenSmoothNormals | 
+                                   aiProcess_FlipUVs | 
+                                   aiProcess_JoinIdenticalVertices |
+                                   aiProcess_SortByPType |
+                                   aiProcess_ImproveCacheLocality);
+        
+        if (!load->scene) {
+            fprintf(stderr, "Failed to load model: %s\n", aiGetErrorString());
+            load->failed = true;
+        } else {
+            uint64_t vertex_count = 0;
+            uint64_t index_count = 0;
+            for (unsigned int i = 0; i < load->scene->mNumMeshes; i++) {
+                const struct aiMesh* mesh = load->scene->mMeshes[i];
+                if (is_triangle_mesh(mesh)) {
+                    vertex_count += mesh->mNumVertices;
+                    index_count += (uint64_t)mesh->mNumFaces * 3;
+                }
+            }
+            
+            if (index_count == 0) {
+                fprintf(stderr, "Model has no triangle meshes\n");
+                load->failed = true;
+            } else if (vertex_count > UINT32_MAX || index_count > UINT32_MAX) {
+                fprintf(stderr, "Model is too large\n");
+                load->failed = true;
+            }
+            load->header.vertex_count = (uint32_t)vertex_count;
+            load->header.index_count = (uint32_t)index_count;
+        }
+    }
     
-    // Allocate memory for vertex data
-    num_vertices = mesh->mNumVertices;
-    vertices = (struct aiVector3D*)malloc(sizeof(struct aiVector3D) * num_vertices);
-    normals = (struct aiVector3D*)malloc(sizeof(struct aiVector3D) * num_vertices);
-    texcoords = (struct aiVector3D*)malloc(sizeof(struct aiVector3D) * num_vertices);
+    // The main thread creates the buffers for the totals and starts streaming
+    LG_PostToMainThread(on_model_imported, load);
+}
+
+/**
+ * @brief Stream the imported meshes, writing the cache alongside
+ */
+static void stream_scene(MeshLoad* load) {
+    // Chunks are converted in cache-sized buffers, then copied out in one
+    // sequential pass, which suits write-combined mapped memory
+    PackedVertex* vertex_chunk = (PackedVertex*)malloc(MESH_CHUNK_VERTICES * sizeof(PackedVertex));
+    uint32_t* index_chunk = (uint32_t*)malloc(MESH_CHUNK_FACES * 3 * sizeof(uint32_t));
+    if (!vertex_chunk || !index_chunk) {
+        free(vertex_chunk);
+        free(index_chunk);
+        load->failed = true;
+        return;
+    }
     
-    // Copy vertex data
-    memcpy(vertices, mesh->mVertices, sizeof(struct aiVector3D) * num_vertices);
-    memcpy(normals, mesh->mNormals, sizeof(struct aiVector3D) * num_vertices);
+    // Only a complete cache is renamed into place
+    char temp_path[sizeof(load->cache_path) + 4];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", load->cache_path);
+    FILE* cache = fopen(temp_path, "wb");
+    bool cache_ok = cache && fwrite(&load->header, sizeof(load->header), 1, cache) == 1;
     
-    // Copy texture coordinates if available
-    if (mesh->mTextureCoords[0]) {
-        for (unsigned int i = 0; i < num_vertices; i++) {
-            texcoords[i].x = mesh->mTextureCoords[0][i].x;
-            texcoords[i].y = mesh->mTextureCoords[0][i].y;
-            texcoords[i].z = 0.0f;
+    const struct aiScene* scene = load->scene;
+    uint32_t vertex_count = 0;
+    uint32_t index_count = 0;
+    for (unsigned int m = 0; m < scene->mNumMeshes && !load->cancel; m++) {
+        const struct aiMesh* mesh = scene->mMeshes[m];
+        if (!is_triangle_mesh(mesh)) {
+            continue;
+        }
+        
+        // Vertices go first, so every index streamed after them can be drawn
+        uint32_t base = vertex_count;
+        for (unsigned int first = 0; first < mesh->mNumVertices && !load->cancel;
+             first += MESH_CHUNK_VERTICES) {
+            uint32_t count = mesh->mNumVertices - first;
+            if (count > MESH_CHUNK_VERTICES) count = MESH_CHUNK_VERTICES;
+            
+            pack_vertices(mesh, first, count, vertex_chunk);
+            memcpy(load->vertices + vertex_count, vertex_chunk, count * sizeof(PackedVertex));
+            cache_ok = cache_ok && write_cache_record(cache, MESH_CACHE_VERTICES, vertex_chunk,
+                                                      count, sizeof(PackedVertex));
+            vertex_count += count;
+        }
+        
+        for (unsigned int first = 0; first < mesh->mNumFaces && !load->cancel;
+             first += MESH_CHUNK_FACES) {
+            uint32_t count = mesh->mNumFaces - first;
+            if (count > MESH_CHUNK_FACES) count = MESH_CHUNK_FACES;
+            
+            for (uint32_t f = 0; f < count; f++) {
+                const unsigned int* face = mesh->mFaces[first + f].mIndices;
+                index_chunk[f * 3] = base + face[0];
+                index_chunk[f * 3 + 1] = base + face[1];
+                index_chunk[f * 3 + 2] = base + face[2];
+            }
+            memcpy(load->indices + index_count, index_chunk, count * 3 * sizeof(uint32_t));
+            cache_ok = cache_ok && write_cache_record(cache, MESH_CACHE_INDICES, index_chunk,
+                                                      count * 3, sizeof(uint32_t));
+            index_count += count * 3;
+            post_mesh_progress(load, vertex_count, index_count);
         }
-    } else {
-        // Initialize with zeros if no texture coordinates
-        memset(texcoords, 0, sizeof(struct aiVector3D) * num_vertices);
     }
     
-    // Allocate memory for index data
-    num_indices = mesh->mNumFaces * 3; // Assuming triangulated mesh
-    indices = (unsigned int*)malloc(sizeof(unsigned int) * num_indices);
+    free(vertex_chunk);
+    free(index_chunk);
     
-    // Copy index data
-    unsigned int index = 0;
-    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-        struct aiFace face = mesh->mFaces[i];
-        for (unsigned int j = 0; j < face.mNumIndices; j++) {
-            indices[index++] = face.mIndices[j];
+    if (cache) {
+        cache_ok = fclose(cache) == 0 && cache_ok && !load->cancel;
+        if (cache_ok) {
+            remove(load->cache_path);  // rename doesn't replace files on Windows
+            cache_ok = rename(temp_path, load->cache_path) == 0;
         }
+        if (!cache_ok) {
+            remove(temp_path);
+        }
+    }
+}
+
+/**
+ * @brief Stream the records of a cache file back in
+ */
+static void stream_cache(MeshLoad* load) {
+    // Read through small buffers so indices can be checked before the GPU sees them
+    PackedVertex* vertex_chunk = (PackedVertex*)malloc(MESH_CHUNK_VERTICES * sizeof(PackedVertex));
+    uint32_t* index_chunk = (uint32_t*)malloc(MESH_CHUNK_FACES * 3 * sizeof(uint32_t));
+    if (!vertex_chunk || !index_chunk) {
+        free(vertex_chunk);
+        free(index_chunk);
+        load->failed = true;
+        return;
     }
     
-    // Bind VAO
-    glBindVertexArray(vao);
+    uint32_t vertex_count = 0;
+    uint32_t index_count = 0;
+    while (!load->cancel && !load->failed &&
+           (vertex_count < load->header.vertex_count || index_count < load->header.index_count)) {
+        MeshCacheRecord record;
+        if (fread(&record, sizeof(record), 1, load->cache) != 1) {
+            load->failed = true;
+        } else if (record.kind == MESH_CACHE_VERTICES && record.count <= MESH_CHUNK_VERTICES &&
+                   record.count <= load->header.vertex_count - vertex_count) {
+            if (fread(vertex_chunk, sizeof(PackedVertex), record.count, load->cache) != record.count) {
+                load->failed = true;
+                break;
+            }
+            memcpy(load->vertices + vertex_count, vertex_chunk, record.count * sizeof(PackedVertex));
+            vertex_count += record.count;
+        } else if (record.kind == MESH_CACHE_INDICES && record.count <= MESH_CHUNK_FACES * 3 &&
+                   record.count <= load->header.index_count - index_count) {
+            if (fread(index_chunk, sizeof(uint32_t), record.count, load->cache) != record.count) {
+                load->failed = true;
+                break;
+            }
+            for (uint32_t i = 0; i < record.count; i++) {
+                if (index_chunk[i] >= vertex_count) {
+                    load->failed = true;
+                    break;
+                }
+            }
+            if (load->failed) {
+                break;
+            }
+            memcpy(load->indices + index_count, index_chunk, record.count * sizeof(uint32_t));
+            index_count += record.count;
+            post_mesh_progress(load, vertex_count, index_count);
+        } else {
+            load->failed = true;
+        }
+    }
     
-    // Set up vertex positions
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_positions);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(struct aiVector3D) * num_vertices, vertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(struct aiVector3D), (void*)0);
-    glEnableVertexAttribArray(0);
+    free(vertex_chunk);
+    free(index_chunk);
     
-    // Set up vertex normals
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_normals);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(struct aiVector3D) * num_vertices, normals, GL_STATIC_DRAW);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(struct aiVector3D), (void*)0);
-    glEnableVertexAttribArray(1);
+    fclose(load->cache);
+    load->cache = NULL;
+    if (load->failed) {
+        fprintf(stderr, "Mesh cache is corrupt, removing %s\n", load->cache_path);
+        remove(load->cache_path);
+    }
+}
+
+/**
+ * @brief Load thread: fill the buffers, then release the source
+ */
+static void stream_model(MeshLoad* load) {
+    if (load->cache) {
+        stream_cache(load);
+    } else {
+        stream_scene(load);
+    }
     
-    // Set up texture coordinates
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_texcoords);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(struct aiVector3D) * num_vertices, texcoords, GL_STATIC_DRAW);
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(struct aiVector3D), (void*)0);
-    glEnableVertexAttribArray(2);
+    if (load->scene) {
+        aiReleaseImport(load->scene);
+        load->scene = NULL;
+    }
+    LG_PostToMainThread(on_model_streamed, load);
+}
+
+static void free_mesh_load(MeshLoad* load) {
+    if (load->scene) aiReleaseImport(load->scene);
+    if (load->cache) fclose(load->cache);
+    if (!load->mapped) {
+        free(load->vertices);
+        free(load->indices);
+    }
+    
+    if (mesh_load == load) {
+        mesh_load = NULL;
+    }
+    free(load);
+}
+
+/**
+ * @brief Create the buffers for a model and map them for the load thread
+ */
+static bool create_mesh_buffers(MeshLoad* load) {
+    GLsizeiptr vertex_size = (GLsizeiptr)load->header.vertex_count * (GLsizeiptr)sizeof(PackedVertex);
+    GLsizeiptr index_size = (GLsizeiptr)load->header.index_count * (GLsizeiptr)sizeof(uint32_t);
+    
+    // Buffer storage is immutable, so every model gets new buffers
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (ebo) glDeleteBuffers(1, &ebo);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    num_vertices = 0;
+    num_indices = 0;
     
-    // Set up element buffer
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(unsigned int) * num_indices, indices, GL_STATIC_DRAW);
     
-    // Unbind VAO
+    if (GLEW_ARB_buffer_storage) {
+        // Coherent, so draws see the load thread's writes without flushing
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, vertex_size, NULL, flags);
+        glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, index_size, NULL, flags);
+        load->vertices = (PackedVertex*)glMapBufferRange(GL_ARRAY_BUFFER, 0, vertex_size, flags);
+        load->indices = (uint32_t*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, index_size, flags);
+        load->mapped = true;
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, vertex_size, NULL, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_size, NULL, GL_STATIC_DRAW);
+        load->vertices = (PackedVertex*)malloc((size_t)vertex_size);
+        load->indices = (uint32_t*)malloc((size_t)index_size);
+    }
+    
+    GLsizei stride = sizeof(PackedVertex);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride,
+                          (void*)offsetof(PackedVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride,
+                          (void*)offsetof(PackedVertex, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride,
+                          (void*)offsetof(PackedVertex, texcoord));
+    glEnableVertexAttribArray(2);
+    
     glBindVertexArray(0);
+    return load->vertices && load->indices;
+}
+
+static void upload_range(GLuint buffer, GLintptr offset, GLsizeiptr size, const void* data) {
+    if (size > 0) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data);
+    }
+}
+
+static void unmap_buffer(GLuint buffer) {
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+}
+
+static void report_model_failure(const MeshLoad* load) {
+    char status_message[512];
+    snprintf(status_message, sizeof(status_message), "Failed to load: %s", load->path);
+    LG_SetWidgetText(status_label, status_message);
+}
+
+static void on_model_imported(void* user_data) {
+    MeshLoad* load = (MeshLoad*)user_data;
+    join_mesh_thread(load);
+    if (load->cancel) {
+        free_mesh_load(load);
+        return;
+    }
+    
+    if (!load->failed && !(LG_CanvasMakeCurrent(canvas) && create_mesh_buffers(load))) {
+        fprintf(stderr, "Failed to create buffers for %s\n", load->path);
+        load->failed = true;
+    }
+    if (!load->failed && !start_mesh_thread(load, stream_model)) {
+        load->failed = true;
+    }
+    
+    if (load->failed) {
+        report_model_failure(load);
+        free_mesh_load(load);
+    }
+}
+
+static void on_mesh_progress(void* user_data) {
+    MeshProgress* progress = (MeshProgress*)user_data;
+    MeshLoad* load = progress->load;
+    
+    // Without a mapping, upload what the load thread wrote since last time
+    if (!load->mapped) {
+        if (!LG_CanvasMakeCurrent(canvas)) {
+            free(progress);
+            return;
+        }
+        upload_range(vbo, (GLintptr)load->uploaded_vertices * (GLintptr)sizeof(PackedVertex),
+                     (GLsizeiptr)(progress->vertices - load->uploaded_vertices) *
+                         (GLsizeiptr)sizeof(PackedVertex),
+                     load->vertices + load->uploaded_vertices);
+        upload_range(ebo, (GLintptr)load->uploaded_indices * (GLintptr)sizeof(uint32_t),
+                     (GLsizeiptr)(progress->indices - load->uploaded_indices) *
+                         (GLsizeiptr)sizeof(uint32_t),
+                     load->indices + load->uploaded_indices);
+        load->uploaded_vertices = progress->vertices;
+        load->uploaded_indices = progress->indices;
+    }
     
+    num_vertices = progress->vertices;
+    num_indices = progress->indices;
+    
+    char status_message[512];
+    snprintf(status_message, sizeof(status_message), "Loading: %s (%u%%)", load->path,
+             (unsigned int)((uint64_t)num_indices * 100 / load->header.index_count));
+    LG_SetWidgetText(status_label, status_message);
+    free(progress);
+}
+
+static void on_model_streamed(void* user_data) {
+    MeshLoad* load = (MeshLoad*)user_data;
+    join_mesh_thread(load);
+    
+    // The buffers keep their contents once unmapped
+    if (load->mapped && LG_CanvasMakeCurrent(canvas)) {
+        if (load->vertices) unmap_buffer(vbo);
+        if (load->indices) unmap_buffer(ebo);
+    }
+    
+    if (load->failed) {
+        num_vertices = 0;
+        num_indices = 0;
+        report_model_failure(load);
+    } else if (!load->cancel) {
+        char status_message[512];
+        snprintf(status_message, sizeof(status_message), 
+                 "Loaded: %s (%u vertices, %u triangles)", 
+                 load->path, num_vertices, num_indices / 3);
+        LG_SetWidgetText(status_label, status_message);
+    }
+    free_mesh_load(load);
+}
+
+/**
+ * @brief Start loading a 3D model in the background
+ */
+bool load_model(const char* filename) {
+    MeshLoad* load = (MeshLoad*)calloc(1, sizeof(MeshLoad));
+    if (!load) {
+        return false;
+    }
+    
+    snprintf(load->path, sizeof(load->path), "%s", filename);
+    snprintf(load->cache_path, sizeof(load->cache_path), "%s" MESH_CACHE_EXTENSION, filename);
+    memcpy(load->header.magic, "LGM1", sizeof(load->header.magic));
+    
+    // The cache is only valid for the exact file it was made from
+    struct stat info;
+    if (stat(filename, &info) != 0) {
+        fprintf(stderr, "Failed to load model: %s not found\n", filename);
+        free(load);
+        return false;
+    }
+    load->header.source_size = (uint64_t)info.st_size;
+    load->header.source_mtime = (uint64_t)info.st_mtime;
+    
+    if (!start_mesh_thread(load, import_model)) {
+        free(load);
+        return false;
+    }
+    
+    mesh_load = load;
     return true;
 }
 
+/**
+ * @brief Stop a load in progress and wait for its thread
+ */
+void cancel_model_load() {
+    if (!mesh_load) {
+        return;
+    }
+    
+    mesh_load->cancel = true;
+    join_mesh_thread(mesh_load);
+    
+    // Run the completion the thread posted, which frees the load
+    LG_ProcessEvents();
+}
+
+/**
+ * @brief Clean up OpenGL resources
+ */
+void cleanup_opengl() {
+    // Stop any load first; it may be writing into the buffers
+    cancel_model_load();
+    
+    if (vao) glDeleteVertexArrays(1, &vao);
+    if (vbo) glDeleteBuffers(1, &vbo);
+    if (ebo) glDeleteBuffers(1, &ebo);
+    if (shader_program) glDeleteProgram(shader_program);
+    
+    // Reset state
+    vao = 0;
+    vbo = 0;
+    ebo = 0;
+    shader_program = 0;
+    num_vertices = 0;
+    num_indices = 0;
+}
+
 /**
  * @brief Render the 3D model
+ * 
+ * LightGUI calls this once per frame with the canvas's context current
+ * and swaps the buffers afterwards.
  */
-void render_model() {
-    if (!model_loaded || !gl_initialized) {
+void render_model(LG_WidgetHandle gl_canvas, int width, int height, void* user_data) {
+    (void)gl_canvas;
+    (void)user_data;
+    
+    if (!gl_initialized) {
         return;
     }
     
     // Clear the color and depth buffers
+    glViewport(0, 0, width, height);
     glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
+    if (num_indices == 0) {
+        return;
+    }
+    
     // Use our shader program
     glUseProgram(shader_program);
     
@@ -386,10 +916,6 @@ void render_model() {
     glBindVertexArray(vao);
     glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_INT, 0);
     glBindVertexArray(0);
-    
-    // Swap buffers and present
-    // Note: In a real integration, we'd need platform-specific code here
-    // to manage the OpenGL context within our LightGUI window
 }
 
 /**
@@ -425,18 +951,20 @@ void reset_view() {
  * @brief Load a model file
  */
 void load_model_file() {
+    if (mesh_load) {
+        update_status("Still loading the previous model");
+        return;
+    }
+    
     if (open_file_dialog(model_filename, MAX_FILENAME)) {
         char status_message[512];
         
         if (load_model(model_filename)) {
             snprintf(status_message, sizeof(status_message), 
-                     "Loaded: %s (%u vertices, %u triangles)", 
-                     model_filename, num_vertices, num_indices / 3);
-            model_loaded = true;
+                     "Loading: %s", model_filename);
         } else {
             snprintf(status_message, sizeof(status_message), 
                      "Failed to load: %s", model_filename);
-            model_loaded = false;
         }
         
         update_status(status_message);
@@ -529,8 +1057,15 @@ int main(void) {
     // Set event callback
     LG_SetEventCallback(window, event_callback, NULL);
     
-    // Create canvas for OpenGL rendering
-    canvas = LG_CreateCanvas(window, 10, 10, CANVAS_WIDTH, CANVAS_HEIGHT);
+    // Create canvas for OpenGL rendering, synced to the display
+    canvas = LG_CreateGLCanvas(window, 10, 10, CANVAS_WIDTH, CANVAS_HEIGHT);
+    if (!canvas) {
+        fprintf(stderr, "Failed to create OpenGL canvas\n");
+        LG_DestroyWindow(window);
+        LG_Terminate();
+        return 1;
+    }
+    LG_SetCanvasSwapInterval(canvas, 1);
     
     // Create UI controls
     int button_x = CANVAS_WIDTH + 20;
@@ -571,11 +1106,12 @@ int main(void) {
     // Status label
     status_label = LG_CreateLabel(window, "Ready to load a model", 10, CANVAS_HEIGHT + 20, WINDOW_WIDTH - 20, 20);
     
-    // Initialize OpenGL
-    gl_initialized = init_opengl();
+    // Initialize OpenGL in the canvas's context, then render it every frame
+    gl_initialized = LG_CanvasMakeCurrent(canvas) && init_opengl();
     if (!gl_initialized) {
         update_status("Failed to initialize OpenGL");
     }
+    LG_SetCanvasRenderCallback(canvas, render_model, NULL);
     
     // Show window
     LG_ShowWindow(window);
@@ -583,7 +1119,8 @@ int main(void) {
     // Run event loop
     LG_Run();
     
-    // Clean up
+    // Clean up while the context still exists
+    LG_CanvasMakeCurrent(canvas);
     cleanup_opengl();
     LG_DestroyWindow(window);
     LG_Terminate();
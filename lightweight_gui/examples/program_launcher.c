@@ -3,7 +3,9 @@
  * @brief Program Launcher for LightGUI Examples
  * 
  * This example provides a simple GUI for building and running
- * all other example applications in the LightGUI framework.
+ * all other example applications in the LightGUI framework. Commands
+ * run with LG_SpawnProcess, so their output streams into the window
+ * while the GUI stays responsive.
  */
 
 #include "../include/lightgui.h"
@@ -15,8 +17,6 @@
 #ifdef _WIN32
 #include <windows.h>
 #include <direct.h>
-#define popen _popen
-#define pclose _pclose
 #define mkdir(dir, mode) _mkdir(dir)
 #define PATH_SEPARATOR "\\"
 #else
@@ -41,8 +41,16 @@ typedef struct {
     LG_WidgetHandle build_button;
     LG_WidgetHandle run_button;
     LG_WidgetHandle status_label;
+    LG_ProcessHandle run_process;  // The example while it runs
 } Example;
 
+// What the build process is doing
+typedef enum {
+    TASK_CONFIGURE,
+    TASK_BUILD,
+    TASK_REBUILD_ALL
+} BuildTask;
+
 // Application state
 LG_WindowHandle window = NULL;
 LG_WidgetHandle output_area = NULL;
@@ -53,39 +61,47 @@ int example_count = 0;
 char current_dir[MAX_PATH];
 char build_dir[MAX_PATH];
 char cmd_output[MAX_CMD_OUTPUT];
+size_t cmd_output_length = 0;
+
+// The configure or build command; one runs at a time
+LG_ProcessHandle build_process = NULL;
+BuildTask build_task;
+int build_index = -1;
 
 /**
- * @brief Execute a command and get its output
+ * @brief Update the output area with text
  */
-bool execute_command(const char* command, char* output, size_t output_size) {
-    FILE* pipe = popen(command, "r");
-    if (!pipe) {
-        snprintf(output, output_size, "Error: Failed to execute command: %s", command);
-        return false;
-    }
+void update_output(const char* text) {
+    LG_SetWidgetText(output_area, text);
+}
 
-    size_t total_read = 0;
-    char buffer[128];
-    while (fgets(buffer, sizeof(buffer), pipe) != NULL && total_read < output_size - 1) {
-        size_t len = strlen(buffer);
-        if (total_read + len >= output_size - 1) {
-            break;
-        }
-        strcpy(output + total_read, buffer);
-        total_read += len;
+/**
+ * @brief Append command output, keeping only the most recent output
+ * 
+ * Called once per output event rather than once per line, so a chatty
+ * build costs one text update per event loop iteration.
+ */
+void append_output(const char* data, size_t size) {
+    if (size >= MAX_CMD_OUTPUT) {
+        data += size - (MAX_CMD_OUTPUT - 1);
+        size = MAX_CMD_OUTPUT - 1;
     }
     
-    output[total_read] = '\0';
-    int status = pclose(pipe);
+    // Drop the oldest output to make room
+    size_t keep = cmd_output_length;
+    if (keep + size > MAX_CMD_OUTPUT - 1) {
+        keep = MAX_CMD_OUTPUT - 1 - size;
+        memmove(cmd_output, cmd_output + cmd_output_length - keep, keep);
+    }
     
-    return status == 0;
+    memcpy(cmd_output + keep, data, size);
+    cmd_output_length = keep + size;
+    cmd_output[cmd_output_length] = '\0';
+    update_output(cmd_output);
 }
 
-/**
- * @brief Update the output area with text
- */
-void update_output(const char* text) {
-    LG_SetWidgetText(output_area, text);
+void append_text(const char* text) {
+    append_output(text, strlen(text));
 }
 
 /**
@@ -93,9 +109,30 @@ void update_output(const char* text) {
  */
 void clear_output() {
     cmd_output[0] = '\0';
+    cmd_output_length = 0;
     update_output(cmd_output);
 }
 
+/**
+ * @brief Start a configure or build command unless one is running
+ */
+bool start_build(const char* command, BuildTask task, int index) {
+    if (build_process) {
+        append_text("A build is already running\n");
+        return false;
+    }
+    
+    build_process = LG_SpawnProcess(window, command);
+    if (!build_process) {
+        append_text("Error: Failed to execute command\n");
+        return false;
+    }
+    
+    build_task = task;
+    build_index = index;
+    return true;
+}
+
 /**
  * @brief Find the project root directory
  * 
@@ -186,8 +223,7 @@ bool initialize_build_environment() {
     
     // Find the project root
     if (!find_project_root(project_root, MAX_PATH)) {
-        strcpy(cmd_output, "Error: Could not determine project root directory.");
-        update_output(cmd_output);
+        append_text("Error: Could not determine project root directory.\n");
         return false;
     }
     
@@ -210,14 +246,14 @@ bool initialize_build_environment() {
 #else
         if (mkdir(build_dir, 0755) != 0) {
 #endif
-            snprintf(cmd_output, MAX_CMD_OUTPUT, "Error: Could not create build directory: %s", build_dir);
-            update_output(cmd_output);
+            char message[MAX_PATH + 64];
+            snprintf(message, sizeof(message), "Error: Could not create build directory: %s\n", build_dir);
+            append_text(message);
             return false;
         }
         
         // Run CMake
-        snprintf(cmd_output, MAX_CMD_OUTPUT, "Creating and configuring build directory...\n");
-        update_output(cmd_output);
+        append_text("Creating and configuring build directory...\n");
         
         char cmake_cmd[MAX_PATH * 2];
 #ifdef _WIN32
@@ -226,8 +262,7 @@ bool initialize_build_environment() {
         snprintf(cmake_cmd, sizeof(cmake_cmd), "cd \"%s\" && cmake \"%s\"", build_dir, project_root);
 #endif
         
-        execute_command(cmake_cmd, cmd_output, MAX_CMD_OUTPUT);
-        update_output(cmd_output);
+        start_build(cmake_cmd, TASK_CONFIGURE, -1);
     }
     
     return true;
@@ -239,9 +274,6 @@ bool initialize_build_environment() {
 void build_example(int index) {
     if (index < 0 || index >= example_count) return;
     
-    // Update status
-    LG_SetWidgetText(examples[index].status_label, "Building...");
-    
     // Create build command
     char build_cmd[MAX_PATH * 2];
     
@@ -255,15 +287,9 @@ void build_example(int index) {
              build_dir, examples[index].name);
 #endif
     
-    // Execute build command
-    bool success = execute_command(build_cmd, cmd_output, MAX_CMD_OUTPUT);
-    update_output(cmd_output);
-    
-    // Update status based on build result
-    if (success) {
-        LG_SetWidgetText(examples[index].status_label, "Build successful");
-    } else {
-        LG_SetWidgetText(examples[index].status_label, "Build failed");
+    // The result arrives with the exit event
+    if (start_build(build_cmd, TASK_BUILD, index)) {
+        LG_SetWidgetText(examples[index].status_label, "Building...");
     }
 }
 
@@ -272,9 +298,7 @@ void build_example(int index) {
  */
 void run_example(int index) {
     if (index < 0 || index >= example_count) return;
-    
-    // Update status
-    LG_SetWidgetText(examples[index].status_label, "Running...");
+    if (examples[index].run_process) return;  // Already running
     
     // Create run command
     char executable_path[MAX_PATH * 2];
@@ -299,45 +323,23 @@ void run_example(int index) {
 #endif
     
     if (!exists) {
-        snprintf(cmd_output, MAX_CMD_OUTPUT, 
-                 "Error: Executable not found: %s\nTry building first.", 
+        char message[MAX_PATH * 2 + 64];
+        snprintf(message, sizeof(message), 
+                 "Error: Executable not found: %s\nTry building first.\n", 
                  executable_path);
-        update_output(cmd_output);
+        append_text(message);
         LG_SetWidgetText(examples[index].status_label, "Not built yet");
         return;
     }
     
-    // Execute run command
-#ifdef _WIN32
-    STARTUPINFO si;
-    PROCESS_INFORMATION pi;
-
-    ZeroMemory(&si, sizeof(si));
-    si.cb = sizeof(si);
-    ZeroMemory(&pi, sizeof(pi));
-
-    // Start the child process. 
-    if (!CreateProcess(executable_path, NULL, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi)) {
-        snprintf(cmd_output, MAX_CMD_OUTPUT, "Error: Failed to launch program. Error code: %lu", GetLastError());
-        update_output(cmd_output);
-        LG_SetWidgetText(examples[index].status_label, "Launch failed");
-        return;
-    }
-
-    // We don't wait for the process to terminate
-    CloseHandle(pi.hProcess);
-    CloseHandle(pi.hThread);
-#else
-    char run_cmd[MAX_PATH * 2];
-    snprintf(run_cmd, sizeof(run_cmd), "\"%s\" &", executable_path);
-    bool success = execute_command(run_cmd, cmd_output, MAX_CMD_OUTPUT);
-    update_output(cmd_output);
-    
-    if (!success) {
+    // Run it with its output going to the output area
+    char run_cmd[MAX_PATH * 2 + 2];
+    snprintf(run_cmd, sizeof(run_cmd), "\"%s\"", executable_path);
+    examples[index].run_process = LG_SpawnProcess(window, run_cmd);
+    if (!examples[index].run_process) {
         LG_SetWidgetText(examples[index].status_label, "Launch failed");
         return;
     }
-#endif
     
     LG_SetWidgetText(examples[index].status_label, "Running");
 }
@@ -346,10 +348,14 @@ void run_example(int index) {
  * @brief Rebuild all examples
  */
 void rebuild_all() {
+    if (build_process) {
+        append_text("A build is already running\n");
+        return;
+    }
+    
     // Update output
     clear_output();
-    snprintf(cmd_output, MAX_CMD_OUTPUT, "Rebuilding all examples...\n");
-    update_output(cmd_output);
+    append_text("Rebuilding all examples...\n");
     
     // Create build command
     char build_cmd[MAX_PATH * 2];
@@ -363,19 +369,45 @@ void rebuild_all() {
 #endif
     
     // Execute build command
-    bool success = execute_command(build_cmd, cmd_output, MAX_CMD_OUTPUT);
-    update_output(cmd_output);
-    
-    // Update status for all examples
-    for (int i = 0; i < example_count; i++) {
-        if (success) {
-            LG_SetWidgetText(examples[i].status_label, "Build successful");
-        } else {
-            LG_SetWidgetText(examples[i].status_label, "Build failed");
+    if (start_build(build_cmd, TASK_REBUILD_ALL, -1)) {
+        for (int i = 0; i < example_count; i++) {
+            LG_SetWidgetText(examples[i].status_label, "Building...");
         }
     }
 }
 
+/**
+ * @brief Report the result of the configure or build command
+ */
+void finish_build(int exit_code) {
+    const char* status = exit_code == 0 ? "Build successful" : "Build failed";
+    build_process = NULL;
+    
+    switch (build_task) {
+        case TASK_CONFIGURE:
+            append_text(exit_code == 0 ? "Configured.\n" : "Error: CMake failed.\n");
+            break;
+        case TASK_BUILD:
+            LG_SetWidgetText(examples[build_index].status_label, status);
+            break;
+        case TASK_REBUILD_ALL:
+            for (int i = 0; i < example_count; i++) {
+                LG_SetWidgetText(examples[i].status_label, status);
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Report that an example has exited
+ */
+void finish_run(int index, int exit_code) {
+    char status[64];
+    snprintf(status, sizeof(status), "Exited (%d)", exit_code);
+    LG_SetWidgetText(examples[index].status_label, status);
+    examples[index].run_process = NULL;
+}
+
 /**
  * @brief Initialize examples list
  */
@@ -423,6 +455,18 @@ void initialize_examples() {
 void event_callback(LG_Event* event, void* user_data) {
     if (event->type == LG_EVENT_WINDOW_CLOSE) {
         printf("Window close event received\n");
+    } else if (event->type == LG_EVENT_PROCESS_OUTPUT) {
+        append_output(event->data.process_output.data, event->data.process_output.size);
+    } else if (event->type == LG_EVENT_PROCESS_EXIT) {
+        LG_ProcessHandle process = event->data.process_exit.process;
+        if (process == build_process) {
+            finish_build(event->data.process_exit.exit_code);
+        }
+        for (int i = 0; i < example_count; i++) {
+            if (process == examples[i].run_process) {
+                finish_run(i, event->data.process_exit.exit_code);
+            }
+        }
     } else if (event->type == LG_EVENT_WIDGET_CLICKED) {
         LG_WidgetHandle widget = event->data.widget_clicked.widget;
         
@@ -8,19 +8,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
-#include <math.h>
-
-#ifdef _WIN32
-#include <windows.h>
-// GDI+ headers
-#include <objidl.h>
-#include <gdiplus.h>
-#pragma comment(lib, "gdiplus.lib")
-using namespace Gdiplus;
-#endif
 
 #define WINDOW_WIDTH 800
 #define WINDOW_HEIGHT 600
+#define CANVAS_X 20
+#define CANVAS_Y 20
 #define CANVAS_WIDTH 700
 #define CANVAS_HEIGHT 500
 #define MAX_PATH_POINTS 1000
@@ -70,99 +62,39 @@ LG_Color colors[NUM_COLORS] = {
     {255, 255, 255, 255}  // White
 };
 
-#ifdef _WIN32
-// GDI+ variables
-GdiplusStartupInput gdiplusStartupInput;
-ULONG_PTR gdiplusToken;
-HWND canvas_hwnd = NULL;
-HDC canvas_hdc = NULL;
-#endif
-
-/**
- * @brief Initialize drawing system
- */
-bool init_drawing() {
-#ifdef _WIN32
-    // Initialize GDI+
-    GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, NULL);
-    
-    // Get canvas HWND
-    canvas_hwnd = (HWND)LG_GetCanvasContext(canvas);
-    if (!canvas_hwnd) {
-        fprintf(stderr, "Failed to get canvas HWND\n");
-        return false;
-    }
-    
-    // Get canvas HDC
-    canvas_hdc = GetDC(canvas_hwnd);
-    if (!canvas_hdc) {
-        fprintf(stderr, "Failed to get canvas HDC\n");
-        return false;
-    }
-#endif
-    return true;
-}
-
-/**
- * @brief Clean up drawing system
- */
-void cleanup_drawing() {
-#ifdef _WIN32
-    if (canvas_hdc && canvas_hwnd) {
-        ReleaseDC(canvas_hwnd, canvas_hdc);
-    }
-    GdiplusShutdown(gdiplusToken);
-#endif
-}
-
 /**
  * @brief Draw a line
  */
 void draw_line(int x1, int y1, int x2, int y2, LG_Color color, int width) {
-#ifdef _WIN32
-    if (!canvas_hdc) return;
-    
-    Graphics graphics(canvas_hdc);
-    Pen pen(Color(color.a, color.r, color.g, color.b), (REAL)width);
-    graphics.DrawLine(&pen, x1, y1, x2, y2);
-#else
-    // Non-Windows implementation would go here
-    // For simplicity, we're focusing on Windows for now
-#endif
+    LG_CanvasDrawLine(canvas, x1, y1, x2, y2, (float)width, color);
+    
+    // Only send the area that changed
+    int reach = width / 2 + 2;
+    LG_Rect changed = {
+        (x1 < x2 ? x1 : x2) - reach,
+        (y1 < y2 ? y1 : y2) - reach,
+        abs(x2 - x1) + 2 * reach + 1,
+        abs(y2 - y1) + 2 * reach + 1
+    };
+    LG_UpdateCanvasRect(canvas, changed);
 }
 
 /**
  * @brief Draw a circle
  */
 void draw_circle(int x, int y, int radius, LG_Color color, bool filled) {
-#ifdef _WIN32
-    if (!canvas_hdc) return;
-    
-    Graphics graphics(canvas_hdc);
-    if (filled) {
-        SolidBrush brush(Color(color.a, color.r, color.g, color.b));
-        graphics.FillEllipse(&brush, x - radius, y - radius, radius * 2, radius * 2);
-    } else {
-        Pen pen(Color(color.a, color.r, color.g, color.b), 1);
-        graphics.DrawEllipse(&pen, x - radius, y - radius, radius * 2, radius * 2);
-    }
-#else
-    // Non-Windows implementation
-#endif
+    LG_CanvasDrawCircle(canvas, x, y, radius, color, filled);
+    
+    LG_Rect changed = {x - radius - 2, y - radius - 2, 2 * radius + 5, 2 * radius + 5};
+    LG_UpdateCanvasRect(canvas, changed);
 }
 
 /**
  * @brief Clear canvas
  */
 void clear_canvas() {
-#ifdef _WIN32
-    if (!canvas_hdc) return;
-    
-    Graphics graphics(canvas_hdc);
-    graphics.Clear(Color(255, 255, 255, 255)); // White background
-#else
-    // Non-Windows implementation
-#endif
+    LG_CanvasClear(canvas, LG_COLOR_WHITE);
+    LG_UpdateCanvas(canvas);
     
     // Reset paths
     path_count = 0;
@@ -191,13 +123,6 @@ void redraw_all_paths() {
             );
         }
     }
-    
-#ifdef _WIN32
-    // Force canvas to update
-    if (canvas_hwnd) {
-        InvalidateRect(canvas_hwnd, NULL, FALSE);
-    }
-#endif
 }
 
 /**
@@ -250,13 +175,6 @@ void add_to_path(int x, int y) {
     // Draw line from previous point to new point
     draw_line(prev_x, prev_y, x, y, colors[path->color_index], path->brush_size);
     
-#ifdef _WIN32
-    // Force canvas to update
-    if (canvas_hwnd) {
-        InvalidateRect(canvas_hwnd, NULL, FALSE);
-    }
-#endif
-    
     current_point = path->num_points;
 }
 
@@ -348,16 +266,14 @@ void event_callback(LG_Event* event, void* user_data) {
         case LG_EVENT_MOUSE_BUTTON:
             {
                 if (event->data.mouse_button.button == LG_MOUSE_BUTTON_LEFT) {
-                    // Check if the event is inside the canvas
-                    int x = event->data.mouse_button.x;
-                    int y = event->data.mouse_button.y;
+                    // Mouse coordinates are window-relative
+                    int x = event->data.mouse_button.x - CANVAS_X;
+                    int y = event->data.mouse_button.y - CANVAS_Y;
                     
-                    if (x >= 0 && x < CANVAS_WIDTH && y >= 0 && y < CANVAS_HEIGHT) {
-                        if (event->data.mouse_button.pressed) {
-                            start_path(x, y);
-                        } else {
-                            end_path();
-                        }
+                    if (!event->data.mouse_button.pressed) {
+                        end_path();
+                    } else if (x >= 0 && x < CANVAS_WIDTH && y >= 0 && y < CANVAS_HEIGHT) {
+                        start_path(x, y);
                     }
                 }
             }
@@ -365,12 +281,14 @@ void event_callback(LG_Event* event, void* user_data) {
             
         case LG_EVENT_MOUSE_MOVE:
             {
-                // Check if we're drawing and the mouse is inside the canvas
-                int x = event->data.mouse_move.x;
-                int y = event->data.mouse_move.y;
-                
-                if (is_drawing && x >= 0 && x < CANVAS_WIDTH && y >= 0 && y < CANVAS_HEIGHT) {
-                    if (event->data.mouse_move.button_pressed[LG_MOUSE_BUTTON_LEFT]) {
+                // Motion is coalesced per frame; replay every sample so the
+                // stroke stays smooth. is_drawing is only set while the left
+                // button is held.
+                for (size_t i = 0; i < event->data.mouse_move.history_count; i++) {
+                    int x = event->data.mouse_move.history[i].x - CANVAS_X;
+                    int y = event->data.mouse_move.history[i].y - CANVAS_Y;
+                    
+                    if (is_drawing && x >= 0 && x < CANVAS_WIDTH && y >= 0 && y < CANVAS_HEIGHT) {
                         add_to_path(x, y);
                     }
                 }
@@ -396,9 +314,10 @@ int main(void) {
     
     // Set event callback
     LG_SetEventCallback(window, event_callback, NULL);
+    LG_SetMotionMode(window, LG_MOTION_COALESCE_HISTORY);
     
     // Create canvas
-    canvas = LG_CreateCanvas(window, 20, 20, CANVAS_WIDTH, CANVAS_HEIGHT);
+    canvas = LG_CreateCanvas(window, CANVAS_X, CANVAS_Y, CANVAS_WIDTH, CANVAS_HEIGHT);
     if (!canvas) {
         fprintf(stderr, "Failed to create canvas\n");
         LG_DestroyWindow(window);
@@ -406,14 +325,6 @@ int main(void) {
         return 1;
     }
     
-    // Initialize drawing system
-    if (!init_drawing()) {
-        fprintf(stderr, "Failed to initialize drawing system\n");
-        LG_DestroyWindow(window);
-        LG_Terminate();
-        return 1;
-    }
-    
     // Create color buttons
     int color_button_x = CANVAS_WIDTH + 40;
     int color_button_y = 20;
@@ -451,7 +362,6 @@ int main(void) {
     LG_Run();
     
     // Clean up
-    cleanup_drawing();
     LG_DestroyWindow(window);
     LG_Terminate();
     
@@ -83,13 +83,15 @@ void rearrange_todos() {
     // Reset the Y position
     y_offset = 120;
     
-    // Reposition all todo items
+    // Reposition all todo items in one batch
+    LG_BeginUpdate(window);
     for (int i = 0; i < todo_count; i++) {
         LG_SetWidgetPosition(todos[i].checkbox, 20, y_offset);
         LG_SetWidgetPosition(todos[i].label, 50, y_offset);
         LG_SetWidgetPosition(todos[i].delete_button, 450, y_offset);
         y_offset += TODO_HEIGHT;
     }
+    LG_EndUpdate(window);
 }
 
 /**
@@ -39,6 +39,14 @@ typedef struct {
     int height;
 } LG_Rect;
 
+/**
+ * @brief Point structure
+ */
+typedef struct {
+    int x;
+    int y;
+} LG_Point;
+
 /**
  * @brief Color structure (RGBA)
  */
@@ -49,6 +57,19 @@ typedef struct {
     uint8_t a;
 } LG_Color;
 
+/**
+ * @brief CPU-side pixel buffer of a canvas widget
+ * 
+ * Each pixel is a 32-bit 0xAARRGGBB value in native byte order. Rows are
+ * stride pixels apart, which may be more than width.
+ */
+typedef struct {
+    uint32_t* pixels;
+    int width;
+    int height;
+    int stride;
+} LG_CanvasBuffer;
+
 /**
  * @brief Event types
  */
@@ -56,11 +77,19 @@ typedef enum {
     LG_EVENT_MOUSE_MOVE,
     LG_EVENT_MOUSE_BUTTON,
     LG_EVENT_KEY,
-    LG_EVENT_WINDOW_RESIZE,
+    LG_EVENT_WINDOW_RESIZE,  /* Once per frame with the final size, only when it changed */
     LG_EVENT_WINDOW_CLOSE,
-    LG_EVENT_WIDGET_CLICKED
+    LG_EVENT_WIDGET_CLICKED,
+    LG_EVENT_USER,  /* Posted with LG_PostUserEvent */
+    LG_EVENT_PROCESS_OUTPUT,  /* Output of a process started with LG_SpawnProcess */
+    LG_EVENT_PROCESS_EXIT
 } LG_EventType;
 
+/**
+ * @brief Number of event types, for arrays indexed by LG_EventType
+ */
+#define LG_EVENT_TYPE_COUNT (LG_EVENT_PROCESS_EXIT + 1)
+
 /**
  * @brief Mouse button identifiers
  */
@@ -80,16 +109,23 @@ typedef enum {
     LG_WIDGET_CANVAS,  /* New canvas widget type for custom rendering */
     LG_WIDGET_CHECKBOX, /* Future implementation */
     LG_WIDGET_SLIDER,
-    LG_WIDGET_PANEL
+    LG_WIDGET_PANEL,
+    LG_WIDGET_LIST  /* Virtual list; rows are drawn on demand from a callback */
 } LG_WidgetType;
 
 /* Forward declarations for internal structures */
 struct LG_Widget;
 struct LG_Window;
+struct LG_Pool;
+struct LG_SpatialIndex;
+struct LG_ListState;
+struct LG_GLCanvasState;
+struct LG_Binding;
 
 /* Opaque handle types */
 typedef struct LG_Window* LG_WindowHandle;
 typedef struct LG_Widget* LG_WidgetHandle;
+typedef struct LG_Process* LG_ProcessHandle;
 
 /**
  * @brief Widget list structure
@@ -100,6 +136,28 @@ typedef struct {
     size_t capacity;
 } LG_WidgetList;
 
+/**
+ * @brief Maximum number of separate rectangles tracked per damage region
+ */
+#define LG_MAX_DAMAGE_RECTS 16
+
+/**
+ * @brief Set of window areas that need to be repainted
+ */
+typedef struct {
+    LG_Rect rects[LG_MAX_DAMAGE_RECTS];
+    int count;
+} LG_DamageRegion;
+
+/**
+ * @brief How pointer motion is reported to a window's event callback
+ */
+typedef enum {
+    LG_MOTION_EVERY_SAMPLE,        /* One event per motion sample (default) */
+    LG_MOTION_COALESCE,            /* One event per loop iteration, latest position */
+    LG_MOTION_COALESCE_HISTORY     /* Like LG_MOTION_COALESCE, with every sample attached */
+} LG_MotionMode;
+
 /**
  * @brief Window structure
  */
@@ -109,12 +167,36 @@ struct LG_Window {
     int height;
     bool visible;
     bool resizable;
+    bool windowless_widgets;  // New widgets are drawn into the window buffer
     LG_WidgetList widgets;
+    int update_depth;  // Nesting level of LG_BeginUpdate
+    LG_WidgetList pending_updates;  // Dirty widgets waiting for LG_EndUpdate
     void (*event_callback)(const struct LG_Event* event, void* user_data);
     void* user_data;
+    LG_DamageRegion damage;  // Areas to repaint on the next render
+    LG_MotionMode motion_mode;
+    bool has_mouse_position;  // last_mouse holds a reported position
+    LG_Point last_mouse;  // Position of the last reported motion, for deltas
+    bool motion_pending;  // pending_mouse has not been dispatched yet
+    LG_Point pending_mouse;
+    LG_Point* motion_history;  // Samples since the last dispatch
+    size_t motion_history_count;
+    size_t motion_history_capacity;
+    bool resize_pending;  // Size changed since the last LG_EVENT_WINDOW_RESIZE
+    size_t unrealized_count;  // Widgets without a native side
+    struct LG_Pool* widget_pool;  // Storage for this window's widgets
+    struct LG_Pool* widget_data_pool;  // Storage for their platform data
+    struct LG_SpatialIndex* spatial;  // Widgets bucketed by position
+    unsigned int next_z_order;
     void* platform_data;  // Platform-specific data
 };
 
+/**
+ * @brief Widget text up to this size (including the terminator) is stored
+ *        inside the widget without a separate allocation
+ */
+#define LG_WIDGET_INLINE_TEXT 32
+
 /**
  * @brief Widget structure
  */
@@ -122,9 +204,22 @@ struct LG_Widget {
     LG_WidgetType type;
     LG_WindowHandle window;
     LG_Rect rect;
-    char* text;
+    char* text;  // Points at text_inline or a heap buffer of text_capacity bytes
+    size_t text_capacity;  // 0 while text_inline is used
+    char text_inline[LG_WIDGET_INLINE_TEXT];
+    size_t text_length;  // strlen(text), kept up to date with the text
+    int text_width;  // Pixel width measured by the backend; -1 until the new text is encoded
     bool visible;
     bool enabled;
+    bool windowless;  // No native window; drawn and hit-tested by the window
+    bool realized;  // The platform side exists; created once the widget comes into view
+    uint64_t hidden_since;  // LG_PlatformGetTime() when last hidden
+    unsigned int dirty;  // Properties not yet applied to the platform widget
+    unsigned int z_order;  // Stacking position; higher is drawn later and hit first
+    unsigned int query_stamp;  // Used by the spatial index to skip duplicates
+    struct LG_ListState* list;  // Only used by list widgets
+    struct LG_GLCanvasState* gl;  // Only used by OpenGL canvases
+    struct LG_Binding* binding;  // Set by LG_BindWidgetText
     LG_Color bg_color;
     LG_Color text_color;
     int id;  // Add an ID field for widget identification
@@ -153,12 +248,20 @@ typedef struct {
 
 /**
  * @brief Mouse move event
+ * 
+ * Coordinates are relative to the window. The delta is measured from the
+ * previous mouse move event delivered to the same window. history holds
+ * every sample folded into this event, oldest first and ending with
+ * (x, y); it only has more than one entry in LG_MOTION_COALESCE_HISTORY
+ * mode and is valid until the callback returns.
  */
 typedef struct {
     int x;
     int y;
     int delta_x;
     int delta_y;
+    const LG_Point* history;
+    size_t history_count;
 } LG_MouseMoveEvent;
 
 /**
@@ -189,6 +292,35 @@ typedef struct {
     int y;
 } LG_WidgetClickedEvent;
 
+/**
+ * @brief User event, as passed to LG_PostUserEvent
+ */
+typedef struct {
+    int code;
+    void* data;
+} LG_UserEvent;
+
+/**
+ * @brief Process output event
+ * 
+ * Everything the process wrote since the last event, stdout and stderr
+ * interleaved. The data is not NUL-terminated and is only valid during
+ * the callback.
+ */
+typedef struct {
+    LG_ProcessHandle process;
+    const char* data;
+    size_t size;
+} LG_ProcessOutputEvent;
+
+/**
+ * @brief Process exit event, the last event for a process
+ */
+typedef struct {
+    LG_ProcessHandle process;
+    int exit_code;  /* 128 + the signal number if killed by a signal on POSIX */
+} LG_ProcessExitEvent;
+
 /**
  * @brief Event structure
  */
@@ -201,6 +333,9 @@ typedef struct LG_Event {
         LG_KeyEvent key;
         LG_WindowResizeEvent window_resize;
         LG_WidgetClickedEvent widget_clicked;
+        LG_UserEvent user;
+        LG_ProcessOutputEvent process_output;
+        LG_ProcessExitEvent process_exit;
     } data;
 } LG_Event;
 
@@ -209,6 +344,185 @@ typedef struct LG_Event {
  */
 typedef void (*LG_EventCallback)(const LG_Event* event, void* user_data);
 
+/**
+ * @brief Supplies the text of one list row
+ * 
+ * Called only for rows that are about to be drawn. The text is cached
+ * until the row scrolls out of view or is invalidated.
+ * 
+ * @param list The list widget
+ * @param row The row index
+ * @param buffer Receives the row's text (already an empty string)
+ * @param buffer_size The size of buffer, including the terminator
+ * @param user_data The pointer passed to LG_SetListSource
+ */
+typedef void (*LG_ListRowCallback)(LG_WidgetHandle list, size_t row, char* buffer,
+                                   size_t buffer_size, void* user_data);
+
+/**
+ * @brief Draws one frame of an OpenGL canvas
+ * 
+ * Called once per frame by LG_Run with the canvas's context current.
+ * The buffers are swapped afterwards.
+ * 
+ * @param canvas The OpenGL canvas
+ * @param width The canvas width, for the viewport
+ * @param height The canvas height
+ * @param user_data The pointer passed to LG_SetCanvasRenderCallback
+ */
+typedef void (*LG_CanvasRenderCallback)(LG_WidgetHandle canvas, int width, int height,
+                                        void* user_data);
+
+/**
+ * @brief Selection value meaning no row is selected
+ */
+#define LG_LIST_NO_SELECTION ((size_t)-1)
+
+/**
+ * @brief Function run on the main thread by LG_PostToMainThread
+ */
+typedef void (*LG_MainThreadFunc)(void* user_data);
+
+/**
+ * @brief Handle of a timer added with LG_AddTimer
+ */
+typedef struct LG_Timer* LG_TimerHandle;
+
+/**
+ * @brief Called on the main thread each time a timer is due
+ * 
+ * @param timer The timer; LG_RemoveTimer may be called on it from here
+ * @param user_data The pointer passed to LG_AddTimer
+ */
+typedef void (*LG_TimerCallback)(LG_TimerHandle timer, void* user_data);
+
+/**
+ * @brief Handle of a value that widget text can be bound to
+ */
+typedef struct LG_Source* LG_SourceHandle;
+
+/**
+ * @brief Widget properties LG_Animate and LG_AnimateColor can move
+ */
+typedef enum {
+    LG_ANIMATE_X,
+    LG_ANIMATE_Y,
+    LG_ANIMATE_WIDTH,
+    LG_ANIMATE_HEIGHT,
+    LG_ANIMATE_BACKGROUND_COLOR,  /* LG_AnimateColor only */
+    LG_ANIMATE_TEXT_COLOR         /* LG_AnimateColor only */
+} LG_AnimateProperty;
+
+/**
+ * @brief Platform backends selectable with LG_InitializeBackend
+ */
+typedef enum {
+    LG_BACKEND_DEFAULT,  /* LIGHTGUI_BACKEND from the environment ("native" or "headless"), else native */
+    LG_BACKEND_NATIVE,   /* X11 on Linux, Win32 on Windows */
+    LG_BACKEND_HEADLESS  /* In-memory window surfaces and synthetic input */
+} LG_Backend;
+
+/**
+ * @brief Event loop modes used by LG_Run
+ */
+typedef enum {
+    LG_RUN_MODE_POLL,  /* Poll for events, sleeping briefly between iterations */
+    LG_RUN_MODE_WAIT   /* Block until input or a wakeup arrives (default) */
+} LG_RunMode;
+
+/**
+ * @brief Number of buckets in LG_Stats.latency_histogram
+ */
+#define LG_LATENCY_BUCKETS 12
+
+/**
+ * @brief Runtime counters returned by LG_GetStats
+ * 
+ * Counters accumulate from LG_Initialize or the last LG_ResetStats. Times
+ * are in microseconds. Latency covers the last 256 inputs and is only
+ * collected while enabled with LG_SetLatencyTracking.
+ */
+typedef struct {
+    uint64_t frames;  /* Frames rendered by LG_Run */
+    uint64_t last_frame_us;  /* Time spent rendering the latest frame */
+    uint64_t max_frame_us;  /* Longest frame so far */
+    uint64_t process_events_us;  /* Time spent reading platform events, excluding callbacks */
+    uint64_t callback_us;  /* Time spent in event callbacks and posted functions */
+    uint64_t render_us;  /* Time spent repainting windows */
+    uint64_t events[LG_EVENT_TYPE_COUNT];  /* Events delivered, by LG_EventType */
+    uint64_t pixels_presented;  /* Window and canvas pixels sent to the screen */
+    uint64_t widget_updates;  /* Widget property changes applied to the platform */
+    uint64_t pool_allocations;  /* Widgets and widget data taken from pools */
+    uint64_t heap_allocations;  /* Heap allocations made by the core */
+    size_t live_widgets;  /* Widgets currently alive in all windows */
+    size_t native_widgets;  /* Of those, widgets whose platform side has been created */
+    const char* raster_kernels;  /* Canvas kernels in use, e.g. "avx2" */
+    
+    /* Input-to-present latency over the rolling window */
+    size_t latency_samples;  /* Samples in the window */
+    uint32_t latency_histogram[LG_LATENCY_BUCKETS];  /* Below 1 ms, then [2^(i-1), 2^i) ms; the last bucket is open */
+    uint32_t latency_p50_us;
+    uint32_t latency_p99_us;
+    uint32_t latency_max_us;
+} LG_Stats;
+
+/**
+ * @brief Pacing of a replay started with LG_StartReplay
+ */
+typedef enum {
+    LG_REPLAY_REALTIME,  /* Each event at its recorded time */
+    LG_REPLAY_FAST       /* One event per loop iteration, without waiting */
+} LG_ReplaySpeed;
+
+/**
+ * @brief Results of a replay, passed to its LG_ReplayCallback
+ * 
+ * Latency runs from the dispatch of a replayed input until the flush that
+ * presents the repaint it caused, like LG_Stats latency, but covers every
+ * sample of the replay. Times are in microseconds.
+ */
+typedef struct {
+    size_t events;  /* Events dispatched */
+    size_t skipped_events;  /* Events whose window or widget does not exist, or resizes the backend cannot replay */
+    uint64_t duration_us;  /* From LG_StartReplay until the last event was rendered */
+    size_t latency_samples;
+    uint32_t latency_p50_us;
+    uint32_t latency_p90_us;
+    uint32_t latency_p99_us;
+    uint32_t latency_max_us;
+} LG_ReplayReport;
+
+/**
+ * @brief Called on the main thread once a replay has finished
+ * 
+ * @param report The results; only valid during the call
+ * @param user_data The pointer passed to LG_StartReplay
+ */
+typedef void (*LG_ReplayCallback)(const LG_ReplayReport* report, void* user_data);
+
+/**
+ * @brief Flags of an LG_WidgetDesc
+ */
+enum {
+    LG_WIDGET_DESC_HIDDEN     = 1 << 0,  /* Created invisible */
+    LG_WIDGET_DESC_DISABLED   = 1 << 1,  /* Created disabled */
+    LG_WIDGET_DESC_BG_COLOR   = 1 << 2,  /* Use bg_color instead of the type's default */
+    LG_WIDGET_DESC_TEXT_COLOR = 1 << 3   /* Use text_color instead of black */
+};
+
+/**
+ * @brief Description of one widget for LG_CreateWidgets
+ */
+typedef struct {
+    LG_WidgetType type;  /* Button, label, text field, canvas or list */
+    unsigned int flags;  /* LG_WIDGET_DESC_* */
+    LG_Rect rect;
+    const char* text;  /* Copied; NULL for none, ignored by canvases and lists */
+    int row_height;  /* Lists only */
+    LG_Color bg_color;
+    LG_Color text_color;
+} LG_WidgetDesc;
+
 /* ========================================================================= */
 /*                              API Functions                                */
 /* ========================================================================= */
@@ -217,11 +531,25 @@ typedef void (*LG_EventCallback)(const LG_Event* event, void* user_data);
  * @brief Initialize the LightGUI framework
  * 
  * This function must be called before any other LightGUI function.
+ * Same as LG_InitializeBackend(LG_BACKEND_DEFAULT).
  * 
  * @return true if initialization was successful, false otherwise
  */
 bool LG_Initialize(void);
 
+/**
+ * @brief Initialize the LightGUI framework with a specific backend
+ * 
+ * The headless backend needs no display: windows render into in-memory
+ * surfaces read with LG_GetWindowFrame, and input comes from
+ * LG_InjectEvent. It keeps no process-wide connection, so many
+ * processes can render side by side.
+ * 
+ * @param backend The backend to use
+ * @return true if initialization was successful, false otherwise
+ */
+bool LG_InitializeBackend(LG_Backend backend);
+
 /**
  * @brief Terminate the LightGUI framework
  * 
@@ -270,6 +598,20 @@ void LG_HideWindow(LG_WindowHandle window);
  */
 void LG_SetWindowTitle(LG_WindowHandle window, const char* title);
 
+/**
+ * @brief Enable or disable windowless widgets for a window
+ * 
+ * Buttons and labels created after this call have no native window of
+ * their own. They are drawn straight into the window's back buffer and
+ * hit-tested from their rectangles, which saves a native window per
+ * widget. Text fields always keep a native window so they stay editable.
+ * Existing widgets are not affected.
+ * 
+ * @param window The window
+ * @param enabled Whether new widgets should be windowless
+ */
+void LG_SetWindowlessWidgets(LG_WindowHandle window, bool enabled);
+
 /**
  * @brief Create a button widget
  * 
@@ -356,6 +698,21 @@ void LG_SetWidgetSize(LG_WidgetHandle widget, int width, int height);
  */
 void LG_SetWidgetVisible(LG_WidgetHandle widget, bool visible);
 
+/**
+ * @brief Free the platform side of widgets that have stayed hidden
+ * 
+ * Widgets only get native resources once they are visible and inside
+ * their window. This releases them again from buttons, labels and lists
+ * hidden for at least min_hidden_ms; they keep all their properties and
+ * are recreated when next shown. Text fields and canvases are kept, since
+ * their contents live on the platform side.
+ * 
+ * @param window The window whose widgets to release
+ * @param min_hidden_ms How long a widget must have been hidden
+ * @return The number of widgets released
+ */
+size_t LG_ReleaseHiddenWidgets(LG_WindowHandle window, uint32_t min_hidden_ms);
+
 /**
  * @brief Set a widget's enabled state
  * 
@@ -380,6 +737,92 @@ void LG_SetWidgetBackgroundColor(LG_WidgetHandle widget, LG_Color color);
  */
 void LG_SetWidgetTextColor(LG_WidgetHandle widget, LG_Color color);
 
+/**
+ * @brief Start batching widget property updates for a window
+ * 
+ * Until the matching LG_EndUpdate, the LG_SetWidget* functions only record
+ * which properties changed. LG_EndUpdate then applies the changed parts of
+ * every modified widget in one pass. Calls may be nested.
+ * 
+ * @param window The window
+ */
+void LG_BeginUpdate(LG_WindowHandle window);
+
+/**
+ * @brief Apply all widget updates batched since LG_BeginUpdate
+ * 
+ * @param window The window
+ */
+void LG_EndUpdate(LG_WindowHandle window);
+
+/**
+ * @brief Create a number that widget text can be bound to
+ * 
+ * @param value The initial value
+ * @return The source, or NULL on failure
+ */
+LG_SourceHandle LG_CreateNumberSource(double value);
+
+/**
+ * @brief Create a string that widget text can be bound to
+ * 
+ * @param value The initial value
+ * @return The source, or NULL on failure
+ */
+LG_SourceHandle LG_CreateStringSource(const char* value);
+
+/**
+ * @brief Destroy a source; bound widgets keep their last text
+ * 
+ * Sources still alive at LG_Terminate are destroyed then.
+ * 
+ * @param source The source
+ */
+void LG_DestroySource(LG_SourceHandle source);
+
+/**
+ * @brief Change the value of a number source
+ * 
+ * Only the value is stored. Bound widgets show the latest value once per
+ * frame, so any number of writes between frames cost one update, and
+ * text that comes out unchanged does not reach the platform at all.
+ * Call from the main thread.
+ * 
+ * @param source The source
+ * @param value The new value
+ */
+void LG_SetSourceNumber(LG_SourceHandle source, double value);
+
+/**
+ * @brief Change the value of a string source, like LG_SetSourceNumber
+ * 
+ * @param source The source
+ * @param value The new value, copied into the source's buffer
+ */
+void LG_SetSourceString(LG_SourceHandle source, const char* value);
+
+/**
+ * @brief Show a source's value as a widget's text
+ * 
+ * The format has exactly one conversion: a, e, f or g for number sources,
+ * s for string sources, with optional flags, width and precision, such as
+ * "%.1f C". A widget shows one source at a time, and binding it again
+ * replaces the old binding. Destroying the widget unbinds it.
+ * 
+ * @param widget The widget
+ * @param source The source
+ * @param format The format, or NULL for "%g" or "%s"
+ * @return true if the widget was bound, and now shows the current value
+ */
+bool LG_BindWidgetText(LG_WidgetHandle widget, LG_SourceHandle source, const char* format);
+
+/**
+ * @brief Stop a widget's text from following its source
+ * 
+ * @param widget The widget
+ */
+void LG_UnbindWidget(LG_WidgetHandle widget);
+
 /**
  * @brief Register an event callback for a window
  * 
@@ -399,15 +842,77 @@ void LG_SetWindowEventCallback(LG_WindowHandle window, LG_EventCallback callback
  */
 bool LG_ProcessEvents(void);
 
+/**
+ * @brief Send all buffered requests to the display
+ * 
+ * Drawing and window requests are buffered and sent once at the end of
+ * LG_ProcessEvents, LG_RenderWindow and each LG_Run iteration. Call this
+ * when requests must reach the display server earlier.
+ */
+void LG_Flush(void);
+
 /**
  * @brief Render a window
  * 
- * This function renders the window and all its widgets.
+ * This function repaints the parts of the window and its widgets that
+ * changed since the last render. It does nothing if nothing changed.
  * 
  * @param window The window to render
  */
 void LG_RenderWindow(LG_WindowHandle window);
 
+/**
+ * @brief Ask for a window to be repainted completely on the next frame
+ * 
+ * Widget changes already schedule the affected areas; this is for content
+ * the application draws itself. LG_Run renders windows with pending
+ * changes at most once per display refresh and skips the others.
+ * 
+ * @param window The window to repaint
+ */
+void LG_RequestRedraw(LG_WindowHandle window);
+
+/**
+ * @brief Set the frame rate LG_Run renders at when the display refresh
+ *        timing is unknown
+ * 
+ * Where the platform reports vertical blank timing (DWM on Windows),
+ * frames follow the display instead. The default is 60.
+ * 
+ * @param frames_per_second Frames per second, or 0 to render on every
+ *        loop iteration
+ */
+void LG_SetFrameRate(int frames_per_second);
+
+/**
+ * @brief Make LG_Run wait for the compositor after presenting each frame
+ * 
+ * Pacing follows the compositor exactly (DwmFlush on Windows), at the
+ * cost of not processing input during the wait. Platforms without a
+ * compositor to wait on ignore this. Off by default.
+ * 
+ * @param enabled Whether to wait
+ */
+void LG_SetWaitForVBlank(bool enabled);
+
+/* Most threads LG_SetRenderThreads starts */
+#define LG_MAX_RENDER_THREADS 16
+
+/**
+ * @brief Set how many threads rasterize damaged windows
+ * 
+ * With more than one thread, LG_Run draws the back buffers of the windows
+ * damaged in a frame in parallel, one window per thread, and then presents
+ * them on the main thread. Events and presentation stay on the main thread,
+ * and list row callbacks are still called there. The X11 backend draws
+ * through the display server and always renders on the main thread.
+ * 
+ * @param threads Threads including the main thread: 1 (the default) renders
+ *        on the main thread only, 0 uses one per processor
+ * @return false if the threads could not be started
+ */
+bool LG_SetRenderThreads(int threads);
+
 /**
  * @brief Run the main event loop
  * 
@@ -415,6 +920,254 @@ void LG_RenderWindow(LG_WindowHandle window);
  */
 void LG_Run(void);
 
+/**
+ * @brief Select how LG_Run waits between loop iterations
+ * 
+ * In LG_RUN_MODE_WAIT the loop blocks on the platform event source
+ * (the X11 connection or the Win32 message queue) and wakes as soon as
+ * input arrives or LG_PostWakeup is called. In LG_RUN_MODE_POLL it
+ * sleeps for a fixed 10 ms between iterations.
+ * 
+ * @param mode The run mode
+ * @param timeout_ms Maximum time to block in wait mode, or -1 to wait forever
+ */
+void LG_SetRunMode(LG_RunMode mode, int timeout_ms);
+
+/**
+ * @brief Wait for events and process them
+ * 
+ * Blocks until at least one event is available, LG_PostWakeup is called
+ * or the timeout expires, then processes all pending events.
+ * 
+ * @param timeout_ms Maximum time to wait in milliseconds, or -1 to wait forever
+ * @return true if the application should continue running, false if it should quit
+ */
+bool LG_WaitEvents(int timeout_ms);
+
+/**
+ * @brief Wake up the event loop
+ * 
+ * Causes a pending or future wait in LG_Run or LG_WaitEvents to return
+ * immediately. This function may be called from any thread.
+ */
+void LG_PostWakeup(void);
+
+/**
+ * @brief Run a function on the main thread
+ * 
+ * This function may be called from any thread and does not block. The
+ * event loop wakes up and runs everything posted since its last iteration
+ * in one batch, in posting order, from LG_Run, LG_ProcessEvents or
+ * LG_WaitEvents. Functions still queued at LG_Terminate are discarded.
+ * 
+ * @param func The function to run
+ * @param user_data Passed to func
+ * @return true if the function was queued
+ */
+bool LG_PostToMainThread(LG_MainThreadFunc func, void* user_data);
+
+/**
+ * @brief Send an LG_EVENT_USER event to a window from any thread
+ * 
+ * Delivered like LG_PostToMainThread functions. The event is dropped if
+ * the window has been destroyed by then.
+ * 
+ * @param window The window whose event callback receives the event
+ * @param code Application-defined event code
+ * @param data Application-defined data
+ * @return true if the event was queued
+ */
+bool LG_PostUserEvent(LG_WindowHandle window, int code, void* data);
+
+/**
+ * @brief Run a shell command without blocking the event loop
+ * 
+ * The command runs through /bin/sh -c, or cmd.exe /c on Windows, with
+ * stdin empty and stdout and stderr on one pipe. The event loop waits on
+ * that pipe along with its windows, and delivers whatever the command
+ * has written since the last iteration as one LG_EVENT_PROCESS_OUTPUT
+ * event, then LG_EVENT_PROCESS_EXIT once the output is closed and the
+ * command has exited. The handle is freed after the exit event. Up to 60
+ * processes can run at a time.
+ * 
+ * Destroying the window kills its processes without further events.
+ * 
+ * @param window The window whose event callback receives the events
+ * @param command The command line
+ * @return The process, or NULL if it could not be started
+ */
+LG_ProcessHandle LG_SpawnProcess(LG_WindowHandle window, const char* command);
+
+/**
+ * @brief Kill a process and everything it started
+ * 
+ * The exit event still follows, once the remaining output is delivered.
+ * 
+ * @param process The process
+ */
+void LG_KillProcess(LG_ProcessHandle process);
+
+/**
+ * @brief Call a function on the main thread at a fixed interval
+ * 
+ * The event loop sleeps until the earliest timer is due, so timers cost
+ * nothing between ticks. Callbacks run from LG_Run, LG_ProcessEvents and
+ * LG_WaitEvents after posted functions. A timer that falls more than an
+ * interval behind skips the missed ticks. Timers still running at
+ * LG_Terminate are freed.
+ * 
+ * @param interval_ms Milliseconds between calls; at least 1
+ * @param callback The function to call
+ * @param user_data Passed to callback
+ * @return The timer, or NULL on failure
+ */
+LG_TimerHandle LG_AddTimer(int interval_ms, LG_TimerCallback callback, void* user_data);
+
+/**
+ * @brief Stop and free a timer
+ * 
+ * @param timer The timer
+ */
+void LG_RemoveTimer(LG_TimerHandle timer);
+
+/**
+ * @brief Move a widget's position or size to a target over time
+ * 
+ * LG_Run advances animations once per frame, easing in and out, and
+ * repaints only the widgets they change. Starting another animation of
+ * the same property replaces the running one, continuing from the current
+ * value. Destroying the widget stops its animations.
+ * 
+ * @param widget The widget
+ * @param property LG_ANIMATE_X, LG_ANIMATE_Y, LG_ANIMATE_WIDTH or LG_ANIMATE_HEIGHT
+ * @param target The final value in pixels
+ * @param duration_ms The duration; 0 or less sets the value at once
+ * @return true if the animation was started
+ */
+bool LG_Animate(LG_WidgetHandle widget, LG_AnimateProperty property, int target, int duration_ms);
+
+/**
+ * @brief Fade a widget's background or text color to a target, like LG_Animate
+ * 
+ * @param widget The widget
+ * @param property LG_ANIMATE_BACKGROUND_COLOR or LG_ANIMATE_TEXT_COLOR
+ * @param target The final color
+ * @param duration_ms The duration; 0 or less sets the color at once
+ * @return true if the animation was started
+ */
+bool LG_AnimateColor(LG_WidgetHandle widget, LG_AnimateProperty property, LG_Color target,
+                     int duration_ms);
+
+/**
+ * @brief Stop the main event loop
+ * 
+ * LG_Run returns after finishing its current iteration.
+ */
+void LG_QuitEventLoop(void);
+
+/**
+ * @brief Get a snapshot of the runtime counters
+ * 
+ * Call from the main thread.
+ * 
+ * @param stats Receives the counters
+ */
+void LG_GetStats(LG_Stats* stats);
+
+/**
+ * @brief Reset the runtime counters and latency samples to zero
+ */
+void LG_ResetStats(void);
+
+/**
+ * @brief Enable or disable input-to-present latency tracking (off by default)
+ * 
+ * Latency runs from when the first input event after a present is
+ * delivered to the application until the flush that presents the next
+ * repaint, so it includes the callbacks and rendering that input caused.
+ * 
+ * @param enabled true to collect latency samples
+ */
+void LG_SetLatencyTracking(bool enabled);
+
+/**
+ * @brief Queue a synthetic input event for a window (headless backend only)
+ * 
+ * The event is delivered by the next LG_ProcessEvents or LG_Run
+ * iteration and routed like platform input: motion is coalesced per the
+ * window's motion mode, a left press on a widget also sends
+ * LG_EVENT_WIDGET_CLICKED, and LG_EVENT_WINDOW_RESIZE resizes the surface.
+ * 
+ * @param window The window receiving the event
+ * @param event The event; its window field is ignored
+ * @return true if the event was queued
+ */
+bool LG_InjectEvent(LG_WindowHandle window, const LG_Event* event);
+
+/**
+ * @brief Get the rendered pixels of a window (headless backend only)
+ * 
+ * Renders pending damage first. The pixels are 0xAARRGGBB and stay valid
+ * until the window is resized, destroyed or rendered again.
+ * 
+ * @param window The window
+ * @param frame Receives the window's surface
+ * @return true on success
+ */
+bool LG_GetWindowFrame(LG_WindowHandle window, LG_CanvasBuffer* frame);
+
+/**
+ * @brief Write the rendered pixels of a window to a binary PPM file
+ * 
+ * @param window The window (headless backend only)
+ * @param path The file to write
+ * @return true on success
+ */
+bool LG_SaveWindowFrame(LG_WindowHandle window, const char* path);
+
+/**
+ * @brief Record the input delivered to event callbacks to a file
+ * 
+ * Mouse, key, resize, close and widget click events are written with
+ * their time as they reach the callbacks, after motion coalescing.
+ * Windows and widgets are stored by their index among the open ones, so a
+ * recording replays into an application that creates and destroys the
+ * same windows and widgets in the same order.
+ * 
+ * @param path The file to write
+ * @return true if recording started
+ */
+bool LG_StartRecording(const char* path);
+
+/**
+ * @brief Stop recording and close the file; LG_Terminate also does this
+ */
+void LG_StopRecording(void);
+
+/**
+ * @brief Replay a file written by LG_StartRecording through the event loop
+ * 
+ * LG_Run, LG_ProcessEvents and LG_WaitEvents dispatch the recorded events
+ * to the same windows and widgets as in the recording, so callbacks,
+ * layout and rendering run on whichever backend is in use. Resizes are
+ * only replayed by the headless backend, which can resize its surfaces.
+ * With LG_REPLAY_FAST, events are only batched into frames by the frame
+ * rate; LG_SetFrameRate(0) renders after every event.
+ * 
+ * @param path The recording
+ * @param speed How the events are paced
+ * @param callback Called with the results once the last event is rendered, or NULL
+ * @param user_data Passed to the callback
+ * @return true if the replay started
+ */
+bool LG_StartReplay(const char* path, LG_ReplaySpeed speed, LG_ReplayCallback callback,
+                    void* user_data);
+
+/**
+ * @brief Abandon a replay without calling its callback
+ */
+void LG_StopReplay(void);
+
 /**
  * @brief Create a predefined color
  * 
@@ -463,6 +1216,21 @@ void LG_DestroyWidget(LG_WidgetHandle widget);
  */
 void LG_SetEventCallback(LG_WindowHandle window, LG_EventCallback callback, void* user_data);
 
+/**
+ * @brief Select how pointer motion is reported for a window
+ * 
+ * High-rate mice can produce thousands of motion samples per second. In
+ * the coalescing modes only the latest position is dispatched, once per
+ * event loop iteration (or earlier, just before any other event for the
+ * window, so ordering is kept), with the delta accumulated across the
+ * skipped samples. LG_MOTION_COALESCE_HISTORY also attaches the skipped
+ * samples, for apps such as paint brushes that need every point.
+ * 
+ * @param window The window
+ * @param mode The motion mode
+ */
+void LG_SetMotionMode(LG_WindowHandle window, LG_MotionMode mode);
+
 /**
  * @brief Create a canvas widget for custom rendering
  * 
@@ -475,6 +1243,151 @@ void LG_SetEventCallback(LG_WindowHandle window, LG_EventCallback callback, void
  */
 LG_WidgetHandle LG_CreateCanvas(LG_WindowHandle window, int x, int y, int width, int height);
 
+/**
+ * @brief Create a canvas drawn with OpenGL
+ * 
+ * The canvas's native window gets its own double-buffered context (GLX on
+ * X11, WGL on Windows) instead of a pixel buffer, so LG_GetCanvasBuffer
+ * and the drawing primitives do not apply. Draw either from a callback
+ * set with LG_SetCanvasRenderCallback, or directly between
+ * LG_CanvasMakeCurrent and LG_CanvasSwapBuffers. Pointer input reaches
+ * the window as with other canvases.
+ * 
+ * @param window The window to add the canvas to
+ * @param x The x position
+ * @param y The y position
+ * @param width The width
+ * @param height The height
+ * @return The canvas widget handle, or NULL if OpenGL is unavailable
+ */
+LG_WidgetHandle LG_CreateGLCanvas(LG_WindowHandle window, int x, int y, int width, int height);
+
+/**
+ * @brief Create a virtual list widget
+ * 
+ * A list draws only the rows that are visible, fetching their text from
+ * the callback set with LG_SetListSource, so its cost does not depend on
+ * the number of rows. Clicking a row selects it and sends
+ * LG_EVENT_WIDGET_CLICKED; the mouse wheel scrolls.
+ * 
+ * @param window The parent window
+ * @param x The x position of the list
+ * @param y The y position of the list
+ * @param width The width of the list
+ * @param height The height of the list
+ * @param row_height The height of each row in pixels
+ * @return A handle to the list widget, or NULL on failure
+ */
+LG_WidgetHandle LG_CreateList(LG_WindowHandle window, int x, int y, int width, int height,
+                              int row_height);
+
+/**
+ * @brief Create many widgets at once
+ * 
+ * Equivalent to the LG_Create* calls in description order, but storage
+ * for all widgets is allocated up front and the display is flushed once.
+ * Either all widgets are created or none are.
+ * 
+ * @param window The parent window
+ * @param descs The widgets to create
+ * @param count The number of descriptions
+ * @param out Receives count handles in description order; may be NULL
+ * @return true on success
+ */
+bool LG_CreateWidgets(LG_WindowHandle window, const LG_WidgetDesc* descs, size_t count,
+                      LG_WidgetHandle* out);
+
+/**
+ * @brief Create the widgets of a binary layout held in memory
+ * 
+ * The layout is read in place, so it can point into a mapped file. See
+ * "Layouts" in the README for the format, or write one with LG_SaveLayout.
+ * 
+ * @param window The parent window
+ * @param layout The layout data
+ * @param size The size of the layout data in bytes
+ * @param out Receives the first out_count handles in layout order; may be NULL
+ * @param out_count The number of handles out can hold
+ * @return The number of widgets created, or 0 if the layout is invalid
+ *         or creation failed
+ */
+size_t LG_CreateWidgetsFromLayout(LG_WindowHandle window, const void* layout, size_t size,
+                                  LG_WidgetHandle* out, size_t out_count);
+
+/**
+ * @brief Map a layout file and create its widgets
+ * 
+ * @param window The parent window
+ * @param path The layout file
+ * @param out Receives the first out_count handles in layout order; may be NULL
+ * @param out_count The number of handles out can hold
+ * @return The number of widgets created, or 0 on failure
+ */
+size_t LG_LoadLayout(LG_WindowHandle window, const char* path, LG_WidgetHandle* out,
+                     size_t out_count);
+
+/**
+ * @brief Write widget descriptions to a layout file
+ * 
+ * @param path The file to write
+ * @param descs The widgets
+ * @param count The number of descriptions
+ * @return true on success
+ */
+bool LG_SaveLayout(const char* path, const LG_WidgetDesc* descs, size_t count);
+
+/**
+ * @brief Set where a list's rows come from
+ * 
+ * Scrolls back to the top and clears the selection.
+ * 
+ * @param list The list widget
+ * @param row_count The number of rows
+ * @param callback Supplies the text of a row
+ * @param user_data Passed to callback
+ */
+void LG_SetListSource(LG_WidgetHandle list, size_t row_count,
+                      LG_ListRowCallback callback, void* user_data);
+
+/**
+ * @brief Change the number of rows, e.g. after appending to a log
+ * 
+ * Rows before the old or new count, whichever is smaller, keep their
+ * cached text. Only the rows that change on screen are redrawn.
+ */
+void LG_SetListRowCount(LG_WidgetHandle list, size_t row_count);
+
+/**
+ * @brief Fetch and redraw rows whose contents changed
+ * 
+ * @param list The list widget
+ * @param first_row The first changed row
+ * @param count The number of changed rows
+ */
+void LG_InvalidateListRows(LG_WidgetHandle list, size_t first_row, size_t count);
+
+/**
+ * @brief Scroll a list so that a row is at the top
+ * 
+ * The row is clamped so the list stays filled where possible.
+ */
+void LG_ScrollList(LG_WidgetHandle list, size_t top_row);
+
+/**
+ * @brief Get the row at the top of a list
+ */
+size_t LG_GetListTopRow(LG_WidgetHandle list);
+
+/**
+ * @brief Select a row, or clear the selection with LG_LIST_NO_SELECTION
+ */
+void LG_SetListSelection(LG_WidgetHandle list, size_t row);
+
+/**
+ * @brief Get the selected row, or LG_LIST_NO_SELECTION
+ */
+size_t LG_GetListSelection(LG_WidgetHandle list);
+
 /**
  * @brief Get the rendering context for a canvas
  * 
@@ -489,6 +1402,21 @@ LG_WidgetHandle LG_CreateCanvas(LG_WindowHandle window, int x, int y, int width,
  */
 void* LG_GetCanvasContext(LG_WidgetHandle canvas);
 
+/**
+ * @brief Get the pixel buffer of a canvas
+ * 
+ * The buffer is shared with the display server where possible (MIT-SHM on
+ * X11, a DIB section on Windows), so LG_UpdateCanvas presents it without
+ * an extra copy. Call this before drawing each frame: it waits until the
+ * previous present has finished reading the pixels. The buffer is
+ * reallocated when the canvas is resized.
+ * 
+ * @param canvas The canvas widget
+ * @param buffer Receives the pixel pointer, size and stride
+ * @return true on success, false if the widget is not a canvas
+ */
+bool LG_GetCanvasBuffer(LG_WidgetHandle canvas, LG_CanvasBuffer* buffer);
+
 /**
  * @brief Notify the framework that the canvas has been updated
  * 
@@ -498,6 +1426,159 @@ void* LG_GetCanvasContext(LG_WidgetHandle canvas);
  */
 void LG_UpdateCanvas(LG_WidgetHandle canvas);
 
+/**
+ * @brief Present part of a canvas
+ * 
+ * Like LG_UpdateCanvas, but only the given area (in canvas coordinates)
+ * is sent to the display.
+ * 
+ * @param canvas The canvas widget
+ * @param rect The area that changed
+ */
+void LG_UpdateCanvasRect(LG_WidgetHandle canvas, LG_Rect rect);
+
+/**
+ * @brief Make an OpenGL canvas's context current on the calling thread
+ * 
+ * A new canvas's swap interval takes effect here.
+ * 
+ * @param canvas The OpenGL canvas
+ * @return true on success
+ */
+bool LG_CanvasMakeCurrent(LG_WidgetHandle canvas);
+
+/**
+ * @brief Show what was drawn into an OpenGL canvas
+ * 
+ * With a swap interval of 1 or more this waits for the display's
+ * vertical blank, so frames neither tear nor outrun the display.
+ * 
+ * @param canvas The OpenGL canvas
+ */
+void LG_CanvasSwapBuffers(LG_WidgetHandle canvas);
+
+/**
+ * @brief Set how many vertical blanks a buffer swap waits for
+ * 
+ * 1 (the default) syncs to the display, 0 swaps immediately. Applied the
+ * next time the canvas is made current. With several canvases animating,
+ * sync just one of them, or each swap waits for a separate blank.
+ * 
+ * @param canvas The OpenGL canvas
+ * @param interval The swap interval
+ * @return true if the canvas is an OpenGL canvas
+ */
+bool LG_SetCanvasSwapInterval(LG_WidgetHandle canvas, int interval);
+
+/**
+ * @brief Have LG_Run render an OpenGL canvas every frame
+ * 
+ * While a shown canvas has a callback, LG_Run renders frames continuously
+ * at the frame rate, calling it with the context current and swapping the
+ * buffers after it returns.
+ * 
+ * @param canvas The OpenGL canvas
+ * @param callback The callback, or NULL to stop rendering
+ * @param user_data Passed to the callback
+ */
+void LG_SetCanvasRenderCallback(LG_WidgetHandle canvas, LG_CanvasRenderCallback callback,
+                                void* user_data);
+
+/* ========================================================================= */
+/*                          Canvas Drawing Primitives                        */
+/* ========================================================================= */
+
+/*
+ * These draw into the canvas's pixel buffer with vectorized span kernels
+ * (SSE2/AVX2/NEON, chosen at runtime, with a scalar fallback). Colors with
+ * an alpha below 255 are blended over the existing pixels. Call
+ * LG_UpdateCanvas or LG_UpdateCanvasRect afterwards to present.
+ */
+
+/**
+ * @brief Set every pixel of a canvas to a color, without blending
+ * 
+ * @param canvas The canvas widget
+ * @param color The new color
+ */
+void LG_CanvasClear(LG_WidgetHandle canvas, LG_Color color);
+
+/**
+ * @brief Fill a rectangle on a canvas
+ * 
+ * @param canvas The canvas widget
+ * @param rect The rectangle, in canvas coordinates
+ * @param color The fill color
+ */
+void LG_CanvasFillRect(LG_WidgetHandle canvas, LG_Rect rect, LG_Color color);
+
+/**
+ * @brief Draw an anti-aliased line with round caps on a canvas
+ * 
+ * @param canvas The canvas widget
+ * @param x1 The x coordinate of the start point
+ * @param y1 The y coordinate of the start point
+ * @param x2 The x coordinate of the end point
+ * @param y2 The y coordinate of the end point
+ * @param thickness The line width in pixels
+ * @param color The line color
+ */
+void LG_CanvasDrawLine(LG_WidgetHandle canvas, int x1, int y1, int x2, int y2,
+                       float thickness, LG_Color color);
+
+/**
+ * @brief Draw an anti-aliased circle on a canvas
+ * 
+ * @param canvas The canvas widget
+ * @param cx The x coordinate of the center
+ * @param cy The y coordinate of the center
+ * @param radius The radius in pixels
+ * @param color The circle color
+ * @param filled true for a disc, false for a 1-pixel outline
+ */
+void LG_CanvasDrawCircle(LG_WidgetHandle canvas, int cx, int cy, int radius,
+                         LG_Color color, bool filled);
+
+/**
+ * @brief Blend a pixel buffer onto a canvas
+ * 
+ * Each source pixel is blended using its own alpha, scaled by opacity.
+ * 
+ * @param canvas The canvas widget
+ * @param x The x position of the source's top-left corner
+ * @param y The y position of the source's top-left corner
+ * @param source The pixels to draw
+ * @param opacity Overall opacity (0-255)
+ */
+void LG_CanvasBlit(LG_WidgetHandle canvas, int x, int y, const LG_CanvasBuffer* source,
+                   uint8_t opacity);
+
+/**
+ * @brief Draw a line of text onto a canvas
+ * 
+ * Glyphs come from an atlas of the default font that is rasterized once,
+ * so drawing text does not involve the display server. Characters outside
+ * printable ASCII are drawn as '?'.
+ * 
+ * @param canvas The canvas widget
+ * @param x The x position of the text's top-left corner
+ * @param y The y position of the text's top-left corner
+ * @param text The text to draw
+ * @param color The text color
+ * @return The width of the text in pixels
+ */
+int LG_CanvasDrawText(LG_WidgetHandle canvas, int x, int y, const char* text, LG_Color color);
+
+/**
+ * @brief Get the size of a line of text as drawn by LG_CanvasDrawText
+ * 
+ * @param text The text to measure
+ * @param width Receives the width in pixels (may be NULL)
+ * @param height Receives the line height in pixels (may be NULL)
+ * @return true on success, false if the font is unavailable
+ */
+bool LG_CanvasMeasureText(const char* text, int* width, int* height);
+
 /**
  * @brief Check if two colors are equal
  * 
@@ -0,0 +1,973 @@
+/**
+ * @file headless.c
+ * @brief Headless platform implementation rendering into in-memory surfaces
+ *
+ * Every window is a 0xAARRGGBB pixel buffer and every widget, native or
+ * windowless, is drawn into it with the canvas raster kernels. Input comes
+ * from LG_InjectEvent. Nothing is shared with a display server and the
+ * only process-wide state is the wakeup signal, so any number of
+ * processes can render in parallel.
+ */
+
+#include "../src/lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/* ========================================================================= */
+/*                        Platform-Specific Structures                       */
+/* ========================================================================= */
+
+/**
+ * @brief Headless window data
+ */
+typedef struct {
+    uint32_t* pixels;  // stride * rows; the top-left width * height is the window
+    int width;
+    int height;
+    int stride;
+    int rows;
+    LG_Event* queue;  // Ring of injected events
+    size_t queue_head;
+    size_t queue_count;
+    size_t queue_capacity;
+} WindowData;
+
+/**
+ * @brief Headless widget data
+ */
+typedef struct {
+    uint32_t* canvas;  // Pixels of canvas widgets
+    int canvas_width;
+    int canvas_height;
+} WidgetData;
+
+/* ========================================================================= */
+/*                        Global Variables and Constants                     */
+/* ========================================================================= */
+
+#define BACKGROUND_PIXEL 0xFFFFFFFFu  // Opaque white, like the native window backgrounds
+
+#ifdef _WIN32
+static SRWLOCK g_wake_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE g_wake_cond = CONDITION_VARIABLE_INIT;
+static HANDLE g_wake_event = NULL;  // Also set by HeadlessWakeup, for waits on handles
+#else
+static pthread_mutex_t g_wake_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_wake_cond;
+static int g_wake_pipe[2] = {-1, -1};  // Also written by HeadlessWakeup, for waits on handles
+#endif
+static bool g_woken = false;  // Set by HeadlessWakeup, cleared by the next wait
+
+/* ========================================================================= */
+/*                        Built-in Font                                      */
+/* ========================================================================= */
+
+/*
+ * Printable ASCII rendered from DejaVu Sans Mono (Bitstream Vera license)
+ * at 12 pixels, one byte per row with the most significant bit leftmost.
+ * Pen at bit 0, baseline after row FONT_ASCENT - 1.
+ */
+#define FONT_ASCENT 10
+#define FONT_DESCENT 3
+#define FONT_HEIGHT (FONT_ASCENT + FONT_DESCENT)
+#define FONT_ADVANCE 7
+#define FONT_CELL_WIDTH 8
+
+static const uint8_t g_font_rows[LG_GLYPH_COUNT][FONT_HEIGHT] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  /* space */
+    {0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00},  /* ! */
+    {0x00, 0x28, 0x28, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  /* " */
+    {0x00, 0x00, 0x14, 0x24, 0x7E, 0x28, 0x28, 0xFC, 0x48, 0x50, 0x00, 0x00, 0x00},  /* # */
+    {0x00, 0x10, 0x38, 0x54, 0x50, 0x70, 0x1C, 0x14, 0x54, 0x38, 0x10, 0x10, 0x00},  /* $ */
+    {0x00, 0x60, 0x90, 0x90, 0x64, 0x18, 0x6C, 0x12, 0x12, 0x0C, 0x00, 0x00, 0x00},  /* % */
+    {0x00, 0x1C, 0x20, 0x20, 0x30, 0x30, 0x4A, 0x4E, 0x64, 0x3A, 0x00, 0x00, 0x00},  /* & */
+    {0x00, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  /* ' */
+    {0x0C, 0x08, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x08, 0x08, 0x0C, 0x00, 0x00},  /* ( */
+    {0x30, 0x10, 0x10, 0x08, 0x08, 0x08, 0x08, 0x08, 0x10, 0x10, 0x30, 0x00, 0x00},  /* ) */
+    {0x00, 0x10, 0x54, 0x38, 0x38, 0x54, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  /* * */
+    {0x00, 0x00, 0x00, 0x10, 0x10, 0x10, 0xFE, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00},  /* + */
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x20, 0x00, 0x00},  /* , */
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  /* - */
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00},  /* . */
+    {0x00, 0x02, 0x04, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x20, 0x40, 0x00, 0x00},  /* / */
+    {0x00, 0x3C, 0x24, 0x42, 0x42, 0x4A, 0x42, 0x42, 0x24, 0x3C, 0x00, 0x00, 0x00},  /* 0 */
+    {0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00},  /* 1 */
+    {0x00, 0x3C, 0x42, 0x02, 0x02, 0x04, 0x08, 0x10, 0x20, 0x7E, 0x00, 0x00, 0x00},  /* 2 */
+    {0x00, 0x3C, 0x42, 0x02, 0x02, 0x1C, 0x02, 0x02, 0x42, 0x3C, 0x00, 0x00, 0x00},  /* 3 */
+    {0x00, 0x0C, 0x0C, 0x14, 0x34, 0x24, 0x44, 0x7E, 0x04, 0x04, 0x00, 0x00, 0x00},  /* 4 */
+    {0x00, 0x7C, 0x40, 0x40, 0x7C, 0x06, 0x02, 0x02, 0x46, 0x3C, 0x00, 0x00, 0x00},  /* 5 */
+    {0x00, 0x1C, 0x22, 0x40, 0x5C, 0x66, 0x42, 0x42, 0x26, 0x3C, 0x00, 0x00, 0x00},  /* 6 */
+    {0x00, 0x7E, 0x06, 0x04, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00, 0x00, 0x00},  /* 7 */
+    {0x00, 0x3C, 0x42, 0x42, 0x42, 0x3C, 0x42, 0x42, 0x42, 0x3C, 0x00, 0x00, 0x00},  /* 8 */
+    {0x00, 0x3C, 0x64, 0x42, 0x42, 0x46, 0x3A, 0x02, 0x44, 0x38, 0x00, 0x00, 0x00},  /* 9 */
+    {0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00},  /* : */
+    {0x00, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0x10, 0x10, 0x20, 0x00, 0x00},  /* ; */
+    {0x00, 0x00, 0x00, 0x02, 0x1C, 0x60, 0x60, 0x1C, 0x02, 0x00, 0x00, 0x00, 0x00},  /* < */
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00, 0x00},  /* = */
+    {0x00, 0x00, 0x00, 0x40, 0x38, 0x06, 0x06, 0x38, 0x40, 0x00, 0x00, 0x00, 0x00},  /* > */
+    {0x00, 0x1C, 0x22, 0x02, 0x0C, 0x18, 0x10, 0x00, 0x10, 0x10, 0x00, 0x00, 0x00},  /* ? */
+    {0x00, 0x00, 0x1C, 0x26, 0x42, 0x4E, 0x52, 0x52, 0x4E, 0x60, 0x20, 0x1C, 0x00},  /* @ */
+    {0x00, 0x18, 0x18, 0x18, 0x24, 0x24, 0x24, 0x3C, 0x42, 0x42, 0x00, 0x00, 0x00},  /* A */
+    {0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x00, 0x00, 0x00},  /* B */
+    {0x00, 0x1C, 0x22, 0x40, 0x40, 0x40, 0x40, 0x40, 0x22, 0x1C, 0x00, 0x00, 0x00},  /* C */
+    {0x00, 0x78, 0x44, 0x42, 0x42, 0x42, 0x42, 0x42, 0x44, 0x78, 0x00, 0x00, 0x00},  /* D */
+    {0x00, 0x7E, 0x40, 0x40, 0x40, 0x7E, 0x40, 0x40, 0x40, 0x7E, 0x00, 0x00, 0x00},  /* E */
+    {0x00, 0x7E, 0x40, 0x40, 0x40, 0x7E, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00},  /* F */
+    {0x00, 0x1C, 0x22, 0x40, 0x40, 0x46, 0x42, 0x42, 0x22, 0x1C, 0x00, 0x00, 0x00},  /* G */
+    {0x00, 0x42, 0x42, 0x42, 0x42, 0x7E, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00},  /* H */
+    {0x00, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00},  /* I */
+    {0x00, 0x1C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x44, 0x38, 0x00, 0x00, 0x00},  /* J */
+    {0x00, 0x42, 0x44, 0x48, 0x50, 0x70, 0x48, 0x4C, 0x44, 0x42, 0x00, 0x00, 0x00},  /* K */
+    {0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7E, 0x00, 0x00, 0x00},  /* L */
+    {0x00, 0x42, 0x66, 0x66, 0x5A, 0x5A, 0x5A, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00},  /* M */
+    {0x00, 0x62, 0x62, 0x52, 0x52, 0x5A, 0x4A, 0x4A, 0x46, 0x46, 0x00, 0x00, 0x00},  /* N */
+    {0x00, 0x3C, 0x24, 0x42, 0x42, 0x42, 0x42, 0x42, 0x24, 0x3C, 0x00, 0x00, 0x00},  /* O */
+    {0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00},  /* P */
+    {0x00, 0x3C, 0x24, 0x42, 0x42, 0x42, 0x42, 0x42, 0x26, 0x3C, 0x04, 0x04, 0x00},  /* Q */
+    {0x00, 0x7C, 0x42, 0x42, 0x42, 0x7C, 0x44, 0x42, 0x42, 0x41, 0x00, 0x00, 0x00},  /* R */
+    {0x00, 0x3C, 0x42, 0x40, 0x60, 0x3C, 0x02, 0x02, 0x42, 0x3C, 0x00, 0x00, 0x00},  /* S */
+    {0x00, 0xFE, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00},  /* T */
+    {0x00, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3C, 0x00, 0x00, 0x00},  /* U */
+    {0x00, 0x42, 0x42, 0x24, 0x24, 0x24, 0x24, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00},  /* V */
+    {0x00, 0x82, 0x92, 0x92, 0xAA, 0xAA, 0xAA, 0x6C, 0x44, 0x44, 0x00, 0x00, 0x00},  /* W */
+    {0x00, 0x42, 0x24, 0x24, 0x18, 0x18, 0x18, 0x24, 0x24, 0x42, 0x00, 0x00, 0x00},  /* X */
+    {0x00, 0x82, 0x44, 0x28, 0x28, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00},  /* Y */
+    {0x00, 0x7E, 0x06, 0x04, 0x08, 0x18, 0x10, 0x20, 0x60, 0x7E, 0x00, 0x00, 0x00},  /* Z */
+    {0x18, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x18, 0x00, 0x00},  /* [ */
+    {0x00, 0x40, 0x20, 0x20, 0x10, 0x10, 0x08, 0x08, 0x04, 0x04, 0x02, 0x00, 0x00},  /* backslash */
+    {0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x30, 0x00, 0x00},  /* ] */
+    {0x00, 0x30, 0x48, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  /* ^ */
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFE},  /* _ */
+    {0x10, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  /* ` */
+    {0x00, 0x00, 0x00, 0x38, 0x44, 0x04, 0x3C, 0x44, 0x44, 0x3C, 0x00, 0x00, 0x00},  /* a */
+    {0x40, 0x40, 0x40, 0x78, 0x44, 0x44, 0x44, 0x44, 0x44, 0x78, 0x00, 0x00, 0x00},  /* b */
+    {0x00, 0x00, 0x00, 0x38, 0x64, 0x40, 0x40, 0x40, 0x60, 0x3C, 0x00, 0x00, 0x00},  /* c */
+    {0x04, 0x04, 0x04, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x00, 0x00, 0x00},  /* d */
+    {0x00, 0x00, 0x00, 0x38, 0x64, 0x44, 0x7C, 0x40, 0x44, 0x38, 0x00, 0x00, 0x00},  /* e */
+    {0x0C, 0x10, 0x10, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00},  /* f */
+    {0x00, 0x00, 0x00, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x04, 0x24, 0x18},  /* g */
+    {0x40, 0x40, 0x40, 0x58, 0x64, 0x44, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00, 0x00},  /* h */
+    {0x10, 0x00, 0x00, 0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7C, 0x00, 0x00, 0x00},  /* i */
+    {0x08, 0x00, 0x00, 0x38, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x30},  /* j */
+    {0x40, 0x40, 0x40, 0x44, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x00, 0x00, 0x00},  /* k */
+    {0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x0C, 0x00, 0x00, 0x00},  /* l */
+    {0x00, 0x00, 0x00, 0x7C, 0x54, 0x54, 0x54, 0x54, 0x54, 0x54, 0x00, 0x00, 0x00},  /* m */
+    {0x00, 0x00, 0x00, 0x58, 0x64, 0x44, 0x44, 0x44, 0x44, 0x44, 0x00, 0x00, 0x00},  /* n */
+    {0x00, 0x00, 0x00, 0x38, 0x44, 0x44, 0x44, 0x44, 0x44, 0x38, 0x00, 0x00, 0x00},  /* o */
+    {0x00, 0x00, 0x00, 0x78, 0x44, 0x44, 0x44, 0x44, 0x44, 0x78, 0x40, 0x40, 0x40},  /* p */
+    {0x00, 0x00, 0x00, 0x3C, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x04, 0x04, 0x04},  /* q */
+    {0x00, 0x00, 0x00, 0x3C, 0x32, 0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00},  /* r */
+    {0x00, 0x00, 0x00, 0x38, 0x44, 0x40, 0x38, 0x04, 0x44, 0x38, 0x00, 0x00, 0x00},  /* s */
+    {0x00, 0x10, 0x10, 0x7C, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1C, 0x00, 0x00, 0x00},  /* t */
+    {0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3C, 0x00, 0x00, 0x00},  /* u */
+    {0x00, 0x00, 0x00, 0x44, 0x44, 0x28, 0x28, 0x28, 0x10, 0x10, 0x00, 0x00, 0x00},  /* v */
+    {0x00, 0x00, 0x00, 0x82, 0x82, 0x54, 0x54, 0x6C, 0x28, 0x28, 0x00, 0x00, 0x00},  /* w */
+    {0x00, 0x00, 0x00, 0x44, 0x28, 0x28, 0x10, 0x28, 0x28, 0x44, 0x00, 0x00, 0x00},  /* x */
+    {0x00, 0x00, 0x00, 0x44, 0x44, 0x28, 0x28, 0x28, 0x30, 0x10, 0x10, 0x20, 0x60},  /* y */
+    {0x00, 0x00, 0x00, 0x7C, 0x04, 0x08, 0x10, 0x20, 0x40, 0x7C, 0x00, 0x00, 0x00},  /* z */
+    {0x1C, 0x10, 0x10, 0x10, 0x10, 0x60, 0x10, 0x10, 0x10, 0x10, 0x1C, 0x00, 0x00},  /* { */
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00},  /* | */
+    {0x70, 0x10, 0x10, 0x10, 0x10, 0x0C, 0x10, 0x10, 0x10, 0x10, 0x70, 0x00, 0x00},  /* } */
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x70, 0x0E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  /* ~ */
+};
+
+/* ========================================================================= */
+/*                        Helper Functions                                   */
+/* ========================================================================= */
+
+/**
+ * @brief (Re)allocate a window's surface and fill it with the background
+ */
+static bool ResizeSurface(WindowData* data, int width, int height) {
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+
+    int stride = width;
+    int rows = height;
+    if (BackBufferSize(data->stride, data->rows, &stride, &rows)) {
+        size_t count = (size_t)stride * (size_t)rows;
+        uint32_t* pixels = (uint32_t*)malloc(count * sizeof(uint32_t));
+        if (!pixels) {
+            fprintf(stderr, "LightGUI: Failed to allocate window surface\n");
+            return false;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            pixels[i] = BACKGROUND_PIXEL;
+        }
+
+        free(data->pixels);
+        data->pixels = pixels;
+        data->stride = stride;
+        data->rows = rows;
+    }
+
+    data->width = width;
+    data->height = height;
+    return true;
+}
+
+/**
+ * @brief Reallocate a canvas's pixels to its widget size, cleared to white
+ */
+static bool ResizeCanvas(LG_WidgetHandle widget) {
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    int width = widget->rect.width > 0 ? widget->rect.width : 1;
+    int height = widget->rect.height > 0 ? widget->rect.height : 1;
+    if (data->canvas && data->canvas_width == width && data->canvas_height == height) {
+        return true;
+    }
+
+    uint32_t* pixels = (uint32_t*)malloc((size_t)width * (size_t)height * sizeof(uint32_t));
+    if (!pixels) {
+        return false;
+    }
+    for (size_t i = 0; i < (size_t)width * (size_t)height; i++) {
+        pixels[i] = BACKGROUND_PIXEL;
+    }
+
+    free(data->canvas);
+    data->canvas = pixels;
+    data->canvas_width = width;
+    data->canvas_height = height;
+    return true;
+}
+
+/**
+ * @brief Get the part of a window's surface inside a rectangle
+ *
+ * Drawing into the view is clipped to the rectangle; its origin is the
+ * rectangle's top-left corner.
+ */
+static bool SurfaceView(const WindowData* data, LG_Rect rect, LG_CanvasBuffer* view) {
+    LG_Rect bounds = {0, 0, data->width, data->height};
+    if (!data->pixels || !RectIntersect(rect, bounds, &rect)) {
+        return false;
+    }
+
+    view->pixels = data->pixels + (size_t)rect.y * data->stride + rect.x;
+    view->width = rect.width;
+    view->height = rect.height;
+    view->stride = data->stride;
+    return true;
+}
+
+static void DrawBorder(const LG_CanvasBuffer* view, LG_Rect rect, LG_Color color) {
+    LG_Rect top = {rect.x, rect.y, rect.width, 1};
+    LG_Rect bottom = {rect.x, rect.y + rect.height - 1, rect.width, 1};
+    LG_Rect left = {rect.x, rect.y, 1, rect.height};
+    LG_Rect right = {rect.x + rect.width - 1, rect.y, 1, rect.height};
+    RasterFillRect(view, top, color);
+    RasterFillRect(view, bottom, color);
+    RasterFillRect(view, left, color);
+    RasterFillRect(view, right, color);
+}
+
+/**
+ * @brief Draw text vertically centered in a box, left-aligned at x or centered
+ */
+static void DrawBoxText(const LG_CanvasBuffer* view, LG_Rect box, int x, const char* text,
+                        LG_Color color, bool centered) {
+    if (!text || !text[0]) return;
+
+    if (centered) {
+        int width = 0;
+        LG_CanvasMeasureText(text, &width, NULL);
+        x = box.x + (box.width - width) / 2;
+    }
+    RasterDrawText(view, x, box.y + (box.height - RasterTextHeight()) / 2, text, color);
+}
+
+static void DrawListRows(LG_WidgetHandle list, const LG_CanvasBuffer* view, LG_Rect box) {
+    int row_height = ListRowHeight(list);
+    int bottom = 0;  // End of the drawn rows in list coordinates
+
+    // Only rows that overlap the view are fetched
+    LG_Rect area = {-box.x, -box.y, view->width, view->height};
+    size_t first, end;
+    if (ListRowRange(list, area, &first, &end)) {
+        for (size_t row = first; row < end; row++) {
+            bool selected = ListRowSelected(list, row);
+            LG_Rect row_box = {box.x, box.y + ListRowY(list, row), box.width, row_height};
+            RasterFillRect(view, row_box, selected ? LG_CreateColor(0, 120, 215, 255) : list->bg_color);
+            DrawBoxText(view, row_box, row_box.x + 5, ListRowText(list, row),
+                        selected ? LG_COLOR_WHITE : list->text_color, false);
+            bottom = row_box.y - box.y + row_height;
+        }
+    }
+
+    // Below the last row
+    if (bottom < box.height) {
+        LG_Rect rest = {box.x, box.y + bottom, box.width, box.height - bottom};
+        RasterFillRect(view, rest, list->bg_color);
+    }
+}
+
+static void DrawCanvas(LG_WidgetHandle canvas, const LG_CanvasBuffer* view, LG_Rect box) {
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    if (!data || !data->canvas) return;
+
+    LG_Rect bounds = {0, 0, view->width, view->height};
+    LG_Rect target = {box.x, box.y, data->canvas_width, data->canvas_height};
+    if (!RectIntersect(target, bounds, &target)) return;
+
+    // Canvas alpha is ignored on screen, so presented pixels are opaque
+    for (int y = target.y; y < target.y + target.height; y++) {
+        const uint32_t* src = data->canvas + (size_t)(y - box.y) * data->canvas_width +
+                              (target.x - box.x);
+        uint32_t* dst = view->pixels + (size_t)y * view->stride + target.x;
+        for (int x = 0; x < target.width; x++) {
+            dst[x] = src[x] | 0xFF000000u;
+        }
+    }
+}
+
+/**
+ * @brief Draw a widget into a view whose origin is at (origin_x, origin_y) in the window
+ */
+static void DrawWidget(LG_WidgetHandle widget, const LG_CanvasBuffer* view, int origin_x,
+                       int origin_y) {
+    LG_Rect box = {widget->rect.x - origin_x, widget->rect.y - origin_y,
+                   widget->rect.width, widget->rect.height};
+
+    switch (widget->type) {
+        case LG_WIDGET_BUTTON:
+            RasterFillRect(view, box, widget->bg_color);
+            DrawBorder(view, box, LG_COLOR_BLACK);
+            DrawBoxText(view, box, 0, widget->text, widget->text_color, true);
+            break;
+
+        case LG_WIDGET_LABEL:
+            RasterFillRect(view, box, widget->bg_color);
+            DrawBoxText(view, box, box.x + 5, widget->text, widget->text_color, false);
+            break;
+
+        case LG_WIDGET_TEXTFIELD:
+            RasterFillRect(view, box, widget->bg_color);
+            DrawBorder(view, box, LG_COLOR_BLACK);
+            DrawBoxText(view, box, box.x + 5, widget->text, widget->text_color, false);
+            break;
+
+        case LG_WIDGET_PANEL:
+            RasterFillRect(view, box, widget->bg_color);
+            break;
+
+        case LG_WIDGET_CANVAS:
+            DrawCanvas(widget, view, box);
+            break;
+
+        case LG_WIDGET_LIST:
+            DrawListRows(widget, view, box);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Find the topmost visible widget at a point, native or windowless
+ */
+static LG_WidgetHandle HitTestAnyWidget(LG_WindowHandle window, int x, int y) {
+    LG_Rect point = {x, y, 1, 1};
+    LG_WidgetHandle* widgets;
+    size_t count = SpatialQuery(window, &point, 1, &widgets);
+
+    // Results are in drawing order, so the last match is on top
+    for (size_t i = count; i-- > 0;) {
+        if (widgets[i]->visible) {
+            return widgets[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Route one injected event the way a native backend routes input
+ */
+static void DeliverEvent(LG_WindowHandle window, LG_Event* event) {
+    WindowData* data = (WindowData*)window->platform_data;
+
+    switch (event->type) {
+        case LG_EVENT_MOUSE_MOVE:
+            DispatchMouseMotion(window, event->data.mouse_move.x, event->data.mouse_move.y);
+            break;
+
+        case LG_EVENT_MOUSE_BUTTON:
+            {
+                int x = event->data.mouse_button.x;
+                int y = event->data.mouse_button.y;
+                LG_WidgetHandle widget = HitTestAnyWidget(window, x, y);
+
+                if (widget && event->data.mouse_button.pressed &&
+                    event->data.mouse_button.button == LG_MOUSE_BUTTON_LEFT) {
+                    if (widget->type == LG_WIDGET_LIST) {
+                        ListClick(widget, y - widget->rect.y);
+                    }
+
+                    LG_Event widget_event;
+                    memset(&widget_event, 0, sizeof(widget_event));
+                    widget_event.type = LG_EVENT_WIDGET_CLICKED;
+                    widget_event.data.widget_clicked.widget = widget;
+                    widget_event.data.widget_clicked.x = x - widget->rect.x;
+                    widget_event.data.widget_clicked.y = y - widget->rect.y;
+                    DispatchWindowEvent(window, &widget_event);
+                }
+
+                DispatchWindowEvent(window, event);
+            }
+            break;
+
+        case LG_EVENT_WINDOW_RESIZE:
+            // Reported by the core with the final size, like native configure events
+            if (ResizeSurface(data, event->data.window_resize.width,
+                              event->data.window_resize.height)) {
+                DispatchWindowResize(window, data->width, data->height);
+            }
+            break;
+
+        default:
+            DispatchWindowEvent(window, event);
+            break;
+    }
+}
+
+/**
+ * @brief Take the oldest injected event of a window
+ */
+static bool PopEvent(WindowData* data, LG_Event* event) {
+    if (data->queue_count == 0) {
+        return false;
+    }
+
+    *event = data->queue[data->queue_head];
+    data->queue_head = (data->queue_head + 1) % data->queue_capacity;
+    data->queue_count--;
+    return true;
+}
+
+static bool HasQueuedEvents(void) {
+    for (size_t i = 0; i < g_windows.count; i++) {
+        WindowData* data = (WindowData*)g_windows.windows[i]->platform_data;
+        if (data && data->queue_count > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ========================================================================= */
+/*                        Platform Implementation                            */
+/* ========================================================================= */
+
+static bool HeadlessInitialize(void) {
+#ifndef _WIN32
+    // Timed waits measure against the monotonic clock, like HeadlessGetTime
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    int result = pthread_cond_init(&g_wake_cond, &attr);
+    pthread_condattr_destroy(&attr);
+    if (result != 0) {
+        fprintf(stderr, "LightGUI: Failed to create wakeup condition\n");
+        return false;
+    }
+
+    // Waits on child process pipes poll this instead of the condition
+    if (pipe(g_wake_pipe) == 0) {
+        for (int i = 0; i < 2; i++) {
+            fcntl(g_wake_pipe[i], F_SETFL, fcntl(g_wake_pipe[i], F_GETFL) | O_NONBLOCK);
+            fcntl(g_wake_pipe[i], F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        fprintf(stderr, "LightGUI: Failed to create wakeup pipe\n");
+        g_wake_pipe[0] = g_wake_pipe[1] = -1;
+    }
+#else
+    g_wake_event = CreateEventA(NULL, FALSE, FALSE, NULL);
+    if (!g_wake_event) {
+        fprintf(stderr, "LightGUI: Failed to create wakeup event\n");
+    }
+#endif
+    g_woken = false;
+    return true;
+}
+
+static void HeadlessTerminate(void) {
+#ifndef _WIN32
+    pthread_cond_destroy(&g_wake_cond);
+    for (int i = 0; i < 2; i++) {
+        if (g_wake_pipe[i] >= 0) {
+            close(g_wake_pipe[i]);
+            g_wake_pipe[i] = -1;
+        }
+    }
+#else
+    if (g_wake_event) {
+        CloseHandle(g_wake_event);
+        g_wake_event = NULL;
+    }
+#endif
+}
+
+static bool HeadlessCreateWindow(LG_WindowHandle window) {
+    if (!window) return false;
+
+    WindowData* data = (WindowData*)calloc(1, sizeof(WindowData));
+    if (!data) {
+        fprintf(stderr, "LightGUI: Failed to allocate window data\n");
+        return false;
+    }
+
+    if (!ResizeSurface(data, window->width, window->height)) {
+        free(data);
+        return false;
+    }
+
+    window->platform_data = data;
+    return true;
+}
+
+static void HeadlessDestroyWindow(LG_WindowHandle window) {
+    if (!window || !window->platform_data) return;
+
+    WindowData* data = (WindowData*)window->platform_data;
+    free(data->pixels);
+    free(data->queue);
+    free(data);
+    window->platform_data = NULL;
+}
+
+static void HeadlessShowWindow(LG_WindowHandle window) {
+    // Shown windows are rendered through their damage like any other
+    (void)window;
+}
+
+static void HeadlessHideWindow(LG_WindowHandle window) {
+    (void)window;
+}
+
+static void HeadlessSetWindowTitle(LG_WindowHandle window, const char* title) {
+    (void)window;
+    (void)title;
+}
+
+static bool HeadlessCreateWidget(LG_WidgetHandle widget) {
+    if (!widget || !widget->window || !widget->window->platform_data) return false;
+
+    WidgetData* data = (WidgetData*)AllocWidgetData(widget->window, sizeof(WidgetData));
+    if (!data) {
+        fprintf(stderr, "LightGUI: Failed to allocate widget data\n");
+        return false;
+    }
+    widget->platform_data = data;
+
+    if (widget->type == LG_WIDGET_CANVAS && !ResizeCanvas(widget)) {
+        fprintf(stderr, "LightGUI: Failed to create canvas buffer\n");
+        FreeWidgetData(widget->window, data);
+        widget->platform_data = NULL;
+        return false;
+    }
+
+    // The core damages the widget's area, which draws it on the next render
+    return true;
+}
+
+static void HeadlessDestroyWidget(LG_WidgetHandle widget) {
+    if (!widget || !widget->platform_data) return;
+
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    free(data->canvas);
+    FreeWidgetData(widget->window, data);
+    widget->platform_data = NULL;
+}
+
+static void HeadlessUpdateWidget(LG_WidgetHandle widget) {
+    if (!widget || !widget->platform_data) return;
+
+    // Everything else is repainted through the damage the core records
+    if (widget->type == LG_WIDGET_CANVAS && (widget->dirty & LG_WIDGET_DIRTY_GEOMETRY)) {
+        ResizeCanvas(widget);
+    }
+}
+
+static void HeadlessUpdateWidgets(LG_WidgetHandle* widgets, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        HeadlessUpdateWidget(widgets[i]);
+    }
+}
+
+static bool HeadlessProcessEvents(void) {
+    // Callbacks may inject more events or destroy windows, so re-check each step
+    for (size_t i = 0; i < g_windows.count; i++) {
+        LG_WindowHandle window = g_windows.windows[i];
+        LG_Event event;
+        while (i < g_windows.count && window == g_windows.windows[i] &&
+               PopEvent((WindowData*)window->platform_data, &event)) {
+            DeliverEvent(window, &event);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Take a wakeup that arrived since the last wait
+ */
+static bool TakeWakeup(void) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&g_wake_lock);
+    bool woken = g_woken;
+    g_woken = false;
+    ReleaseSRWLockExclusive(&g_wake_lock);
+#else
+    pthread_mutex_lock(&g_wake_lock);
+    bool woken = g_woken;
+    g_woken = false;
+    pthread_mutex_unlock(&g_wake_lock);
+#endif
+    return woken;
+}
+
+/**
+ * @brief Wait for a wakeup or any of handles
+ * 
+ * A wakeup after TakeWakeup still ends the wait, through the wake pipe
+ * or event that HeadlessWakeup signals along with the condition.
+ */
+static bool WaitForHandles(int timeout_ms, const LG_WaitHandle* handles, size_t handle_count) {
+    if (TakeWakeup()) {
+        return true;
+    }
+
+#ifdef _WIN32
+    HANDLE objects[1 + LG_MAX_WAIT_HANDLES];
+    DWORD count = 0;
+    if (g_wake_event) {
+        objects[count++] = g_wake_event;
+    }
+    for (size_t i = 0; i < handle_count; i++) {
+        objects[count++] = (HANDLE)handles[i];
+    }
+
+    DWORD result = WaitForMultipleObjects(count, objects, FALSE,
+                                          timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms);
+    bool ready = result != WAIT_TIMEOUT && result != WAIT_FAILED;
+#else
+    struct pollfd fds[1 + LG_MAX_WAIT_HANDLES];
+    nfds_t nfds = 0;
+    if (g_wake_pipe[0] >= 0) {
+        fds[nfds].fd = g_wake_pipe[0];
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        nfds++;
+    }
+    for (size_t i = 0; i < handle_count; i++) {
+        fds[nfds].fd = handles[i];
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        nfds++;
+    }
+
+    bool ready = poll(fds, nfds, timeout_ms) > 0;
+
+    // Drain the wakeup pipe so the next wait blocks again
+    if (g_wake_pipe[0] >= 0 && (fds[0].revents & POLLIN)) {
+        char drain[64];
+        while (read(g_wake_pipe[0], drain, sizeof(drain)) > 0) {
+        }
+    }
+#endif
+
+    TakeWakeup();
+    return ready;
+}
+
+static bool HeadlessWaitEvents(int timeout_ms, const LG_WaitHandle* handles, size_t handle_count) {
+    if (HasQueuedEvents()) {
+        return true;
+    }
+
+    if (handle_count > 0) {
+        return WaitForHandles(timeout_ms, handles, handle_count);
+    }
+
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&g_wake_lock);
+    if (!g_woken) {
+        SleepConditionVariableSRW(&g_wake_cond, &g_wake_lock,
+                                  timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms, 0);
+    }
+    bool woken = g_woken;
+    g_woken = false;
+    ReleaseSRWLockExclusive(&g_wake_lock);
+#else
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeout_ms > 0) {
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    pthread_mutex_lock(&g_wake_lock);
+    while (!g_woken && timeout_ms != 0) {
+        int result = timeout_ms < 0 ? pthread_cond_wait(&g_wake_cond, &g_wake_lock)
+                                    : pthread_cond_timedwait(&g_wake_cond, &g_wake_lock, &deadline);
+        if (result == ETIMEDOUT) break;
+    }
+    bool woken = g_woken;
+    g_woken = false;
+    pthread_mutex_unlock(&g_wake_lock);
+#endif
+
+    return woken;
+}
+
+static void HeadlessWakeup(void) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&g_wake_lock);
+    g_woken = true;
+    ReleaseSRWLockExclusive(&g_wake_lock);
+    WakeConditionVariable(&g_wake_cond);
+    if (g_wake_event) {
+        SetEvent(g_wake_event);
+    }
+#else
+    pthread_mutex_lock(&g_wake_lock);
+    g_woken = true;
+    pthread_cond_signal(&g_wake_cond);
+    pthread_mutex_unlock(&g_wake_lock);
+
+    // A full pipe already guarantees a wakeup, so a failed write is harmless
+    if (g_wake_pipe[1] >= 0) {
+        char byte = 1;
+        ssize_t written = write(g_wake_pipe[1], &byte, 1);
+        (void)written;
+    }
+#endif
+}
+
+static uint64_t HeadlessGetTime(void) {
+#ifdef _WIN32
+    LARGE_INTEGER counter, frequency;
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000 +
+           (uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000 / frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+#endif
+}
+
+static bool HeadlessGetVBlankTiming(uint64_t* last_vblank, uint64_t* interval) {
+    // There is no display; LG_Run paces frames by LG_SetFrameRate
+    (void)last_vblank;
+    (void)interval;
+    return false;
+}
+
+static void HeadlessRasterizeWindow(LG_WindowHandle window) {
+    if (!window || !window->platform_data) return;
+
+    WindowData* data = (WindowData*)window->platform_data;
+    const LG_DamageRegion* damage = &window->damage;
+    if (damage->count == 0) return;
+
+    LG_WidgetHandle* overlapping;
+    size_t overlapping_count = SpatialQuery(window, damage->rects, damage->count, &overlapping);
+
+    // Repaint each damaged rectangle through a view clipped to it
+    for (int r = 0; r < damage->count; r++) {
+        LG_Rect rect = damage->rects[r];
+        LG_CanvasBuffer view;
+        if (!SurfaceView(data, rect, &view)) continue;
+
+        for (int y = 0; y < view.height; y++) {
+            uint32_t* row = view.pixels + (size_t)y * view.stride;
+            for (int x = 0; x < view.width; x++) {
+                row[x] = BACKGROUND_PIXEL;
+            }
+        }
+
+        int origin_x = rect.x > 0 ? rect.x : 0;
+        int origin_y = rect.y > 0 ? rect.y : 0;
+        for (size_t i = 0; i < overlapping_count; i++) {
+            LG_WidgetHandle widget = overlapping[i];
+            if (widget->visible && RectIntersect(widget->rect, rect, NULL)) {
+                DrawWidget(widget, &view, origin_x, origin_y);
+            }
+        }
+    }
+}
+
+static void HeadlessRenderWindow(LG_WindowHandle window) {
+    // The surface is the frame; there is nothing to present
+    (void)window;
+}
+
+static void* HeadlessGetNativeHandle(LG_WidgetHandle widget) {
+    (void)widget;
+    return NULL;
+}
+
+static bool HeadlessGetCanvasBuffer(LG_WidgetHandle canvas, LG_CanvasBuffer* buffer) {
+    if (!canvas || !canvas->platform_data || !buffer) return false;
+
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    if (!data->canvas) return false;
+
+    buffer->pixels = data->canvas;
+    buffer->width = data->canvas_width;
+    buffer->height = data->canvas_height;
+    buffer->stride = data->canvas_width;
+    return true;
+}
+
+static void HeadlessPresentCanvas(LG_WidgetHandle canvas, LG_Rect rect) {
+    if (!canvas || !canvas->platform_data || !canvas->window->platform_data) return;
+
+    // Copy straight into the surface, clipped to the presented area
+    WindowData* window_data = (WindowData*)canvas->window->platform_data;
+    LG_Rect area = {canvas->rect.x + rect.x, canvas->rect.y + rect.y, rect.width, rect.height};
+    LG_CanvasBuffer view;
+    if (SurfaceView(window_data, area, &view)) {
+        int origin_x = area.x > 0 ? area.x : 0;
+        int origin_y = area.y > 0 ? area.y : 0;
+        DrawWidget(canvas, &view, origin_x, origin_y);
+    }
+}
+
+static void HeadlessRedrawList(LG_WidgetHandle list, LG_Rect rect) {
+    if (!list) return;
+
+    rect.x += list->rect.x;
+    rect.y += list->rect.y;
+    DamageWindowRect(list->window, rect);
+}
+
+static void HeadlessScrollList(LG_WidgetHandle list, int dy) {
+    // Repainting the visible rows is as cheap as moving them in memory
+    (void)dy;
+    if (list) {
+        DamageWidget(list);
+    }
+}
+
+static bool HeadlessBuildGlyphAtlas(LG_GlyphAtlas* atlas) {
+    atlas->ascent = FONT_ASCENT;
+    atlas->descent = FONT_DESCENT;
+    atlas->cell_width = FONT_CELL_WIDTH;
+    atlas->origin_x = 0;
+    atlas->stride = FONT_CELL_WIDTH * LG_GLYPH_COUNT;
+    atlas->coverage = (uint8_t*)malloc((size_t)atlas->stride * FONT_HEIGHT);
+    if (!atlas->coverage) return false;
+
+    for (int i = 0; i < LG_GLYPH_COUNT; i++) {
+        atlas->advance[i] = FONT_ADVANCE;
+        for (int y = 0; y < FONT_HEIGHT; y++) {
+            uint8_t* dst = atlas->coverage + (size_t)y * atlas->stride + i * FONT_CELL_WIDTH;
+            for (int x = 0; x < FONT_CELL_WIDTH; x++) {
+                dst[x] = (g_font_rows[i][y] & (0x80 >> x)) ? 255 : 0;
+            }
+        }
+    }
+    return true;
+}
+
+static void HeadlessFlush(void) {
+    // Rendering writes the surfaces directly; there is nothing to send
+}
+
+static bool HeadlessInjectEvent(LG_WindowHandle window, const LG_Event* event) {
+    WindowData* data = (WindowData*)window->platform_data;
+    if (!data) return false;
+
+    if (data->queue_count == data->queue_capacity) {
+        size_t capacity = data->queue_capacity ? data->queue_capacity * 2 : 64;
+        LG_Event* queue = (LG_Event*)malloc(capacity * sizeof(LG_Event));
+        if (!queue) {
+            fprintf(stderr, "LightGUI: Failed to grow event queue\n");
+            return false;
+        }
+
+        // Unwrap the ring into the new buffer
+        for (size_t i = 0; i < data->queue_count; i++) {
+            queue[i] = data->queue[(data->queue_head + i) % data->queue_capacity];
+        }
+        free(data->queue);
+        data->queue = queue;
+        data->queue_head = 0;
+        data->queue_capacity = capacity;
+    }
+
+    data->queue[(data->queue_head + data->queue_count) % data->queue_capacity] = *event;
+    data->queue_count++;
+    return true;
+}
+
+static bool HeadlessGetWindowFrame(LG_WindowHandle window, LG_CanvasBuffer* frame) {
+    WindowData* data = (WindowData*)window->platform_data;
+    if (!data || !data->pixels) return false;
+
+    frame->pixels = data->pixels;
+    frame->width = data->width;
+    frame->height = data->height;
+    frame->stride = data->stride;
+    return true;
+}
+
+/* ========================================================================= */
+/*                        Backend Table                                      */
+/* ========================================================================= */
+
+const LG_PlatformBackend g_headless_backend = {
+    "headless",
+    HeadlessInitialize,
+    HeadlessTerminate,
+    HeadlessCreateWindow,
+    HeadlessDestroyWindow,
+    HeadlessShowWindow,
+    HeadlessHideWindow,
+    HeadlessSetWindowTitle,
+    HeadlessCreateWidget,
+    HeadlessDestroyWidget,
+    HeadlessUpdateWidget,
+    HeadlessUpdateWidgets,
+    HeadlessProcessEvents,
+    HeadlessWaitEvents,
+    HeadlessWakeup,
+    HeadlessGetTime,
+    HeadlessGetVBlankTiming,
+    HeadlessRenderWindow,
+    HeadlessGetNativeHandle,
+    HeadlessGetCanvasBuffer,
+    HeadlessPresentCanvas,
+    HeadlessRedrawList,
+    HeadlessScrollList,
+    HeadlessBuildGlyphAtlas,
+    HeadlessFlush,
+    HeadlessInjectEvent,
+    HeadlessGetWindowFrame,
+    HeadlessRasterizeWindow,
+    NULL,  // wait_for_vblank: there is no display
+    NULL,  // gl_make_current: no OpenGL canvases
+    NULL,  // gl_swap_buffers
+    NULL   // gl_set_swap_interval
+};
@@ -14,27 +14,88 @@
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <time.h>
+
+#ifdef LG_HAVE_XSHM
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif
+
+#ifdef LG_HAVE_GLX
+#include <GL/glx.h>
+#endif
+
+#ifdef LG_HAVE_XFT
+#include <X11/Xft/Xft.h>
+#endif
 
 /* ========================================================================= */
 /*                        Platform-Specific Structures                       */
 /* ========================================================================= */
 
+/**
+ * @brief The font every window draws with, opened once per display
+ */
+typedef struct {
+#ifdef LG_HAVE_XFT
+    XftFont* xft;  // Antialiased font; NULL if fontconfig had none
+#endif
+    XFontStruct* core;  // Only opened without an Xft font
+    int ascent;
+    int descent;
+} SharedFont;
+
+/**
+ * @brief Text converted to glyph codes of the shared font
+ */
+typedef struct {
+    void* glyphs;  // FT_UInt with an Xft font, XChar2b with the core font
+    int count;
+    int capacity;  // In 4-byte slots, enough for either kind of code
+} TextRun;
+
 /**
  * @brief X11-specific window data
  */
 typedef struct {
     Window window;
     GC gc;
-    Pixmap buffer;
-    XFontStruct* font;
+    Pixmap buffer;  // At least the window size; see BackBufferSize
+    int buffer_width;
+    int buffer_height;
+#ifdef LG_HAVE_XFT
+    XftDraw* xft_draw;  // Pointed at whatever is drawn into, like gc
+#endif
 } WindowData;
 
+/**
+ * @brief Client-side pixel buffer of a canvas
+ */
+typedef struct {
+    XImage* image;
+#ifdef LG_HAVE_XSHM
+    XShmSegmentInfo shm;
+    bool use_shm;  // Pixels live in a segment shared with the server
+    int puts_pending;  // XShmPutImage requests the server has not finished
+#endif
+} CanvasImage;
+
 /**
  * @brief X11-specific widget data
  */
 typedef struct {
-    Window window;
+    Window window;  // None for windowless widgets
     int type;  // Internal widget type
+    CanvasImage canvas;  // Only used by canvas widgets
+    Pixmap list_buffer;  // Back buffer of native list widgets, scrolled in place
+    TextRun text;  // The widget's text; see WidgetTextRun
+#ifdef LG_HAVE_GLX
+    GLXContext gl_context;  // Only used by OpenGL canvases
+    Colormap gl_colormap;  // For the context's visual
+#endif
 } WidgetData;
 
 /* ========================================================================= */
@@ -44,7 +105,15 @@ typedef struct {
 static Display* g_display = NULL;
 static int g_screen = 0;
 static Atom g_wm_delete_window = 0;
-static XFontStruct* g_default_font = NULL;
+static SharedFont g_font;
+static int g_wake_pipe[2] = {-1, -1};  // Self-pipe used by LG_PlatformWakeup
+static XContext g_window_context = 0;  // X Window -> LG_WindowHandle
+static XContext g_widget_context = 0;  // X Window -> LG_WidgetHandle
+#ifdef LG_HAVE_XSHM
+static bool g_have_shm = false;
+static int g_shm_completion_event = -1;  // Event type of ShmCompletion
+static int g_x_error = 0;  // Set by CatchXError
+#endif
 
 /* ========================================================================= */
 /*                        Helper Functions                                   */
@@ -58,66 +127,519 @@ static unsigned long ColorToX11Color(LG_Color color) {
 }
 
 /**
- * @brief Find the window handle for a given LG_WindowHandle
+ * @brief Find the LG_WindowHandle for a given X11 Window
  */
-static Window GetWindowHandle(LG_WindowHandle window) {
-    if (!window || !window->platform_data) return 0;
-    return ((WindowData*)window->platform_data)->window;
+static LG_WindowHandle FindWindowByHandle(Window x_window) {
+    // Xlib keeps contexts in a hash table keyed by resource ID
+    XPointer data = NULL;
+    if (XFindContext(g_display, x_window, g_window_context, &data) != 0) {
+        return NULL;
+    }
+    return (LG_WindowHandle)data;
 }
 
 /**
- * @brief Find the LG_WindowHandle for a given X11 Window
+ * @brief Find the LG_WidgetHandle for a given X11 Window
  */
-static LG_WindowHandle FindWindowByHandle(Window x_window) {
-    // This is a simple implementation that iterates through all windows
-    // A more efficient implementation would use a hash table
-    extern LG_WindowList g_windows;
-    for (size_t i = 0; i < g_windows.count; i++) {
-        if (GetWindowHandle(g_windows.windows[i]) == x_window) {
-            return g_windows.windows[i];
+static LG_WidgetHandle FindWidgetByHandle(Window x_window) {
+    XPointer data = NULL;
+    if (XFindContext(g_display, x_window, g_widget_context, &data) != 0) {
+        return NULL;
+    }
+    return (LG_WidgetHandle)data;
+}
+
+#ifdef LG_HAVE_XSHM
+/**
+ * @brief Error handler used while probing whether MIT-SHM really works
+ */
+static int CatchXError(Display* display, XErrorEvent* event) {
+    (void)display;
+    g_x_error = event->error_code;
+    return 0;
+}
+
+/**
+ * @brief Create the image in memory shared with the X server
+ */
+static bool CreateShmImage(CanvasImage* canvas, int width, int height) {
+    XImage* image = XShmCreateImage(g_display, DefaultVisual(g_display, g_screen),
+                                    DefaultDepth(g_display, g_screen), ZPixmap,
+                                    NULL, &canvas->shm, width, height);
+    if (!image) return false;
+    
+    canvas->shm.shmid = shmget(IPC_PRIVATE, (size_t)image->bytes_per_line * height,
+                               IPC_CREAT | 0600);
+    if (canvas->shm.shmid < 0) {
+        XDestroyImage(image);
+        return false;
+    }
+    
+    canvas->shm.shmaddr = image->data = (char*)shmat(canvas->shm.shmid, NULL, 0);
+    canvas->shm.readOnly = False;
+    if (canvas->shm.shmaddr == (char*)-1) {
+        shmctl(canvas->shm.shmid, IPC_RMID, NULL);
+        image->data = NULL;
+        XDestroyImage(image);
+        return false;
+    }
+    
+    // Attaching fails on remote displays; catch that instead of exiting
+    XSync(g_display, False);
+    g_x_error = 0;
+    XErrorHandler old_handler = XSetErrorHandler(CatchXError);
+    Status attached = XShmAttach(g_display, &canvas->shm);
+    XSync(g_display, False);
+    XSetErrorHandler(old_handler);
+    
+    // The segment is freed once both sides have detached
+    shmctl(canvas->shm.shmid, IPC_RMID, NULL);
+    
+    if (!attached || g_x_error) {
+        shmdt(canvas->shm.shmaddr);
+        image->data = NULL;
+        XDestroyImage(image);
+        return false;
+    }
+    
+    canvas->image = image;
+    canvas->use_shm = true;
+    canvas->puts_pending = 0;
+    return true;
+}
+
+/**
+ * @brief Match the ShmCompletion event of one canvas window
+ */
+static Bool IsShmCompletion(Display* display, XEvent* event, XPointer arg) {
+    (void)display;
+    return event->type == g_shm_completion_event &&
+           ((XShmCompletionEvent*)event)->drawable == *(Window*)arg;
+}
+#endif
+
+/**
+ * @brief Wait until the server has finished reading a canvas's pixels
+ */
+static void WaitForCanvasPut(WidgetData* data) {
+#ifdef LG_HAVE_XSHM
+    while (data->canvas.puts_pending > 0) {
+        XEvent event;
+        XIfEvent(g_display, &event, IsShmCompletion, (XPointer)&data->window);
+        data->canvas.puts_pending--;
+    }
+#else
+    (void)data;
+#endif
+}
+
+/**
+ * @brief Create the pixel buffer of a canvas, shared with the server if possible
+ */
+static bool CreateCanvasImage(CanvasImage* canvas, int width, int height) {
+    memset(canvas, 0, sizeof(CanvasImage));
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    
+#ifdef LG_HAVE_XSHM
+    if (g_have_shm) {
+        CreateShmImage(canvas, width, height);
+    }
+#endif
+    
+    if (!canvas->image) {
+        // Plain client-side image; every present copies it over the connection
+        canvas->image = XCreateImage(g_display, DefaultVisual(g_display, g_screen),
+                                     DefaultDepth(g_display, g_screen), ZPixmap,
+                                     0, NULL, width, height, 32, 0);
+        if (!canvas->image) return false;
+        
+        canvas->image->data = (char*)malloc((size_t)canvas->image->bytes_per_line * height);
+        if (!canvas->image->data) {
+            XDestroyImage(canvas->image);
+            canvas->image = NULL;
+            return false;
         }
     }
-    return NULL;
+    
+    // Start out white, like the canvas background on other platforms
+    memset(canvas->image->data, 0xFF, (size_t)canvas->image->bytes_per_line * height);
+    return true;
+}
+
+/**
+ * @brief Free the pixel buffer of a canvas
+ */
+static void DestroyCanvasImage(CanvasImage* canvas) {
+    if (!canvas->image) return;
+    
+#ifdef LG_HAVE_XSHM
+    if (canvas->use_shm) {
+        XShmDetach(g_display, &canvas->shm);
+        XDestroyImage(canvas->image);  // Leaves the shared pixels alone
+        shmdt(canvas->shm.shmaddr);
+        canvas->image = NULL;
+        return;
+    }
+#endif
+    
+    XDestroyImage(canvas->image);
+    canvas->image = NULL;
 }
 
 /**
- * @brief Find the LG_WidgetHandle for a given X11 Window
+ * @brief Reallocate a canvas's pixel buffer after a resize, keeping the overlap
  */
-static LG_WidgetHandle FindWidgetByHandle(Window x_window) {
-    // This is a simple implementation that iterates through all windows and widgets
-    // A more efficient implementation would use a hash table
-    extern LG_WindowList g_windows;
-    for (size_t i = 0; i < g_windows.count; i++) {
-        LG_WindowHandle window = g_windows.windows[i];
-        for (size_t j = 0; j < window->widgets.count; j++) {
-            LG_WidgetHandle widget = window->widgets.widgets[j];
-            if (widget->platform_data && ((WidgetData*)widget->platform_data)->window == x_window) {
-                return widget;
+static void ResizeCanvasImage(LG_WidgetHandle widget) {
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    XImage* old_image = data->canvas.image;
+    if (old_image && old_image->width == widget->rect.width &&
+        old_image->height == widget->rect.height) {
+        return;
+    }
+    
+    WaitForCanvasPut(data);
+    
+    CanvasImage resized;
+    if (!CreateCanvasImage(&resized, widget->rect.width, widget->rect.height)) {
+        fprintf(stderr, "LightGUI: Failed to resize canvas buffer\n");
+        return;
+    }
+    
+    if (old_image) {
+        int width = old_image->width < resized.image->width ? old_image->width : resized.image->width;
+        int height = old_image->height < resized.image->height ? old_image->height : resized.image->height;
+        for (int y = 0; y < height; y++) {
+            memcpy(resized.image->data + (size_t)y * resized.image->bytes_per_line,
+                   old_image->data + (size_t)y * old_image->bytes_per_line,
+                   (size_t)width * 4);
+        }
+    }
+    
+    DestroyCanvasImage(&data->canvas);
+    data->canvas = resized;
+}
+
+/**
+ * @brief Send part of a canvas's pixel buffer to its window
+ */
+static void PutCanvasImage(LG_WidgetHandle widget, LG_Rect rect) {
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    WindowData* window_data = (WindowData*)widget->window->platform_data;
+    XImage* image = data->canvas.image;
+    if (!image) return;
+    
+    LG_Rect bounds = {0, 0, image->width, image->height};
+    if (!RectIntersect(rect, bounds, &rect)) return;
+    
+#ifdef LG_HAVE_XSHM
+    if (data->canvas.use_shm) {
+        // The server reads straight from shared memory and reports completion
+        XShmPutImage(g_display, data->window, window_data->gc, image,
+                     rect.x, rect.y, rect.x, rect.y, rect.width, rect.height, True);
+        data->canvas.puts_pending++;
+        return;
+    }
+#endif
+    
+    XPutImage(g_display, data->window, window_data->gc, image,
+              rect.x, rect.y, rect.x, rect.y, rect.width, rect.height);
+}
+
+/**
+ * @brief Open the shared font, preferring an antialiased Xft font
+ */
+static bool OpenSharedFont(void) {
+#ifdef LG_HAVE_XFT
+    g_font.xft = XftFontOpenName(g_display, g_screen, "sans-serif:pixelsize=13");
+    if (g_font.xft) {
+        g_font.ascent = g_font.xft->ascent;
+        g_font.descent = g_font.xft->descent;
+        return true;
+    }
+#endif
+    
+    // An ISO 10646 font covers far more than the Latin-1 "fixed" alias
+    g_font.core = XLoadQueryFont(g_display, "-misc-fixed-medium-r-semicondensed--13-*-*-*-*-*-iso10646-1");
+    if (!g_font.core) {
+        g_font.core = XLoadQueryFont(g_display, "fixed");
+    }
+    if (!g_font.core) return false;
+    
+    g_font.ascent = g_font.core->ascent;
+    g_font.descent = g_font.core->descent;
+    return true;
+}
+
+static void CloseSharedFont(void) {
+#ifdef LG_HAVE_XFT
+    if (g_font.xft) {
+        XftFontClose(g_display, g_font.xft);
+    }
+#endif
+    if (g_font.core) {
+        XFreeFont(g_display, g_font.core);
+    }
+    memset(&g_font, 0, sizeof(g_font));
+}
+
+/**
+ * @brief Decode the UTF-8 character at *offset and step past it
+ * 
+ * Malformed and truncated sequences decode to U+FFFD one byte at a time.
+ */
+static uint32_t DecodeUtf8(const char* text, size_t length, size_t* offset) {
+    const unsigned char* s = (const unsigned char*)text + *offset;
+    size_t left = length - *offset;
+    uint32_t c = s[0];
+    uint32_t min;
+    size_t extra;
+    
+    if (c < 0x80) {
+        *offset += 1;
+        return c;
+    } else if ((c & 0xE0) == 0xC0) {
+        c &= 0x1F;
+        min = 0x80;
+        extra = 1;
+    } else if ((c & 0xF0) == 0xE0) {
+        c &= 0x0F;
+        min = 0x800;
+        extra = 2;
+    } else if ((c & 0xF8) == 0xF0) {
+        c &= 0x07;
+        min = 0x10000;
+        extra = 3;
+    } else {
+        *offset += 1;
+        return 0xFFFD;
+    }
+    
+    if (extra >= left) {
+        *offset += 1;
+        return 0xFFFD;
+    }
+    for (size_t i = 1; i <= extra; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            *offset += 1;
+            return 0xFFFD;
+        }
+        c = (c << 6) | (s[i] & 0x3F);
+    }
+    
+    // Overlong forms and surrogates are not characters
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+        *offset += 1;
+        return 0xFFFD;
+    }
+    *offset += extra + 1;
+    return c;
+}
+
+/**
+ * @brief Convert UTF-8 text to glyph codes of the shared font
+ * 
+ * @param glyphs Receives the codes; one 4-byte slot per byte of text is always enough
+ * @param capacity The number of slots in glyphs
+ * @return The number of codes written
+ */
+static int EncodeText(const char* text, size_t length, void* glyphs, int capacity) {
+    int count = 0;
+    size_t offset = 0;
+    
+#ifdef LG_HAVE_XFT
+    if (g_font.xft) {
+        // Characters the font lacks map to glyph 0, its missing-glyph box
+        FT_UInt* codes = (FT_UInt*)glyphs;
+        while (offset < length && count < capacity) {
+            codes[count++] = XftCharIndex(g_display, g_font.xft, DecodeUtf8(text, length, &offset));
+        }
+        return count;
+    }
+#endif
+    
+    // Core fonts are indexed by 16 bits; fonts without a character show their default one
+    XChar2b* codes = (XChar2b*)glyphs;
+    while (offset < length && count < capacity) {
+        uint32_t c = DecodeUtf8(text, length, &offset);
+        if (c > 0xFFFF) {
+            c = 0xFFFD;
+        }
+        codes[count].byte1 = (unsigned char)(c >> 8);
+        codes[count].byte2 = (unsigned char)(c & 0xFF);
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Get the advance of encoded text in pixels
+ */
+static int TextWidth(const void* glyphs, int count) {
+#ifdef LG_HAVE_XFT
+    if (g_font.xft) {
+        XGlyphInfo extents;
+        XftGlyphExtents(g_display, g_font.xft, (const FT_UInt*)glyphs, count, &extents);
+        return extents.xOff;
+    }
+#endif
+    return XTextWidth16(g_font.core, (XChar2b*)glyphs, count);
+}
+
+/**
+ * @brief Draw encoded text with its baseline at (x, y)
+ */
+static void DrawText(WindowData* window_data, Drawable target, int x, int y,
+                     const void* glyphs, int count, LG_Color color) {
+    if (count == 0) return;
+    
+#ifdef LG_HAVE_XFT
+    if (g_font.xft) {
+        if (XftDrawDrawable(window_data->xft_draw) != target) {
+            XftDrawChange(window_data->xft_draw, target);
+        }
+        
+        // Colors are used as TrueColor pixels everywhere, so nothing is allocated
+        XftColor xft_color;
+        xft_color.pixel = ColorToX11Color(color);
+        xft_color.color.red = (unsigned short)(color.r * 257);
+        xft_color.color.green = (unsigned short)(color.g * 257);
+        xft_color.color.blue = (unsigned short)(color.b * 257);
+        xft_color.color.alpha = 0xFFFF;
+        XftDrawGlyphs(window_data->xft_draw, &xft_color, g_font.xft, x, y, (const FT_UInt*)glyphs, count);
+        return;
+    }
+#endif
+    
+    XSetForeground(g_display, window_data->gc, ColorToX11Color(color));
+    XDrawString16(g_display, target, window_data->gc, x, y, (const XChar2b*)glyphs, count);
+}
+
+/**
+ * @brief Get a widget's encoded text, converting and measuring it only after it changed
+ * 
+ * The core resets text_width whenever the text changes. The run is empty if
+ * its buffer could not grow.
+ */
+static const TextRun* WidgetTextRun(LG_WidgetHandle widget) {
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    TextRun* run = &data->text;
+    
+    if (widget->text_width < 0 || !run->glyphs) {
+        int needed = widget->text_length > 0 ? (int)widget->text_length : 1;
+        if (needed > run->capacity) {
+            void* glyphs = realloc(run->glyphs, (size_t)needed * sizeof(uint32_t));
+            if (!glyphs) {
+                run->count = 0;
+                return run;
             }
+            run->glyphs = glyphs;
+            run->capacity = needed;
         }
+        
+        run->count = EncodeText(widget->text, widget->text_length, run->glyphs, run->capacity);
+        widget->text_width = TextWidth(run->glyphs, run->count);
     }
-    return NULL;
+    return run;
 }
 
 /**
- * @brief Dispatch an event to a window's callback
+ * @brief Draw the rows of a list that overlap an area
+ * 
+ * @param list The list widget
+ * @param target The drawable holding the list
+ * @param x The x position of the list in target
+ * @param y The y position of the list in target
+ * @param area The area to draw, in list coordinates
  */
-static void DispatchEvent(LG_WindowHandle window, LG_Event* event) {
-    if (window && window->event_callback) {
-        event->window = window;
-        window->event_callback(event, window->user_data);
+static void DrawListRows(LG_WidgetHandle list, Drawable target, int x, int y, LG_Rect area) {
+    WindowData* window_data = (WindowData*)list->window->platform_data;
+    GC gc = window_data->gc;
+    int row_height = ListRowHeight(list);
+    int bottom = 0;  // End of the drawn rows in list coordinates
+    
+    size_t first, end;
+    if (ListRowRange(list, area, &first, &end)) {
+        for (size_t row = first; row < end; row++) {
+            int row_y = ListRowY(list, row);
+            bool selected = ListRowSelected(list, row);
+            const char* text = ListRowText(list, row);
+            
+            XSetForeground(g_display, gc, selected ? ColorToX11Color(LG_CreateColor(0, 120, 215, 255))
+                                                   : ColorToX11Color(list->bg_color));
+            XFillRectangle(g_display, target, gc, x, y + row_y, list->rect.width, row_height);
+            
+            // Rows are short; encode on the stack instead of caching
+            uint32_t glyphs[LG_LIST_ROW_TEXT];
+            int count = EncodeText(text, strlen(text), glyphs, LG_LIST_ROW_TEXT);
+            int text_y = (row_height + g_font.ascent - g_font.descent) / 2;
+            DrawText(window_data, target, x + 5, y + row_y + text_y, glyphs, count,
+                     selected ? LG_COLOR_WHITE : list->text_color);
+            bottom = row_y + row_height;
+        }
+    } else {
+        bottom = area.y;
+    }
+    
+    // Below the last row
+    if (bottom < area.y + area.height && bottom < list->rect.height) {
+        XSetForeground(g_display, gc, ColorToX11Color(list->bg_color));
+        XFillRectangle(g_display, target, gc, x, y + bottom, list->rect.width,
+                       list->rect.height - bottom);
     }
 }
 
 /**
- * @brief Draw a widget
+ * @brief Reallocate a window's back buffer if its size calls for it
  */
-static void DrawWidget(LG_WidgetHandle widget) {
+static void ResizeBackBuffer(LG_WindowHandle window) {
+    WindowData* data = (WindowData*)window->platform_data;
+    int width = window->width;
+    int height = window->height;
+    if (!BackBufferSize(data->buffer_width, data->buffer_height, &width, &height)) {
+        return;
+    }
+
+    XFreePixmap(g_display, data->buffer);
+    data->buffer = XCreatePixmap(g_display, data->window, (unsigned int)width,
+                                 (unsigned int)height, DefaultDepth(g_display, g_screen));
+    data->buffer_width = width;
+    data->buffer_height = height;
+}
+
+/**
+ * @brief Create or resize the back buffer of a native list
+ */
+static void ResizeListBuffer(LG_WidgetHandle widget) {
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    if (data->list_buffer) {
+        XFreePixmap(g_display, data->list_buffer);
+    }
+    
+    data->list_buffer = XCreatePixmap(g_display, data->window,
+                                      widget->rect.width > 0 ? widget->rect.width : 1,
+                                      widget->rect.height > 0 ? widget->rect.height : 1,
+                                      DefaultDepth(g_display, g_screen));
+}
+
+/**
+ * @brief Copy part of a native list's back buffer to its window
+ */
+static void PresentList(LG_WidgetHandle widget, LG_Rect rect) {
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    WindowData* window_data = (WindowData*)widget->window->platform_data;
+    XCopyArea(g_display, data->list_buffer, data->window, window_data->gc,
+              rect.x, rect.y, rect.width, rect.height, rect.x, rect.y);
+}
+
+/**
+ * @brief Draw a widget into a drawable with its top-left corner at (x, y)
+ */
+static void DrawWidgetAt(LG_WidgetHandle widget, Drawable target, int x, int y) {
     if (!widget || !widget->platform_data || !widget->window || !widget->window->platform_data) {
         return;
     }
 
-    WidgetData* widget_data = (WidgetData*)widget->platform_data;
     WindowData* window_data = (WindowData*)widget->window->platform_data;
     
     // Set colors
@@ -129,22 +651,21 @@ static void DrawWidget(LG_WidgetHandle widget) {
         case LG_WIDGET_BUTTON:
             // Draw button background
             XSetForeground(g_display, window_data->gc, ColorToX11Color(widget->bg_color));
-            XFillRectangle(g_display, widget_data->window, window_data->gc, 
-                          0, 0, widget->rect.width, widget->rect.height);
+            XFillRectangle(g_display, target, window_data->gc, 
+                          x, y, widget->rect.width, widget->rect.height);
             
             // Draw button border
             XSetForeground(g_display, window_data->gc, ColorToX11Color(LG_COLOR_BLACK));
-            XDrawRectangle(g_display, widget_data->window, window_data->gc, 
-                          0, 0, widget->rect.width - 1, widget->rect.height - 1);
+            XDrawRectangle(g_display, target, window_data->gc, 
+                          x, y, widget->rect.width - 1, widget->rect.height - 1);
             
             // Draw button text
             if (widget->text) {
-                XSetForeground(g_display, window_data->gc, ColorToX11Color(widget->text_color));
-                int text_width = XTextWidth(window_data->font, widget->text, strlen(widget->text));
-                int text_x = (widget->rect.width - text_width) / 2;
-                int text_y = (widget->rect.height + window_data->font->ascent - window_data->font->descent) / 2;
-                XDrawString(g_display, widget_data->window, window_data->gc, 
-                           text_x, text_y, widget->text, strlen(widget->text));
+                const TextRun* run = WidgetTextRun(widget);
+                int text_x = (widget->rect.width - widget->text_width) / 2;
+                int text_y = (widget->rect.height + g_font.ascent - g_font.descent) / 2;
+                DrawText(window_data, target, x + text_x, y + text_y, run->glyphs, run->count,
+                         widget->text_color);
             }
             break;
             
@@ -152,51 +673,85 @@ static void DrawWidget(LG_WidgetHandle widget) {
             // Draw label background (if not transparent)
             if (widget->bg_color.a > 0) {
                 XSetForeground(g_display, window_data->gc, ColorToX11Color(widget->bg_color));
-                XFillRectangle(g_display, widget_data->window, window_data->gc, 
-                              0, 0, widget->rect.width, widget->rect.height);
+                XFillRectangle(g_display, target, window_data->gc, 
+                              x, y, widget->rect.width, widget->rect.height);
             }
             
             // Draw label text
             if (widget->text) {
-                XSetForeground(g_display, window_data->gc, ColorToX11Color(widget->text_color));
-                int text_y = (widget->rect.height + window_data->font->ascent - window_data->font->descent) / 2;
-                XDrawString(g_display, widget_data->window, window_data->gc, 
-                           5, text_y, widget->text, strlen(widget->text));
+                const TextRun* run = WidgetTextRun(widget);
+                int text_y = (widget->rect.height + g_font.ascent - g_font.descent) / 2;
+                DrawText(window_data, target, x + 5, y + text_y, run->glyphs, run->count,
+                         widget->text_color);
             }
             break;
             
         case LG_WIDGET_TEXTFIELD:
             // Draw text field background
             XSetForeground(g_display, window_data->gc, ColorToX11Color(widget->bg_color));
-            XFillRectangle(g_display, widget_data->window, window_data->gc, 
-                          0, 0, widget->rect.width, widget->rect.height);
+            XFillRectangle(g_display, target, window_data->gc, 
+                          x, y, widget->rect.width, widget->rect.height);
             
             // Draw text field border
             XSetForeground(g_display, window_data->gc, ColorToX11Color(LG_COLOR_BLACK));
-            XDrawRectangle(g_display, widget_data->window, window_data->gc, 
-                          0, 0, widget->rect.width - 1, widget->rect.height - 1);
+            XDrawRectangle(g_display, target, window_data->gc, 
+                          x, y, widget->rect.width - 1, widget->rect.height - 1);
             
             // Draw text field text
             if (widget->text) {
-                XSetForeground(g_display, window_data->gc, ColorToX11Color(widget->text_color));
-                int text_y = (widget->rect.height + window_data->font->ascent - window_data->font->descent) / 2;
-                XDrawString(g_display, widget_data->window, window_data->gc, 
-                           5, text_y, widget->text, strlen(widget->text));
+                const TextRun* run = WidgetTextRun(widget);
+                int text_y = (widget->rect.height + g_font.ascent - g_font.descent) / 2;
+                DrawText(window_data, target, x + 5, y + text_y, run->glyphs, run->count,
+                         widget->text_color);
+            }
+            break;
+            
+        case LG_WIDGET_LIST:
+            {
+                LG_Rect area = {0, 0, widget->rect.width, widget->rect.height};
+                DrawListRows(widget, target, x, y, area);
             }
             break;
             
         default:
             break;
     }
+}
+
+/**
+ * @brief Draw a widget that has its own native window
+ */
+static void DrawWidget(LG_WidgetHandle widget) {
+    if (!widget || !widget->platform_data) {
+        return;
+    }
+
+    WidgetData* widget_data = (WidgetData*)widget->platform_data;
+    if (widget_data->window == None) {
+        return;  // Windowless widgets are drawn by LG_PlatformRenderWindow
+    }
+    
+    if (widget->type == LG_WIDGET_CANVAS) {
+        LG_Rect rect = {0, 0, widget->rect.width, widget->rect.height};
+        PutCanvasImage(widget, rect);
+        return;
+    }
     
-    XFlush(g_display);
+    if (widget->type == LG_WIDGET_LIST) {
+        LG_Rect rect = {0, 0, widget->rect.width, widget->rect.height};
+        DrawListRows(widget, widget_data->list_buffer, 0, 0, rect);
+        PresentList(widget, rect);
+        return;
+    }
+
+    DrawWidgetAt(widget, widget_data->window, 0, 0);
 }
 
 /* ========================================================================= */
 /*                        Platform API Implementation                        */
 /* ========================================================================= */
 
-bool LG_PlatformInitialize(void) {
+static bool X11Initialize(void) {
     // Open display
     g_display = XOpenDisplay(NULL);
     if (!g_display) {
@@ -207,34 +762,59 @@ bool LG_PlatformInitialize(void) {
     // Get default screen
     g_screen = DefaultScreen(g_display);
     
+    // Allocate the handle lookup contexts
+    g_window_context = XUniqueContext();
+    g_widget_context = XUniqueContext();
+    
     // Get WM_DELETE_WINDOW atom
     g_wm_delete_window = XInternAtom(g_display, "WM_DELETE_WINDOW", False);
     
-    // Load default font
-    g_default_font = XLoadQueryFont(g_display, "fixed");
-    if (!g_default_font) {
+    // Load the font shared by all windows
+    if (!OpenSharedFont()) {
         fprintf(stderr, "LightGUI: Failed to load default font\n");
         XCloseDisplay(g_display);
         g_display = NULL;
         return false;
     }
     
+#ifdef LG_HAVE_XSHM
+    // Canvases fall back to XPutImage without MIT-SHM
+    g_have_shm = XShmQueryExtension(g_display) == True;
+    if (g_have_shm) {
+        g_shm_completion_event = XShmGetEventBase(g_display) + ShmCompletion;
+    }
+#endif
+    
+    // Create the wakeup pipe; without it waits can only end on input or timeout
+    if (pipe(g_wake_pipe) == 0) {
+        for (int i = 0; i < 2; i++) {
+            fcntl(g_wake_pipe[i], F_SETFL, fcntl(g_wake_pipe[i], F_GETFL) | O_NONBLOCK);
+            fcntl(g_wake_pipe[i], F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        fprintf(stderr, "LightGUI: Failed to create wakeup pipe\n");
+        g_wake_pipe[0] = g_wake_pipe[1] = -1;
+    }
+    
     return true;
 }
 
-void LG_PlatformTerminate(void) {
-    if (g_default_font) {
-        XFreeFont(g_display, g_default_font);
-        g_default_font = NULL;
+static void X11Terminate(void) {
+    for (int i = 0; i < 2; i++) {
+        if (g_wake_pipe[i] >= 0) {
+            close(g_wake_pipe[i]);
+            g_wake_pipe[i] = -1;
+        }
     }
     
     if (g_display) {
+        CloseSharedFont();
         XCloseDisplay(g_display);
         g_display = NULL;
     }
 }
 
-bool LG_PlatformCreateWindow(LG_WindowHandle window) {
+static bool X11CreateWindow(LG_WindowHandle window) {
     if (!window) return false;
     
     // Allocate platform-specific data
@@ -287,11 +867,9 @@ bool LG_PlatformCreateWindow(LG_WindowHandle window) {
     }
     
     // Set font
-    data->font = XLoadQueryFont(g_display, "fixed");
-    if (!data->font) {
-        data->font = g_default_font;
+    if (g_font.core) {
+        XSetFont(g_display, data->gc, g_font.core->fid);
     }
-    XSetFont(g_display, data->gc, data->font->fid);
     
     // Create buffer for double buffering
     data->buffer = XCreatePixmap(
@@ -309,74 +887,172 @@ bool LG_PlatformCreateWindow(LG_WindowHandle window) {
         free(data);
         return false;
     }
+    data->buffer_width = window->width;
+    data->buffer_height = window->height;
+    
+#ifdef LG_HAVE_XFT
+    data->xft_draw = NULL;
+    if (g_font.xft) {
+        data->xft_draw = XftDrawCreate(g_display, data->buffer, DefaultVisual(g_display, g_screen),
+                                       DefaultColormap(g_display, g_screen));
+        if (!data->xft_draw) {
+            fprintf(stderr, "LightGUI: Failed to create Xft draw\n");
+            XFreePixmap(g_display, data->buffer);
+            XFreeGC(g_display, data->gc);
+            XDestroyWindow(g_display, data->window);
+            free(data);
+            return false;
+        }
+    }
+#endif
     
     // Store platform data in window
     window->platform_data = data;
+    XSaveContext(g_display, data->window, g_window_context, (XPointer)window);
     
     return true;
 }
 
-void LG_PlatformDestroyWindow(LG_WindowHandle window) {
+static void X11DestroyWindow(LG_WindowHandle window) {
     if (!window || !window->platform_data) return;
     
     WindowData* data = (WindowData*)window->platform_data;
     
     // Free resources
-    XFreePixmap(g_display, data->buffer);
-    
-    if (data->font != g_default_font) {
-        XFreeFont(g_display, data->font);
+#ifdef LG_HAVE_XFT
+    if (data->xft_draw) {
+        XftDrawDestroy(data->xft_draw);
     }
-    
+#endif
+    XFreePixmap(g_display, data->buffer);
     XFreeGC(g_display, data->gc);
+    XDeleteContext(g_display, data->window, g_window_context);
     XDestroyWindow(g_display, data->window);
     
     free(data);
     window->platform_data = NULL;
 }
 
-void LG_PlatformShowWindow(LG_WindowHandle window) {
+static void X11ShowWindow(LG_WindowHandle window) {
     if (!window || !window->platform_data) return;
     
     WindowData* data = (WindowData*)window->platform_data;
     XMapWindow(g_display, data->window);
-    XFlush(g_display);
 }
 
-void LG_PlatformHideWindow(LG_WindowHandle window) {
+static void X11HideWindow(LG_WindowHandle window) {
     if (!window || !window->platform_data) return;
     
     WindowData* data = (WindowData*)window->platform_data;
     XUnmapWindow(g_display, data->window);
-    XFlush(g_display);
 }
 
-void LG_PlatformSetWindowTitle(LG_WindowHandle window, const char* title) {
+static void X11SetWindowTitle(LG_WindowHandle window, const char* title) {
     if (!window || !window->platform_data || !title) return;
     
     WindowData* data = (WindowData*)window->platform_data;
     XStoreName(g_display, data->window, title);
-    XFlush(g_display);
 }
 
-bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
+#ifdef LG_HAVE_GLX
+typedef void (*SwapIntervalEXTProc)(Display* display, GLXDrawable drawable, int interval);
+typedef int (*SwapIntervalMESAProc)(unsigned int interval);
+
+/**
+ * @brief Pick a double-buffered true color visual with a depth buffer
+ */
+static XVisualInfo* ChooseGLVisual(void) {
+    int attributes[] = {
+        GLX_RGBA, GLX_DOUBLEBUFFER,
+        GLX_RED_SIZE, 8, GLX_GREEN_SIZE, 8, GLX_BLUE_SIZE, 8,
+        GLX_DEPTH_SIZE, 24,
+        None
+    };
+    return glXChooseVisual(g_display, g_screen, attributes);
+}
+
+/**
+ * @brief Check for a whole name in the GLX extension string
+ */
+static bool HasGLXExtension(const char* name) {
+    const char* extensions = glXQueryExtensionsString(g_display, g_screen);
+    size_t length = strlen(name);
+    for (const char* p = extensions; p && (p = strstr(p, name)) != NULL; p += length) {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+static bool X11CreateWidget(LG_WidgetHandle widget) {
     if (!widget || !widget->window || !widget->window->platform_data) return false;
     
     WindowData* window_data = (WindowData*)widget->window->platform_data;
     
     // Allocate platform-specific data
-    WidgetData* data = (WidgetData*)malloc(sizeof(WidgetData));
+    WidgetData* data = (WidgetData*)AllocWidgetData(widget->window, sizeof(WidgetData));
     if (!data) {
         fprintf(stderr, "LightGUI: Failed to allocate widget data\n");
         return false;
     }
     
+    // Windowless widgets are drawn into the window's back buffer
+    if (widget->windowless) {
+        data->window = None;
+        data->type = widget->type;
+        widget->platform_data = data;
+        return true;
+    }
+    
     // Create X window for widget
     XSetWindowAttributes attr;
     attr.background_pixel = ColorToX11Color(widget->bg_color);
     attr.border_pixel = BlackPixel(g_display, g_screen);
     attr.event_mask = ExposureMask | ButtonPressMask | ButtonReleaseMask |
                       KeyPressMask | KeyReleaseMask | PointerMotionMask;
+    attr.background_pixmap = None;
+    unsigned long value_mask = CWBackPixel | CWBorderPixel | CWEventMask;
+    int depth = DefaultDepth(g_display, g_screen);
+    Visual* visual = DefaultVisual(g_display, g_screen);
+#ifdef LG_HAVE_GLX
+    XVisualInfo* gl_visual = NULL;
+#endif
+    
+    if (widget->type == LG_WIDGET_CANVAS && widget->gl) {
+#ifdef LG_HAVE_GLX
+        gl_visual = ChooseGLVisual();
+        if (!gl_visual) {
+            fprintf(stderr, "LightGUI: No double-buffered OpenGL visual\n");
+            FreeWidgetData(widget->window, data);
+            return false;
+        }
+        
+        // The context's visual may differ from the parent's, so it needs its own colormap
+        data->gl_colormap = XCreateColormap(g_display, RootWindow(g_display, g_screen),
+                                            gl_visual->visual, AllocNone);
+        attr.colormap = data->gl_colormap;
+        attr.event_mask = ExposureMask;
+        value_mask = CWBackPixmap | CWBorderPixel | CWEventMask | CWColormap;
+        depth = gl_visual->depth;
+        visual = gl_visual->visual;
+#endif
+    } else if (widget->type == LG_WIDGET_CANVAS) {
+        if (!CreateCanvasImage(&data->canvas, widget->rect.width, widget->rect.height)) {
+            fprintf(stderr, "LightGUI: Failed to create canvas buffer\n");
+            FreeWidgetData(widget->window, data);
+            return false;
+        }
+        
+        // Every pixel comes from the buffer, so skip the background clear.
+        // Pointer events propagate to the parent in window coordinates.
+        attr.event_mask = ExposureMask;
+        value_mask = CWBackPixmap | CWBorderPixel | CWEventMask;
+    } else if (widget->type == LG_WIDGET_LIST) {
+        // Exposures are repaired from the back buffer
+        value_mask = CWBackPixmap | CWBorderPixel | CWEventMask;
+    }
     
     data->window = XCreateWindow(
         g_display,                  // Display
@@ -384,16 +1060,34 @@ bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
         widget->rect.x, widget->rect.y, // Position
         widget->rect.width, widget->rect.height, // Size
         0,                          // Border width
-        DefaultDepth(g_display, g_screen), // Depth
+        depth,                      // Depth
         InputOutput,                // Class
-        DefaultVisual(g_display, g_screen), // Visual
-        CWBackPixel | CWBorderPixel | CWEventMask, // Value mask
+        visual,                     // Visual
+        value_mask,                 // Value mask
         &attr                       // Attributes
     );
     
+#ifdef LG_HAVE_GLX
+    if (gl_visual) {
+        if (data->window) {
+            data->gl_context = glXCreateContext(g_display, gl_visual, NULL, True);
+            if (!data->gl_context) {
+                fprintf(stderr, "LightGUI: Failed to create OpenGL context\n");
+                XDestroyWindow(g_display, data->window);
+                data->window = None;
+            }
+        }
+        XFree(gl_visual);
+        if (!data->window) {
+            XFreeColormap(g_display, data->gl_colormap);
+        }
+    }
+#endif
+    
     if (!data->window) {
         fprintf(stderr, "LightGUI: Failed to create widget window\n");
-        free(data);
+        DestroyCanvasImage(&data->canvas);
+        FreeWidgetData(widget->window, data);
         return false;
     }
     
@@ -402,6 +1096,11 @@ bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
     
     // Store platform data in widget
     widget->platform_data = data;
+    XSaveContext(g_display, data->window, g_widget_context, (XPointer)widget);
+    
+    if (widget->type == LG_WIDGET_LIST) {
+        ResizeListBuffer(widget);
+    }
     
     // Map widget window
     if (widget->visible) {
@@ -411,47 +1110,108 @@ bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
     // Draw widget
     DrawWidget(widget);
     
-    XFlush(g_display);
-    
     return true;
 }
 
-void LG_PlatformDestroyWidget(LG_WidgetHandle widget) {
+static void X11DestroyWidget(LG_WidgetHandle widget) {
     if (!widget || !widget->platform_data) return;
     
     WidgetData* data = (WidgetData*)widget->platform_data;
     
+#ifdef LG_HAVE_XFT
+    // The server frees a window's pictures with it, so Xft must not hold one
+    WindowData* window_data = widget->window ? (WindowData*)widget->window->platform_data : NULL;
+    if (window_data && window_data->xft_draw) {
+        Drawable drawable = XftDrawDrawable(window_data->xft_draw);
+        if (drawable != None && (drawable == data->window || drawable == data->list_buffer)) {
+            XftDrawChange(window_data->xft_draw, window_data->buffer);
+        }
+    }
+#endif
+    
+#ifdef LG_HAVE_GLX
+    if (data->gl_context) {
+        if (glXGetCurrentContext() == data->gl_context) {
+            glXMakeCurrent(g_display, None, NULL);
+        }
+        glXDestroyContext(g_display, data->gl_context);
+    }
+#endif
+    
     // Destroy widget window
-    XDestroyWindow(g_display, data->window);
+    if (data->window != None) {
+        WaitForCanvasPut(data);
+        XDeleteContext(g_display, data->window, g_widget_context);
+        XDestroyWindow(g_display, data->window);
+    }
     
-    free(data);
+#ifdef LG_HAVE_GLX
+    if (data->gl_colormap) {
+        XFreeColormap(g_display, data->gl_colormap);
+    }
+#endif
+    
+    if (data->list_buffer) {
+        XFreePixmap(g_display, data->list_buffer);
+    }
+    
+    DestroyCanvasImage(&data->canvas);
+    free(data->text.glyphs);
+    FreeWidgetData(widget->window, data);
     widget->platform_data = NULL;
 }
 
-void LG_PlatformUpdateWidget(LG_WidgetHandle widget) {
+static void X11UpdateWidget(LG_WidgetHandle widget) {
     if (!widget || !widget->platform_data) return;
     
     WidgetData* data = (WidgetData*)widget->platform_data;
+    unsigned int dirty = widget->dirty;
+    
+    // Windowless widgets are repainted through the window's damage region
+    if (data->window == None || dirty == 0) return;
     
     // Update position and size
-    XMoveResizeWindow(g_display, data->window, 
-                     widget->rect.x, widget->rect.y, 
-                     widget->rect.width, widget->rect.height);
+    if (dirty & LG_WIDGET_DIRTY_GEOMETRY) {
+        XMoveResizeWindow(g_display, data->window, 
+                         widget->rect.x, widget->rect.y, 
+                         widget->rect.width, widget->rect.height);
+        if (widget->type == LG_WIDGET_CANVAS && !widget->gl) {
+            ResizeCanvasImage(widget);
+        } else if (widget->type == LG_WIDGET_LIST) {
+            ResizeListBuffer(widget);
+        }
+    }
     
     // Update visibility
-    if (widget->visible) {
-        XMapWindow(g_display, data->window);
-    } else {
-        XUnmapWindow(g_display, data->window);
+    if (dirty & LG_WIDGET_DIRTY_VISIBILITY) {
+        if (widget->visible) {
+            XMapWindow(g_display, data->window);
+        } else {
+            XUnmapWindow(g_display, data->window);
+        }
     }
     
-    // Redraw widget
-    DrawWidget(widget);
+    // Keep the background used for exposures in sync
+    if ((dirty & LG_WIDGET_DIRTY_COLOR) && widget->type != LG_WIDGET_CANVAS) {
+        XSetWindowBackground(g_display, data->window, ColorToX11Color(widget->bg_color));
+    }
     
-    XFlush(g_display);
+    // Redraw widget
+    if (widget->visible && (dirty & (LG_WIDGET_DIRTY_TEXT | LG_WIDGET_DIRTY_GEOMETRY |
+                                     LG_WIDGET_DIRTY_ENABLED | LG_WIDGET_DIRTY_COLOR |
+                                     LG_WIDGET_DIRTY_VISIBILITY))) {
+        DrawWidget(widget);
+    }
+}
+
+static void X11UpdateWidgets(LG_WidgetHandle* widgets, size_t count) {
+    // Requests are buffered until the end of the frame, so no flush here
+    for (size_t i = 0; i < count; i++) {
+        X11UpdateWidget(widgets[i]);
+    }
 }
 
-bool LG_PlatformProcessEvents(void) {
+static bool X11ProcessEvents(void) {
     if (!g_display) return false;
     
     // Process all pending events
@@ -475,43 +1235,65 @@ bool LG_PlatformProcessEvents(void) {
         
         if (!window) continue;
         
+#ifdef LG_HAVE_XSHM
+        if (event.type == g_shm_completion_event) {
+            if (widget && widget->platform_data) {
+                WidgetData* data = (WidgetData*)widget->platform_data;
+                if (data->canvas.puts_pending > 0) {
+                    data->canvas.puts_pending--;
+                }
+            }
+            continue;
+        }
+#endif
+        
         // Process event
         switch (event.type) {
             case Expose:
-                if (widget) {
+                if (widget && widget->type == LG_WIDGET_CANVAS) {
+                    LG_Rect exposed = {
+                        event.xexpose.x, event.xexpose.y,
+                        event.xexpose.width, event.xexpose.height
+                    };
+                    PutCanvasImage(widget, exposed);
+                } else if (widget && widget->type == LG_WIDGET_LIST) {
+                    LG_Rect exposed = {
+                        event.xexpose.x, event.xexpose.y,
+                        event.xexpose.width, event.xexpose.height
+                    };
+                    PresentList(widget, exposed);
+                } else if (widget) {
                     DrawWidget(widget);
                 } else {
-                    LG_PlatformRenderWindow(window);
+                    LG_Rect exposed = {
+                        event.xexpose.x, event.xexpose.y,
+                        event.xexpose.width, event.xexpose.height
+                    };
+                    DamageWindowRect(window, exposed);
                 }
                 break;
                 
             case ConfigureNotify:
+                // Moves and restacking arrive here too; the core drops unchanged sizes
+                // and reports the last size of a drag once per frame
                 if (!widget) {
-                    window->width = event.xconfigure.width;
-                    window->height = event.xconfigure.height;
-                    
-                    // Resize buffer
-                    WindowData* data = (WindowData*)window->platform_data;
-                    XFreePixmap(g_display, data->buffer);
-                    data->buffer = XCreatePixmap(
-                        g_display,
-                        data->window,
-                        window->width,
-                        window->height,
-                        DefaultDepth(g_display, g_screen)
-                    );
-                    
-                    // Dispatch resize event
-                    LG_Event lg_event;
-                    lg_event.type = LG_EVENT_WINDOW_RESIZE;
-                    lg_event.data.window_resize.width = window->width;
-                    lg_event.data.window_resize.height = window->height;
-                    DispatchEvent(window, &lg_event);
+                    DispatchWindowResize(window, event.xconfigure.width, event.xconfigure.height);
+                    ResizeBackBuffer(window);
                 }
                 break;
                 
             case ButtonPress:
             case ButtonRelease:
+                // The wheel arrives as buttons 4 and 5
+                if (event.xbutton.button == Button4 || event.xbutton.button == Button5) {
+                    LG_WidgetHandle target = widget ? widget
+                                                    : HitTestWidget(window, event.xbutton.x, event.xbutton.y);
+                    if (event.type == ButtonPress && target && target->type == LG_WIDGET_LIST) {
+                        ListScrollBy(target, event.xbutton.button == Button4 ? -LG_LIST_WHEEL_ROWS
+                                                                             : LG_LIST_WHEEL_ROWS);
+                    }
+                    break;
+                }
                 {
                     LG_Event lg_event;
                     lg_event.type = LG_EVENT_MOUSE_BUTTON;
@@ -533,36 +1315,47 @@ bool LG_PlatformProcessEvents(void) {
                             continue;  // Ignore other buttons
                     }
                     
+                    // Clicks on the window itself may land on a windowless widget
+                    int widget_x = event.xbutton.x;
+                    int widget_y = event.xbutton.y;
+                    if (!widget) {
+                        widget = HitTestWidget(window, event.xbutton.x, event.xbutton.y);
+                        if (widget) {
+                            widget_x -= widget->rect.x;
+                            widget_y -= widget->rect.y;
+                        }
+                    }
+                    
                     // If this is a button click on a widget, dispatch a widget clicked event
                     if (widget && event.type == ButtonPress && 
                         lg_event.data.mouse_button.button == LG_MOUSE_BUTTON_LEFT) {
+                        if (widget->type == LG_WIDGET_LIST) {
+                            ListClick(widget, widget_y);
+                        }
+                        
                         LG_Event widget_event;
                         widget_event.type = LG_EVENT_WIDGET_CLICKED;
                         widget_event.data.widget_clicked.widget = widget;
-                        widget_event.data.widget_clicked.x = event.xbutton.x;
-                        widget_event.data.widget_clicked.y = event.xbutton.y;
-                        DispatchEvent(window, &widget_event);
+                        widget_event.data.widget_clicked.x = widget_x;
+                        widget_event.data.widget_clicked.y = widget_y;
+                        DispatchWindowEvent(window, &widget_event);
                     }
                     
-                    DispatchEvent(window, &lg_event);
+                    DispatchWindowEvent(window, &lg_event);
                 }
                 break;
                 
             case MotionNotify:
                 {
-                    LG_Event lg_event;
-                    lg_event.type = LG_EVENT_MOUSE_MOVE;
-                    lg_event.data.mouse_move.x = event.xmotion.x;
-                    lg_event.data.mouse_move.y = event.xmotion.y;
-                    
-                    // Calculate delta (this is simplified)
-                    static int last_x = 0, last_y = 0;
-                    lg_event.data.mouse_move.delta_x = lg_event.data.mouse_move.x - last_x;
-                    lg_event.data.mouse_move.delta_y = lg_event.data.mouse_move.y - last_y;
-                    last_x = lg_event.data.mouse_move.x;
-                    last_y = lg_event.data.mouse_move.y;
+                    // Motion over a native child widget is relative to the widget
+                    int x = event.xmotion.x;
+                    int y = event.xmotion.y;
+                    if (widget) {
+                        x += widget->rect.x;
+                        y += widget->rect.y;
+                    }
                     
-                    DispatchEvent(window, &lg_event);
+                    DispatchMouseMotion(window, x, y);
                 }
                 break;
                 
@@ -579,7 +1372,7 @@ bool LG_PlatformProcessEvents(void) {
                     lg_event.data.key.shift = (event.xkey.state & ShiftMask) != 0;
                     lg_event.data.key.alt = (event.xkey.state & Mod1Mask) != 0;
                     
-                    DispatchEvent(window, &lg_event);
+                    DispatchWindowEvent(window, &lg_event);
                 }
                 break;
                 
@@ -587,7 +1380,7 @@ bool LG_PlatformProcessEvents(void) {
                 if (event.xclient.data.l[0] == g_wm_delete_window) {
                     LG_Event lg_event;
                     lg_event.type = LG_EVENT_WINDOW_CLOSE;
-                    DispatchEvent(window, &lg_event);
+                    DispatchWindowEvent(window, &lg_event);
                 }
                 break;
         }
@@ -596,20 +1389,399 @@ bool LG_PlatformProcessEvents(void) {
     return true;
 }
 
-void LG_PlatformRenderWindow(LG_WindowHandle window) {
+static bool X11WaitEvents(int timeout_ms, const LG_WaitHandle* handles, size_t handle_count) {
+    if (!g_display) return false;
+    
+    // Events already read into Xlib's queue never show up on the socket,
+    // so check the queue first (this also flushes pending requests)
+    if (XPending(g_display)) {
+        return true;
+    }
+    
+    struct pollfd fds[2 + LG_MAX_WAIT_HANDLES];
+    nfds_t nfds = 0;
+    
+    fds[nfds].fd = ConnectionNumber(g_display);
+    fds[nfds].events = POLLIN;
+    fds[nfds].revents = 0;
+    nfds++;
+    
+    nfds_t wake = nfds;
+    if (g_wake_pipe[0] >= 0) {
+        fds[nfds].fd = g_wake_pipe[0];
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        nfds++;
+    }
+    
+    // Child process pipes; POLLHUP is reported whether asked for or not
+    for (size_t i = 0; i < handle_count; i++) {
+        fds[nfds].fd = handles[i];
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        nfds++;
+    }
+    
+    if (poll(fds, nfds, timeout_ms) <= 0) {
+        return false;  // Timeout or interrupted by a signal
+    }
+    
+    // Drain the wakeup pipe so the next wait blocks again
+    if (g_wake_pipe[0] >= 0 && (fds[wake].revents & POLLIN)) {
+        char drain[64];
+        while (read(g_wake_pipe[0], drain, sizeof(drain)) > 0) {
+        }
+    }
+    
+    return true;
+}
+
+static void X11Wakeup(void) {
+    if (g_wake_pipe[1] < 0) return;
+    
+    // A full pipe already guarantees a wakeup, so a failed write is harmless
+    char byte = 1;
+    ssize_t written = write(g_wake_pipe[1], &byte, 1);
+    (void)written;
+}
+
+static uint64_t X11GetTime(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+static bool X11GetVBlankTiming(uint64_t* last_vblank, uint64_t* interval) {
+    // Core X11 has no vblank timing; LG_Run paces frames by LG_SetFrameRate
+    (void)last_vblank;
+    (void)interval;
+    return false;
+}
+
+static void X11RenderWindow(LG_WindowHandle window) {
     if (!window || !window->platform_data) return;
     
     WindowData* data = (WindowData*)window->platform_data;
+    const LG_DamageRegion* damage = &window->damage;
+    
+    if (damage->count == 0) return;
+    
+    XRectangle clip[LG_MAX_DAMAGE_RECTS];
+    for (int i = 0; i < damage->count; i++) {
+        clip[i].x = (short)damage->rects[i].x;
+        clip[i].y = (short)damage->rects[i].y;
+        clip[i].width = (unsigned short)damage->rects[i].width;
+        clip[i].height = (unsigned short)damage->rects[i].height;
+    }
     
-    // Clear buffer
+    // Clear only the damaged parts of the buffer
     XSetForeground(g_display, data->gc, WhitePixel(g_display, g_screen));
-    XFillRectangle(g_display, data->buffer, data->gc, 0, 0, window->width, window->height);
+    XFillRectangles(g_display, data->buffer, data->gc, clip, damage->count);
     
-    // Copy buffer to window
-    XCopyArea(g_display, data->buffer, data->window, data->gc, 
-             0, 0, window->width, window->height, 0, 0);
+    // Draw windowless widgets that overlap the damage, clipped to it
+    XSetClipRectangles(g_display, data->gc, 0, 0, clip, damage->count, Unsorted);
+#ifdef LG_HAVE_XFT
+    if (data->xft_draw) {
+        if (XftDrawDrawable(data->xft_draw) != data->buffer) {
+            XftDrawChange(data->xft_draw, data->buffer);
+        }
+        XftDrawSetClipRectangles(data->xft_draw, 0, 0, clip, damage->count);
+    }
+#endif
+    LG_WidgetHandle* overlapping;
+    size_t overlapping_count = SpatialQuery(window, damage->rects, damage->count, &overlapping);
+    for (size_t i = 0; i < overlapping_count; i++) {
+        LG_WidgetHandle widget = overlapping[i];
+        if (widget->windowless && widget->visible) {
+            DrawWidgetAt(widget, data->buffer, widget->rect.x, widget->rect.y);
+        }
+    }
+    XSetClipMask(g_display, data->gc, None);
+#ifdef LG_HAVE_XFT
+    if (data->xft_draw) {
+        XftDrawSetClip(data->xft_draw, NULL);
+    }
+#endif
     
-    XFlush(g_display);
+    // Present the damaged parts
+    for (int i = 0; i < damage->count; i++) {
+        const LG_Rect* rect = &damage->rects[i];
+        XCopyArea(g_display, data->buffer, data->window, data->gc,
+                 rect->x, rect->y, rect->width, rect->height, rect->x, rect->y);
+    }
 }
 
-#endif /* __linux__ */ 
\ No newline at end of file
+static void* X11GetNativeHandle(LG_WidgetHandle widget) {
+    if (!widget || !widget->platform_data) return NULL;
+    
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    return (void*)(uintptr_t)data->window;
+}
+
+static bool X11GetCanvasBuffer(LG_WidgetHandle canvas, LG_CanvasBuffer* buffer) {
+    if (!canvas || !canvas->platform_data || !buffer) return false;
+    
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    XImage* image = data->canvas.image;
+    if (!image) return false;
+    
+    // Writing while the server still reads a shared image would tear
+    WaitForCanvasPut(data);
+    
+    buffer->pixels = (uint32_t*)image->data;
+    buffer->width = image->width;
+    buffer->height = image->height;
+    buffer->stride = image->bytes_per_line / 4;
+    return true;
+}
+
+static void X11PresentCanvas(LG_WidgetHandle canvas, LG_Rect rect) {
+    if (!canvas || !canvas->platform_data) return;
+    
+    // Sent with the next flush at the end of the loop iteration
+    PutCanvasImage(canvas, rect);
+}
+
+static void X11RedrawList(LG_WidgetHandle list, LG_Rect rect) {
+    if (!list || !list->platform_data) return;
+    
+    WidgetData* data = (WidgetData*)list->platform_data;
+    if (!data->list_buffer) return;
+    
+    DrawListRows(list, data->list_buffer, 0, 0, rect);
+    PresentList(list, rect);
+}
+
+static void X11ScrollList(LG_WidgetHandle list, int dy) {
+    if (!list || !list->platform_data) return;
+    
+    WidgetData* data = (WidgetData*)list->platform_data;
+    WindowData* window_data = (WindowData*)list->window->platform_data;
+    if (!data->list_buffer) return;
+    
+    // Move the rows that stay visible within the back buffer
+    int width = list->rect.width;
+    int height = list->rect.height;
+    int kept = height - (dy < 0 ? -dy : dy);
+    LG_Rect strip = {0, dy < 0 ? kept : 0, width, height - kept};
+    XCopyArea(g_display, data->list_buffer, data->list_buffer, window_data->gc,
+              0, dy < 0 ? -dy : 0, width, kept, 0, dy < 0 ? 0 : dy);
+    
+    DrawListRows(list, data->list_buffer, 0, 0, strip);
+    LG_Rect all = {0, 0, width, height};
+    PresentList(list, all);
+}
+
+/**
+ * @brief Copy an atlas image read back from the server into atlas->coverage
+ */
+static bool CopyGlyphCoverage(LG_GlyphAtlas* atlas, XImage* image, int width, int height) {
+    atlas->stride = width;
+    atlas->coverage = (uint8_t*)malloc((size_t)width * height);
+    if (atlas->coverage) {
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                // Core fonts are bitmaps, so their coverage is all or nothing
+                unsigned long pixel = XGetPixel(image, x, y);
+                atlas->coverage[(size_t)y * width + x] = image->depth == 1 ? (pixel ? 255 : 0)
+                                                                           : (uint8_t)pixel;
+            }
+        }
+    }
+    XDestroyImage(image);
+    return atlas->coverage != NULL;
+}
+
+#ifdef LG_HAVE_XFT
+static bool BuildXftGlyphAtlas(LG_GlyphAtlas* atlas) {
+    FT_UInt glyphs[LG_GLYPH_COUNT];
+    int left = 0;
+    int right = 1;
+    for (int i = 0; i < LG_GLYPH_COUNT; i++) {
+        glyphs[i] = XftCharIndex(g_display, g_font.xft, (FcChar32)(LG_GLYPH_FIRST + i));
+        XGlyphInfo info;
+        XftGlyphExtents(g_display, g_font.xft, &glyphs[i], 1, &info);
+        atlas->advance[i] = info.xOff;
+        
+        // x is how far the glyph's bitmap starts left of the pen
+        if (info.x > left) left = info.x;
+        if (info.width - info.x > right) right = info.width - info.x;
+        if (info.xOff > right) right = info.xOff;
+    }
+    
+    atlas->ascent = g_font.ascent;
+    atlas->descent = g_font.descent;
+    atlas->origin_x = left;
+    atlas->cell_width = left + right;
+    
+    int width = atlas->cell_width * LG_GLYPH_COUNT;
+    int height = atlas->ascent + atlas->descent;
+    if (height <= 0) return false;
+    
+    // Antialiased glyphs drawn into an alpha-only pixmap are their own coverage
+    Pixmap pixmap = XCreatePixmap(g_display, RootWindow(g_display, g_screen), width, height, 8);
+    XftDraw* draw = XftDrawCreateAlpha(g_display, pixmap, 8);
+    if (!draw) {
+        XFreePixmap(g_display, pixmap);
+        return false;
+    }
+    
+    XftColor clear;
+    memset(&clear, 0, sizeof(clear));
+    XftColor ink = clear;
+    ink.color.alpha = 0xFFFF;
+    XftDrawRect(draw, &clear, 0, 0, (unsigned int)width, (unsigned int)height);
+    for (int i = 0; i < LG_GLYPH_COUNT; i++) {
+        XftDrawGlyphs(draw, &ink, g_font.xft, i * atlas->cell_width + atlas->origin_x,
+                      atlas->ascent, &glyphs[i], 1);
+    }
+    XftDrawDestroy(draw);
+    
+    XImage* image = XGetImage(g_display, pixmap, 0, 0, width, height, AllPlanes, ZPixmap);
+    XFreePixmap(g_display, pixmap);
+    if (!image) return false;
+    
+    return CopyGlyphCoverage(atlas, image, width, height);
+}
+#endif
+
+static bool X11BuildGlyphAtlas(LG_GlyphAtlas* atlas) {
+    if (!g_display) return false;
+    
+#ifdef LG_HAVE_XFT
+    if (g_font.xft) {
+        return BuildXftGlyphAtlas(atlas);
+    }
+#endif
+    
+    XFontStruct* font = g_font.core;
+    if (!font) return false;
+    
+    atlas->ascent = font->ascent;
+    atlas->descent = font->descent;
+    atlas->origin_x = font->min_bounds.lbearing < 0 ? -font->min_bounds.lbearing : 0;
+    int right = font->max_bounds.rbearing > font->max_bounds.width ? font->max_bounds.rbearing
+                                                                   : font->max_bounds.width;
+    atlas->cell_width = atlas->origin_x + (right > 0 ? right : 1);
+    
+    int width = atlas->cell_width * LG_GLYPH_COUNT;
+    int height = atlas->ascent + atlas->descent;
+    if (height <= 0) return false;
+    
+    // Draw every glyph into a bitmap once and read it back in one request
+    Pixmap pixmap = XCreatePixmap(g_display, RootWindow(g_display, g_screen), width, height, 1);
+    GC gc = XCreateGC(g_display, pixmap, 0, NULL);
+    XSetFont(g_display, gc, font->fid);
+    XSetForeground(g_display, gc, 0);
+    XFillRectangle(g_display, pixmap, gc, 0, 0, width, height);
+    XSetForeground(g_display, gc, 1);
+    
+    for (int i = 0; i < LG_GLYPH_COUNT; i++) {
+        char c = (char)(LG_GLYPH_FIRST + i);
+        atlas->advance[i] = XTextWidth(font, &c, 1);
+        XDrawString(g_display, pixmap, gc, i * atlas->cell_width + atlas->origin_x,
+                    atlas->ascent, &c, 1);
+    }
+    
+    XImage* image = XGetImage(g_display, pixmap, 0, 0, width, height, 1, ZPixmap);
+    XFreeGC(g_display, gc);
+    XFreePixmap(g_display, pixmap);
+    if (!image) return false;
+    
+    return CopyGlyphCoverage(atlas, image, width, height);
+}
+
+static void X11Flush(void) {
+    if (g_display) {
+        XFlush(g_display);
+    }
+}
+
+#ifdef LG_HAVE_GLX
+static bool X11GLMakeCurrent(LG_WidgetHandle canvas) {
+    if (!canvas || !canvas->platform_data) return false;
+    
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    if (!data->gl_context) return false;
+    
+    return glXMakeCurrent(g_display, data->window, data->gl_context) == True;
+}
+
+static void X11GLSwapBuffers(LG_WidgetHandle canvas) {
+    if (!canvas || !canvas->platform_data) return;
+    
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    if (data->gl_context) {
+        glXSwapBuffers(g_display, data->window);
+    }
+}
+
+static bool X11GLSetSwapInterval(LG_WidgetHandle canvas, int interval) {
+    if (!canvas || !canvas->platform_data) return false;
+    
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    
+    // The EXT version sets it per window, the MESA one for the current context
+    if (HasGLXExtension("GLX_EXT_swap_control")) {
+        SwapIntervalEXTProc swap_interval =
+            (SwapIntervalEXTProc)glXGetProcAddressARB((const GLubyte*)"glXSwapIntervalEXT");
+        if (swap_interval) {
+            swap_interval(g_display, data->window, interval);
+            return true;
+        }
+    }
+    if (HasGLXExtension("GLX_MESA_swap_control")) {
+        SwapIntervalMESAProc swap_interval =
+            (SwapIntervalMESAProc)glXGetProcAddressARB((const GLubyte*)"glXSwapIntervalMESA");
+        return swap_interval && swap_interval((unsigned int)interval) == 0;
+    }
+    return false;
+}
+#endif
+
+/* ========================================================================= */
+/*                        Backend Table                                      */
+/* ========================================================================= */
+
+const LG_PlatformBackend g_native_backend = {
+    "x11",
+    X11Initialize,
+    X11Terminate,
+    X11CreateWindow,
+    X11DestroyWindow,
+    X11ShowWindow,
+    X11HideWindow,
+    X11SetWindowTitle,
+    X11CreateWidget,
+    X11DestroyWidget,
+    X11UpdateWidget,
+    X11UpdateWidgets,
+    X11ProcessEvents,
+    X11WaitEvents,
+    X11Wakeup,
+    X11GetTime,
+    X11GetVBlankTiming,
+    X11RenderWindow,
+    X11GetNativeHandle,
+    X11GetCanvasBuffer,
+    X11PresentCanvas,
+    X11RedrawList,
+    X11ScrollList,
+    X11BuildGlyphAtlas,
+    X11Flush,
+    NULL,  // inject_event
+    NULL,  // get_window_frame
+    NULL,  // rasterize_window: drawing goes through the display connection
+    NULL,  // wait_for_vblank
+#ifdef LG_HAVE_GLX
+    X11GLMakeCurrent,
+    X11GLSwapBuffers,
+    X11GLSetSwapInterval
+#else
+    NULL,  // gl_make_current: built without GLX
+    NULL,  // gl_swap_buffers
+    NULL   // gl_set_swap_interval
+#endif
+};
+
+#endif /* __linux__ */
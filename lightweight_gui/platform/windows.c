@@ -5,17 +5,20 @@
 
 #ifdef _WIN32
 
-#include "../include/lightgui.h"
+#include "../src/lightgui_internal.h"
 #include <windows.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <windowsx.h> // For GET_X_LPARAM, GET_Y_LPARAM
 #include <commctrl.h> // For common controls
+#include <dwmapi.h> // For DwmGetCompositionTimingInfo and DwmFlush
 
 // Link with the required libraries
 #pragma comment(lib, "user32.lib")
 #pragma comment(lib, "gdi32.lib")
 #pragma comment(lib, "comctl32.lib")
+#pragma comment(lib, "opengl32.lib")
 
 // Manifest for Common Controls v6
 #if defined _M_IX86
@@ -38,9 +41,10 @@
 typedef struct {
     HWND hwnd;
     HDC hdc;
-    HBITMAP bitmap;
+    HBITMAP bitmap;  // At least the client size; see BackBufferSize
+    int bitmap_width;
+    int bitmap_height;
     HDC memory_dc;
-    bool needs_redraw;  // Flag to indicate if window needs redrawing
 } WindowData;
 
 /**
@@ -49,6 +53,23 @@ typedef struct {
 typedef struct {
     HWND hwnd;
     WNDPROC original_proc;
+    
+    // Canvas pixel buffer: a top-down 32-bit DIB section selected into canvas_dc
+    HDC canvas_dc;
+    HBITMAP canvas_bitmap;
+    HGDIOBJ canvas_old_bitmap;
+    uint32_t* canvas_pixels;
+    int canvas_width;
+    int canvas_height;
+    
+    // OpenGL canvases draw through a context on the window's own DC instead
+    HDC gl_dc;
+    HGLRC gl_context;
+    
+    // The widget's text converted for the wide APIs; see WidgetWideText
+    wchar_t* text_wide;
+    int text_wide_length;
+    int text_wide_capacity;  // In characters, including the terminator
 } WidgetData;
 
 /* ========================================================================= */
@@ -58,20 +79,13 @@ typedef struct {
 static HINSTANCE g_instance = NULL;
 static const wchar_t* WINDOW_CLASS_NAME = L"LightGUI_Window";
 static const wchar_t* WIDGET_CLASS_NAME = L"LightGUI_Widget";
+static const wchar_t* GL_CANVAS_CLASS_NAME = L"LightGUI_GLCanvas";
+static const wchar_t* WIDGET_PROP_NAME = L"LightGUI_Widget";
 static ATOM g_window_class = 0;
 static ATOM g_widget_class = 0;
+static ATOM g_gl_canvas_class = 0;
 static int g_next_widget_id = 1000; // Starting ID for widgets
-
-// Define event types for debugging
-const char* EVENT_TYPE_NAMES[] = {
-    "UNKNOWN",
-    "WINDOW_CLOSE",
-    "WINDOW_RESIZE",
-    "MOUSE_MOVE",
-    "MOUSE_BUTTON",
-    "WIDGET_CLICKED",
-    "KEY"
-};
+static HANDLE g_wake_event = NULL;   // Signalled by LG_PlatformWakeup
 
 /* ========================================================================= */
 /*                        Helper Functions                                   */
@@ -100,6 +114,46 @@ static wchar_t* Utf8ToWide(const char* utf8) {
     return wide;
 }
 
+/**
+ * @brief Get a widget's text as a wide string, converting it only after it changed
+ * 
+ * The core resets text_width whenever the text changes, so the conversion and
+ * the measurement are redone together and the string is kept until then.
+ * 
+ * @param widget The widget
+ * @param data The widget's platform data
+ * @param length Set to the length of the string in characters
+ * @return The string, owned by data, or NULL on failure
+ */
+static const wchar_t* WidgetWideText(LG_WidgetHandle widget, WidgetData* data, int* length) {
+    if (!widget->text) return NULL;
+    
+    if (widget->text_width < 0 || !data->text_wide) {
+        int size = MultiByteToWideChar(CP_UTF8, 0, widget->text, (int)widget->text_length + 1, NULL, 0);
+        if (size <= 0) return NULL;
+        
+        if (size > data->text_wide_capacity) {
+            wchar_t* wide = (wchar_t*)realloc(data->text_wide, size * sizeof(wchar_t));
+            if (!wide) return NULL;
+            data->text_wide = wide;
+            data->text_wide_capacity = size;
+        }
+        MultiByteToWideChar(CP_UTF8, 0, widget->text, (int)widget->text_length + 1, data->text_wide, size);
+        data->text_wide_length = size - 1;
+        
+        // Measured in the font windowless widgets are drawn with
+        WindowData* window_data = (WindowData*)widget->window->platform_data;
+        HGDIOBJ old_font = SelectObject(window_data->memory_dc, GetStockObject(DEFAULT_GUI_FONT));
+        SIZE extent;
+        widget->text_width = GetTextExtentPoint32W(window_data->memory_dc, data->text_wide,
+                                                   data->text_wide_length, &extent) ? extent.cx : 0;
+        SelectObject(window_data->memory_dc, old_font);
+    }
+    
+    *length = data->text_wide_length;
+    return data->text_wide;
+}
+
 /**
  * @brief Convert a wide string to a UTF-8 string
  */
@@ -130,64 +184,142 @@ static COLORREF ColorToColorRef(LG_Color color) {
     return RGB(color.r, color.g, color.b);
 }
 
-/**
- * @brief Find the window handle for a given LG_WindowHandle
- */
-static HWND GetWindowHwnd(LG_WindowHandle window) {
-    if (!window || !window->platform_data) return NULL;
-    return ((WindowData*)window->platform_data)->hwnd;
-}
-
 /**
  * @brief Find the LG_WindowHandle for a given HWND
  */
 static LG_WindowHandle FindWindowByHwnd(HWND hwnd) {
-    // This is a simple implementation that iterates through all windows
-    // A more efficient implementation would use a hash table
-    extern LG_WindowList g_windows;
-    for (size_t i = 0; i < g_windows.count; i++) {
-        if (GetWindowHwnd(g_windows.windows[i]) == hwnd) {
-            return g_windows.windows[i];
-        }
-    }
-    return NULL;
+    // Only our own window class stores a window pointer in GWLP_USERDATA
+    return (LG_WindowHandle)GetWindowLongPtrW(hwnd, GWLP_USERDATA);
 }
 
 /**
  * @brief Find the LG_WidgetHandle for a given HWND
  */
 static LG_WidgetHandle FindWidgetByHwnd(HWND hwnd) {
-    // This is a simple implementation that iterates through all windows and widgets
-    // A more efficient implementation would use a hash table
-    extern LG_WindowList g_windows;
-    for (size_t i = 0; i < g_windows.count; i++) {
-        LG_WindowHandle window = g_windows.windows[i];
-        for (size_t j = 0; j < window->widgets.count; j++) {
-            LG_WidgetHandle widget = window->widgets.widgets[j];
-            if (widget->platform_data && ((WidgetData*)widget->platform_data)->hwnd == hwnd) {
-                return widget;
+    // Standard controls may use GWLP_USERDATA themselves, so widgets are
+    // tagged with a window property instead
+    return (LG_WidgetHandle)GetPropW(hwnd, WIDGET_PROP_NAME);
+}
+
+/**
+ * @brief Draw the rows of a list that overlap an area
+ * 
+ * @param dc The device context holding the list
+ * @param list The list widget
+ * @param x The x position of the list in dc
+ * @param y The y position of the list in dc
+ * @param area The area to draw, in list coordinates
+ */
+static void DrawListRows(HDC dc, LG_WidgetHandle list, int x, int y, LG_Rect area) {
+    int row_height = ListRowHeight(list);
+    int bottom = area.y;  // End of the drawn rows in list coordinates
+    
+    HBRUSH background = CreateSolidBrush(ColorToColorRef(list->bg_color));
+    HBRUSH highlight = GetSysColorBrush(COLOR_HIGHLIGHT);
+    HGDIOBJ old_font = SelectObject(dc, GetStockObject(DEFAULT_GUI_FONT));
+    SetBkMode(dc, TRANSPARENT);
+    
+    size_t first, end;
+    if (ListRowRange(list, area, &first, &end)) {
+        for (size_t row = first; row < end; row++) {
+            int row_y = ListRowY(list, row);
+            bool selected = ListRowSelected(list, row);
+            RECT rect = {x, y + row_y, x + list->rect.width, y + row_y + row_height};
+            FillRect(dc, &rect, selected ? highlight : background);
+            
+            // Rows are short; convert on the stack instead of allocating
+            wchar_t text[LG_LIST_ROW_TEXT];
+            if (!MultiByteToWideChar(CP_UTF8, 0, ListRowText(list, row), -1, text, LG_LIST_ROW_TEXT)) {
+                text[0] = L'\0';
             }
+            
+            SetTextColor(dc, selected ? GetSysColor(COLOR_HIGHLIGHTTEXT)
+                                      : ColorToColorRef(list->text_color));
+            rect.left += 5;
+            DrawTextW(dc, text, -1, &rect, DT_SINGLELINE | DT_VCENTER | DT_NOPREFIX | DT_END_ELLIPSIS);
+            bottom = row_y + row_height;
         }
     }
-    return NULL;
+    
+    // Below the last row
+    if (bottom < area.y + area.height && bottom < list->rect.height) {
+        RECT rect = {x, y + bottom, x + list->rect.width, y + list->rect.height};
+        FillRect(dc, &rect, background);
+    }
+    
+    SelectObject(dc, old_font);
+    DeleteObject(background);
 }
 
 /**
- * @brief Dispatch an event to a window's callback
+ * @brief Draw a windowless widget into a device context
  */
-static void DispatchEvent(LG_WindowHandle window, LG_Event* event) {
-    if (window && window->event_callback) {
-        event->window = window;
-        
-        // Debug output for event type
-        if (event->type >= 0 && event->type <= 6) {
-            // printf("Event dispatched: type=%s\n", EVENT_TYPE_NAMES[event->type]);
+static void DrawWindowlessWidget(HDC dc, LG_WidgetHandle widget) {
+    if (widget->type == LG_WIDGET_LIST) {
+        LG_Rect area = {0, 0, widget->rect.width, widget->rect.height};
+        DrawListRows(dc, widget, widget->rect.x, widget->rect.y, area);
+        return;
+    }
+    
+    RECT rect;
+    rect.left = widget->rect.x;
+    rect.top = widget->rect.y;
+    rect.right = widget->rect.x + widget->rect.width;
+    rect.bottom = widget->rect.y + widget->rect.height;
+    
+    // Draw background
+    if (widget->type == LG_WIDGET_BUTTON || widget->bg_color.a > 0) {
+        HBRUSH brush = CreateSolidBrush(ColorToColorRef(widget->bg_color));
+        FillRect(dc, &rect, brush);
+        DeleteObject(brush);
+    }
+    
+    // Draw button border
+    if (widget->type == LG_WIDGET_BUTTON) {
+        FrameRect(dc, &rect, (HBRUSH)GetStockObject(BLACK_BRUSH));
+    }
+    
+    // Draw text
+    int text_length;
+    const wchar_t* text_wide = WidgetWideText(widget, (WidgetData*)widget->platform_data, &text_length);
+    if (text_wide) {
+        UINT format = DT_SINGLELINE | DT_VCENTER | DT_NOPREFIX;
+        if (widget->type == LG_WIDGET_BUTTON) {
+            format |= DT_CENTER;
         } else {
-            // printf("Event dispatched: type=%d (unknown)\n", event->type);
+            rect.left += 5;
         }
         
-        window->event_callback(event, window->user_data);
+        COLORREF text_color = widget->enabled ? ColorToColorRef(widget->text_color)
+                                              : GetSysColor(COLOR_GRAYTEXT);
+        SetTextColor(dc, text_color);
+        SetBkMode(dc, TRANSPARENT);
+        DrawTextW(dc, text_wide, text_length, &rect, format);
+    }
+}
+
+/**
+ * @brief Reallocate a window's back buffer bitmap if its size calls for it
+ */
+static void ResizeBackBuffer(LG_WindowHandle window) {
+    WindowData* data = (WindowData*)window->platform_data;
+    int width = window->width;
+    int height = window->height;
+    if (!BackBufferSize(data->bitmap_width, data->bitmap_height, &width, &height)) {
+        return;
+    }
+    
+    HBITMAP bitmap = CreateCompatibleBitmap(data->hdc, width, height);
+    if (!bitmap) {
+        fprintf(stderr, "LightGUI: Failed to resize bitmap\n");
+        return;  // Keep drawing into the old one, clipped
     }
+    
+    SelectObject(data->memory_dc, bitmap);
+    DeleteObject(data->bitmap);
+    data->bitmap = bitmap;
+    data->bitmap_width = width;
+    data->bitmap_height = height;
 }
 
 /* ========================================================================= */
@@ -209,45 +341,21 @@ static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lp
             {
                 LG_Event event;
                 event.type = LG_EVENT_WINDOW_CLOSE;
-                DispatchEvent(window, &event);
+                DispatchWindowEvent(window, &event);
                 return 0;
             }
             
         case WM_SIZE:
-            if (window) {
-                window->width = LOWORD(lparam);
-                window->height = HIWORD(lparam);
-                
-                LG_Event event;
-                event.type = LG_EVENT_WINDOW_RESIZE;
-                event.data.window_resize.width = window->width;
-                event.data.window_resize.height = window->height;
-                DispatchEvent(window, &event);
-                
-                // Mark window for redraw
-                if (window->platform_data) {
-                    WindowData* data = (WindowData*)window->platform_data;
-                    data->needs_redraw = true;
-                }
+            // The core drops unchanged sizes and reports the last size of a drag once per
+            // frame; minimizing keeps the layout and the buffer
+            if (window && window->platform_data && wparam != SIZE_MINIMIZED) {
+                DispatchWindowResize(window, LOWORD(lparam), HIWORD(lparam));
+                ResizeBackBuffer(window);
             }
             return 0;
             
         case WM_MOUSEMOVE:
-            {
-                LG_Event event;
-                event.type = LG_EVENT_MOUSE_MOVE;
-                event.data.mouse_move.x = GET_X_LPARAM(lparam);
-                event.data.mouse_move.y = GET_Y_LPARAM(lparam);
-                
-                // Calculate delta (this is simplified)
-                static int last_x = 0, last_y = 0;
-                event.data.mouse_move.delta_x = event.data.mouse_move.x - last_x;
-                event.data.mouse_move.delta_y = event.data.mouse_move.y - last_y;
-                last_x = event.data.mouse_move.x;
-                last_y = event.data.mouse_move.y;
-                
-                DispatchEvent(window, &event);
-            }
+            DispatchMouseMotion(window, GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam));
             return 0;
             
         case WM_LBUTTONDOWN:
@@ -281,7 +389,45 @@ static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lp
                                                   msg == WM_RBUTTONDOWN || 
                                                   msg == WM_MBUTTONDOWN);
                 
-                DispatchEvent(window, &event);
+                // Windowless buttons have no BN_CLICKED, so hit-test them here
+                if (msg == WM_LBUTTONDOWN) {
+                    LG_WidgetHandle widget = HitTestWidget(window, 
+                        event.data.mouse_button.x, event.data.mouse_button.y);
+                    
+                    if (widget && widget->enabled &&
+                        (widget->type == LG_WIDGET_BUTTON || widget->type == LG_WIDGET_LIST)) {
+                        if (widget->type == LG_WIDGET_LIST) {
+                            ListClick(widget, event.data.mouse_button.y - widget->rect.y);
+                        }
+                        
+                        LG_Event widget_event;
+                        widget_event.type = LG_EVENT_WIDGET_CLICKED;
+                        widget_event.data.widget_clicked.widget = widget;
+                        widget_event.data.widget_clicked.x = event.data.mouse_button.x - widget->rect.x;
+                        widget_event.data.widget_clicked.y = event.data.mouse_button.y - widget->rect.y;
+                        DispatchWindowEvent(window, &widget_event);
+                    }
+                }
+                
+                DispatchWindowEvent(window, &event);
+            }
+            return 0;
+            
+        case WM_MOUSEWHEEL:
+            {
+                // The wheel goes to the focus window; scroll the list under the pointer
+                POINT point = {GET_X_LPARAM(lparam), GET_Y_LPARAM(lparam)};
+                ScreenToClient(hwnd, &point);
+                
+                LG_WidgetHandle widget = HitTestWidget(window, point.x, point.y);
+                if (!widget) {
+                    widget = FindWidgetByHwnd(ChildWindowFromPoint(hwnd, point));
+                }
+                
+                if (widget && widget->type == LG_WIDGET_LIST) {
+                    int delta = GET_WHEEL_DELTA_WPARAM(wparam);
+                    ListScrollBy(widget, -(long)delta * LG_LIST_WHEEL_ROWS / WHEEL_DELTA);
+                }
             }
             return 0;
             
@@ -296,7 +442,7 @@ static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lp
                 event.data.key.shift = (GetKeyState(VK_SHIFT) & 0x8000) != 0;
                 event.data.key.alt = (GetKeyState(VK_MENU) & 0x8000) != 0;
                 
-                DispatchEvent(window, &event);
+                DispatchWindowEvent(window, &event);
             }
             return 0;
             
@@ -319,7 +465,7 @@ static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lp
                                     event.data.widget_clicked.x = widget->rect.x;
                                     event.data.widget_clicked.y = widget->rect.y;
                                     
-                                    DispatchEvent(window, &event);
+                                    DispatchWindowEvent(window, &event);
                                 }
                                 break;
                         }
@@ -340,12 +486,10 @@ static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lp
                 if (window && window->platform_data) {
                     WindowData* data = (WindowData*)window->platform_data;
                     
-                    // Blit the memory DC to the window DC
-                    BitBlt(hdc, 0, 0, window->width, window->height, 
-                           data->memory_dc, 0, 0, SRCCOPY);
-                    
-                    // Reset the needs_redraw flag since we just painted
-                    data->needs_redraw = false;
+                    // The only present: copy just the invalid area from the memory DC
+                    const RECT* area = &ps.rcPaint;
+                    BitBlt(hdc, area->left, area->top, area->right - area->left,
+                           area->bottom - area->top, data->memory_dc, area->left, area->top, SRCCOPY);
                 }
                 
                 EndPaint(hwnd, &ps);
@@ -361,6 +505,160 @@ static LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lp
     return DefWindowProc(hwnd, msg, wparam, lparam);
 }
 
+/**
+ * @brief Create the DIB section backing a canvas
+ */
+static bool CreateCanvasBitmap(WidgetData* data, int width, int height) {
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+    
+    BITMAPINFO info;
+    memset(&info, 0, sizeof(info));
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height;  // Top-down rows
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+    
+    void* bits = NULL;
+    HBITMAP bitmap = CreateDIBSection(NULL, &info, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (!bitmap || !bits) {
+        return false;
+    }
+    
+    HDC dc = CreateCompatibleDC(NULL);
+    if (!dc) {
+        DeleteObject(bitmap);
+        return false;
+    }
+    
+    data->canvas_dc = dc;
+    data->canvas_bitmap = bitmap;
+    data->canvas_old_bitmap = SelectObject(dc, bitmap);
+    data->canvas_pixels = (uint32_t*)bits;
+    data->canvas_width = width;
+    data->canvas_height = height;
+    
+    // Start out white, like the canvas background on other platforms
+    memset(bits, 0xFF, (size_t)width * height * 4);
+    return true;
+}
+
+/**
+ * @brief Free the DIB section backing a canvas
+ */
+static void DestroyCanvasBitmap(WidgetData* data) {
+    if (data->canvas_dc) {
+        SelectObject(data->canvas_dc, data->canvas_old_bitmap);
+        DeleteDC(data->canvas_dc);
+        data->canvas_dc = NULL;
+    }
+    
+    if (data->canvas_bitmap) {
+        DeleteObject(data->canvas_bitmap);
+        data->canvas_bitmap = NULL;
+    }
+    
+    data->canvas_pixels = NULL;
+}
+
+/**
+ * @brief Reallocate a canvas's DIB section after a resize, keeping the overlap
+ */
+static void ResizeCanvasBitmap(LG_WidgetHandle widget) {
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    if (data->canvas_width == widget->rect.width && data->canvas_height == widget->rect.height) {
+        return;
+    }
+    
+    WidgetData resized;
+    memset(&resized, 0, sizeof(resized));
+    if (!CreateCanvasBitmap(&resized, widget->rect.width, widget->rect.height)) {
+        fprintf(stderr, "LightGUI: Failed to resize canvas buffer\n");
+        return;
+    }
+    
+    if (data->canvas_dc) {
+        BitBlt(resized.canvas_dc, 0, 0, data->canvas_width, data->canvas_height,
+               data->canvas_dc, 0, 0, SRCCOPY);
+    }
+    
+    DestroyCanvasBitmap(data);
+    data->canvas_dc = resized.canvas_dc;
+    data->canvas_bitmap = resized.canvas_bitmap;
+    data->canvas_old_bitmap = resized.canvas_old_bitmap;
+    data->canvas_pixels = resized.canvas_pixels;
+    data->canvas_width = resized.canvas_width;
+    data->canvas_height = resized.canvas_height;
+}
+
+/**
+ * @brief Window procedure for canvas widgets
+ */
+static LRESULT CALLBACK CanvasProc(HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam) {
+    LG_WidgetHandle widget = FindWidgetByHwnd(hwnd);
+    
+    switch (msg) {
+        case WM_PAINT: {
+            PAINTSTRUCT ps;
+            HDC hdc = BeginPaint(hwnd, &ps);
+            
+            // Copy only the invalidated part of the DIB section
+            WidgetData* data = widget ? (WidgetData*)widget->platform_data : NULL;
+            if (data && data->canvas_dc) {
+                BitBlt(hdc, ps.rcPaint.left, ps.rcPaint.top,
+                       ps.rcPaint.right - ps.rcPaint.left,
+                       ps.rcPaint.bottom - ps.rcPaint.top,
+                       data->canvas_dc, ps.rcPaint.left, ps.rcPaint.top, SRCCOPY);
+            }
+            
+            EndPaint(hwnd, &ps);
+            return 0;
+        }
+        
+        case WM_ERASEBKGND:
+            return 1;  // Every pixel comes from the buffer
+        
+        case WM_SETCURSOR:
+            // The class cursor is a crosshair for drawing; lists want the arrow
+            if (widget && widget->type == LG_WIDGET_LIST && LOWORD(lparam) == HTCLIENT) {
+                SetCursor(LoadCursor(NULL, IDC_ARROW));
+                return TRUE;
+            }
+            break;
+        
+        case WM_MOUSEMOVE:
+        case WM_LBUTTONDOWN:
+        case WM_LBUTTONUP:
+        case WM_RBUTTONDOWN:
+        case WM_RBUTTONUP:
+        case WM_MBUTTONDOWN:
+        case WM_MBUTTONUP:
+            // Lists select the clicked row themselves
+            if (widget && widget->type == LG_WIDGET_LIST && msg == WM_LBUTTONDOWN) {
+                ListClick(widget, GET_Y_LPARAM(lparam));
+                
+                LG_Event event;
+                event.type = LG_EVENT_WIDGET_CLICKED;
+                event.data.widget_clicked.widget = widget;
+                event.data.widget_clicked.x = GET_X_LPARAM(lparam);
+                event.data.widget_clicked.y = GET_Y_LPARAM(lparam);
+                DispatchWindowEvent(widget->window, &event);
+            }
+            
+            // Report canvas input to the parent in window coordinates, as on X11
+            if (widget) {
+                int x = GET_X_LPARAM(lparam) + widget->rect.x;
+                int y = GET_Y_LPARAM(lparam) + widget->rect.y;
+                return SendMessageW(GetParent(hwnd), msg, wparam, MAKELPARAM(x, y));
+            }
+            break;
+    }
+    
+    return DefWindowProcW(hwnd, msg, wparam, lparam);
+}
+
 /**
  * @brief Subclass procedure for widgets
  */
@@ -379,7 +677,7 @@ static LRESULT CALLBACK WidgetSubclassProc(HWND hwnd, UINT msg, WPARAM wparam, L
 /*                        Platform API Implementation                        */
 /* ========================================================================= */
 
-bool LG_PlatformInitialize(void) {
+static bool Win32Initialize(void) {
     // Initialize common controls
     // Use a simpler approach that's more likely to work
     InitCommonControls();
@@ -394,7 +692,7 @@ bool LG_PlatformInitialize(void) {
     // Register window class
     WNDCLASSEXW wc = {0};
     wc.cbSize = sizeof(WNDCLASSEXW);
-    wc.style = CS_HREDRAW | CS_VREDRAW;
+    wc.style = 0;  // No CS_HREDRAW/CS_VREDRAW; a resize repaints only the core's damage
     wc.lpfnWndProc = WindowProc;
     wc.hInstance = g_instance;
     wc.hCursor = LoadCursor(NULL, IDC_ARROW);
@@ -407,17 +705,63 @@ bool LG_PlatformInitialize(void) {
         return false;
     }
     
+    // Register the class used by canvas widgets
+    WNDCLASSEXW canvas_wc = {0};
+    canvas_wc.cbSize = sizeof(WNDCLASSEXW);
+    canvas_wc.lpfnWndProc = CanvasProc;
+    canvas_wc.hInstance = g_instance;
+    canvas_wc.hCursor = LoadCursor(NULL, IDC_CROSS);
+    canvas_wc.hbrBackground = NULL;
+    canvas_wc.lpszClassName = WIDGET_CLASS_NAME;
+    
+    g_widget_class = RegisterClassExW(&canvas_wc);
+    if (!g_widget_class) {
+        fprintf(stderr, "LightGUI: Failed to register canvas class\n");
+        UnregisterClassW(WINDOW_CLASS_NAME, g_instance);
+        g_window_class = 0;
+        return false;
+    }
+    
+    // OpenGL canvases keep one DC for the life of their context
+    canvas_wc.style = CS_OWNDC;
+    canvas_wc.lpszClassName = GL_CANVAS_CLASS_NAME;
+    g_gl_canvas_class = RegisterClassExW(&canvas_wc);
+    if (!g_gl_canvas_class) {
+        fprintf(stderr, "LightGUI: Failed to register OpenGL canvas class\n");
+    }
+    
+    // Auto-reset event used to wake MsgWaitForMultipleObjectsEx
+    g_wake_event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    if (!g_wake_event) {
+        fprintf(stderr, "LightGUI: Failed to create wakeup event\n");
+    }
+    
     return true;
 }
 
-void LG_PlatformTerminate(void) {
+static void Win32Terminate(void) {
+    if (g_wake_event) {
+        CloseHandle(g_wake_event);
+        g_wake_event = NULL;
+    }
+    
+    if (g_gl_canvas_class) {
+        UnregisterClassW(GL_CANVAS_CLASS_NAME, g_instance);
+        g_gl_canvas_class = 0;
+    }
+    
+    if (g_widget_class) {
+        UnregisterClassW(WIDGET_CLASS_NAME, g_instance);
+        g_widget_class = 0;
+    }
+    
     if (g_window_class) {
         UnregisterClassW(WINDOW_CLASS_NAME, g_instance);
         g_window_class = 0;
     }
 }
 
-bool LG_PlatformCreateWindow(LG_WindowHandle window) {
+static bool Win32CreateWindow(LG_WindowHandle window) {
     if (!window) return false;
     
     // Allocate platform-specific data
@@ -429,7 +773,6 @@ bool LG_PlatformCreateWindow(LG_WindowHandle window) {
     
     // Initialize the data structure
     memset(data, 0, sizeof(WindowData));
-    data->needs_redraw = true;  // Initial draw needed
     
     // Convert title to wide string
     wchar_t* title_wide = Utf8ToWide(window->title);
@@ -504,6 +847,8 @@ bool LG_PlatformCreateWindow(LG_WindowHandle window) {
     }
     
     SelectObject(data->memory_dc, data->bitmap);
+    data->bitmap_width = window->width;
+    data->bitmap_height = window->height;
     
     // Clear the background
     RECT client_rect;
@@ -512,11 +857,12 @@ bool LG_PlatformCreateWindow(LG_WindowHandle window) {
     
     // Store platform data in window
     window->platform_data = data;
+    SetWindowLongPtrW(data->hwnd, GWLP_USERDATA, (LONG_PTR)window);
     
     return true;
 }
 
-void LG_PlatformDestroyWindow(LG_WindowHandle window) {
+static void Win32DestroyWindow(LG_WindowHandle window) {
     if (!window || !window->platform_data) return;
     
     WindowData* data = (WindowData*)window->platform_data;
@@ -525,13 +871,14 @@ void LG_PlatformDestroyWindow(LG_WindowHandle window) {
     DeleteObject(data->bitmap);
     DeleteDC(data->memory_dc);
     ReleaseDC(data->hwnd, data->hdc);
+    SetWindowLongPtrW(data->hwnd, GWLP_USERDATA, 0);
     DestroyWindow(data->hwnd);
     
     free(data);
     window->platform_data = NULL;
 }
 
-void LG_PlatformShowWindow(LG_WindowHandle window) {
+static void Win32ShowWindow(LG_WindowHandle window) {
     if (!window || !window->platform_data) return;
     
     WindowData* data = (WindowData*)window->platform_data;
@@ -539,14 +886,14 @@ void LG_PlatformShowWindow(LG_WindowHandle window) {
     UpdateWindow(data->hwnd);
 }
 
-void LG_PlatformHideWindow(LG_WindowHandle window) {
+static void Win32HideWindow(LG_WindowHandle window) {
     if (!window || !window->platform_data) return;
     
     WindowData* data = (WindowData*)window->platform_data;
     ShowWindow(data->hwnd, SW_HIDE);
 }
 
-void LG_PlatformSetWindowTitle(LG_WindowHandle window, const char* title) {
+static void Win32SetWindowTitle(LG_WindowHandle window, const char* title) {
     if (!window || !window->platform_data || !title) return;
     
     WindowData* data = (WindowData*)window->platform_data;
@@ -559,23 +906,57 @@ void LG_PlatformSetWindowTitle(LG_WindowHandle window, const char* title) {
     free(title_wide);
 }
 
-bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
+typedef BOOL (WINAPI *SwapIntervalEXTProc)(int interval);
+
+/**
+ * @brief Give an OpenGL canvas window a double-buffered pixel format and a context
+ */
+static bool CreateGLContext(WidgetData* data, HWND hwnd) {
+    PIXELFORMATDESCRIPTOR pfd;
+    memset(&pfd, 0, sizeof(pfd));
+    pfd.nSize = sizeof(pfd);
+    pfd.nVersion = 1;
+    pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+    pfd.iPixelType = PFD_TYPE_RGBA;
+    pfd.cColorBits = 32;
+    pfd.cDepthBits = 24;
+    pfd.cStencilBits = 8;
+    pfd.iLayerType = PFD_MAIN_PLANE;
+    
+    HDC dc = GetDC(hwnd);
+    int format = dc ? ChoosePixelFormat(dc, &pfd) : 0;
+    if (!format || !SetPixelFormat(dc, format, &pfd)) {
+        fprintf(stderr, "LightGUI: No double-buffered OpenGL pixel format\n");
+        return false;
+    }
+    
+    data->gl_context = wglCreateContext(dc);
+    if (!data->gl_context) {
+        fprintf(stderr, "LightGUI: Failed to create OpenGL context\n");
+        return false;
+    }
+    data->gl_dc = dc;
+    return true;
+}
+
+static bool Win32CreateWidget(LG_WidgetHandle widget) {
     if (!widget || !widget->window || !widget->window->platform_data) return false;
     
     WindowData* window_data = (WindowData*)widget->window->platform_data;
     
     // Allocate platform-specific data
-    WidgetData* data = (WidgetData*)malloc(sizeof(WidgetData));
+    WidgetData* data = (WidgetData*)AllocWidgetData(widget->window, sizeof(WidgetData));
     if (!data) {
         fprintf(stderr, "LightGUI: Failed to allocate widget data\n");
         return false;
     }
     
-    // Convert text to wide string
-    wchar_t* text_wide = Utf8ToWide(widget->text);
+    // Convert text to wide string; kept for later draws and updates
+    int text_length;
+    const wchar_t* text_wide = WidgetWideText(widget, data, &text_length);
     if (!text_wide) {
         fprintf(stderr, "LightGUI: Failed to convert widget text\n");
-        free(data);
+        FreeWidgetData(widget->window, data);
         return false;
     }
     
@@ -584,6 +965,14 @@ bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
         widget->id = g_next_widget_id++;
     }
     
+    // Windowless widgets are drawn into the window's memory DC
+    if (widget->windowless) {
+        data->hwnd = NULL;
+        data->original_proc = NULL;
+        widget->platform_data = data;
+        return true;
+    }
+    
     // Create widget based on type
     HWND hwnd = NULL;
     DWORD style = WS_CHILD | WS_VISIBLE;
@@ -637,18 +1026,66 @@ bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
             );
             break;
             
+        case LG_WIDGET_CANVAS:
+            if (widget->gl) {
+                // OpenGL must not draw over siblings, so they are clipped out
+                hwnd = CreateWindowW(
+                    GL_CANVAS_CLASS_NAME,       // Class name
+                    L"",                        // No text
+                    style | WS_CLIPSIBLINGS | WS_CLIPCHILDREN, // Style
+                    widget->rect.x,             // X position
+                    widget->rect.y,             // Y position
+                    widget->rect.width,         // Width
+                    widget->rect.height,        // Height
+                    window_data->hwnd,          // Parent window
+                    (HMENU)(INT_PTR)widget->id, // Menu (used as control ID)
+                    g_instance,                 // Instance
+                    NULL                        // Additional data
+                );
+                if (hwnd && !CreateGLContext(data, hwnd)) {
+                    DestroyWindow(hwnd);
+                    hwnd = NULL;
+                }
+                break;
+            }
+            // Fall through: pixel canvases share the list buffer code
+            
+        case LG_WIDGET_LIST:
+            // Lists draw their rows into the same kind of buffer and scroll inside it
+            if (!CreateCanvasBitmap(data, widget->rect.width, widget->rect.height)) {
+                fprintf(stderr, "LightGUI: Failed to create canvas buffer\n");
+                free(data->text_wide);
+                FreeWidgetData(widget->window, data);
+                return false;
+            }
+            
+            hwnd = CreateWindowW(
+                WIDGET_CLASS_NAME,          // Class name
+                L"",                        // No text
+                style,                      // Style
+                widget->rect.x,             // X position
+                widget->rect.y,             // Y position
+                widget->rect.width,         // Width
+                widget->rect.height,        // Height
+                window_data->hwnd,          // Parent window
+                (HMENU)(INT_PTR)widget->id, // Menu (used as control ID)
+                g_instance,                 // Instance
+                NULL                        // Additional data
+            );
+            break;
+            
         default:
             fprintf(stderr, "LightGUI: Unsupported widget type\n");
-            free(text_wide);
-            free(data);
+            free(data->text_wide);
+            FreeWidgetData(widget->window, data);
             return false;
     }
     
-    free(text_wide);
-    
     if (!hwnd) {
         fprintf(stderr, "LightGUI: Failed to create widget\n");
-        free(data);
+        DestroyCanvasBitmap(data);
+        free(data->text_wide);
+        FreeWidgetData(widget->window, data);
         return false;
     }
     
@@ -661,63 +1098,196 @@ bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
     // Store platform data in widget
     data->hwnd = hwnd;
     data->original_proc = (WNDPROC)GetWindowLongPtr(hwnd, GWLP_WNDPROC);
-    SetWindowLongPtr(hwnd, GWLP_USERDATA, (LONG_PTR)widget);
+    SetPropW(hwnd, WIDGET_PROP_NAME, (HANDLE)widget);
     
     widget->platform_data = data;
     
+    if (widget->type == LG_WIDGET_LIST) {
+        LG_Rect area = {0, 0, widget->rect.width, widget->rect.height};
+        DrawListRows(data->canvas_dc, widget, 0, 0, area);
+    }
+    
     return true;
 }
 
-void LG_PlatformDestroyWidget(LG_WidgetHandle widget) {
+static void Win32DestroyWidget(LG_WidgetHandle widget) {
     if (!widget || !widget->platform_data) return;
     
     WidgetData* data = (WidgetData*)widget->platform_data;
     
-    // Destroy widget
-    DestroyWindow(data->hwnd);
+    if (data->gl_context) {
+        if (wglGetCurrentContext() == data->gl_context) {
+            wglMakeCurrent(NULL, NULL);
+        }
+        wglDeleteContext(data->gl_context);
+    }
     
-    free(data);
+    // Destroy widget; a CS_OWNDC window's DC goes with it
+    if (data->hwnd) {
+        RemovePropW(data->hwnd, WIDGET_PROP_NAME);
+        DestroyWindow(data->hwnd);
+    }
+    
+    DestroyCanvasBitmap(data);
+    free(data->text_wide);
+    FreeWidgetData(widget->window, data);
     widget->platform_data = NULL;
 }
 
-void LG_PlatformUpdateWidget(LG_WidgetHandle widget) {
-    if (!widget || !widget->platform_data) return;
+/**
+ * @brief Apply the dirty properties of a widget except position, size and visibility
+ */
+static void ApplyWidgetState(LG_WidgetHandle widget, HWND hwnd) {
+    unsigned int dirty = widget->dirty;
     
-    WidgetData* data = (WidgetData*)widget->platform_data;
+    // A resized canvas needs a buffer of the new size
+    if (widget->type == LG_WIDGET_CANVAS) {
+        if ((dirty & LG_WIDGET_DIRTY_GEOMETRY) && !widget->gl) {
+            ResizeCanvasBitmap(widget);
+        }
+        return;
+    }
+    
+    // Lists also redraw their rows into the buffer
+    if (widget->type == LG_WIDGET_LIST) {
+        if (dirty & LG_WIDGET_DIRTY_GEOMETRY) {
+            ResizeCanvasBitmap(widget);
+        }
+        
+        WidgetData* data = (WidgetData*)widget->platform_data;
+        if (data->canvas_dc && (dirty & (LG_WIDGET_DIRTY_GEOMETRY | LG_WIDGET_DIRTY_COLOR |
+                                         LG_WIDGET_DIRTY_ENABLED))) {
+            LG_Rect area = {0, 0, widget->rect.width, widget->rect.height};
+            DrawListRows(data->canvas_dc, widget, 0, 0, area);
+            InvalidateRect(hwnd, NULL, FALSE);
+        }
+        return;
+    }
     
     // Update widget properties
-    if (widget->text) {
-        wchar_t* text_wide = Utf8ToWide(widget->text);
+    if (dirty & LG_WIDGET_DIRTY_TEXT) {
+        int text_length;
+        const wchar_t* text_wide = WidgetWideText(widget, (WidgetData*)widget->platform_data, &text_length);
         if (text_wide) {
-            SetWindowTextW(data->hwnd, text_wide);
-            free(text_wide);
+            SetWindowTextW(hwnd, text_wide);
         }
     }
     
-    // Update position and size
-    SetWindowPos(data->hwnd, NULL, 
-                widget->rect.x, widget->rect.y, 
-                widget->rect.width, widget->rect.height, 
-                SWP_NOZORDER);
-    
-    // Update visibility
-    ShowWindow(data->hwnd, widget->visible ? SW_SHOW : SW_HIDE);
-    
     // Update enabled state
-    EnableWindow(data->hwnd, widget->enabled);
+    if (dirty & LG_WIDGET_DIRTY_ENABLED) {
+        EnableWindow(hwnd, widget->enabled);
+    }
     
     // Update colors (for some controls)
-    if (widget->type != LG_WIDGET_TEXTFIELD) {
+    if ((dirty & LG_WIDGET_DIRTY_COLOR) && widget->type != LG_WIDGET_TEXTFIELD) {
         WindowData* window_data = (WindowData*)widget->window->platform_data;
         SetBkColor(window_data->memory_dc, ColorToColorRef(widget->bg_color));
         SetTextColor(window_data->memory_dc, ColorToColorRef(widget->text_color));
     }
     
-    // Force redraw of the widget only
-    InvalidateRect(data->hwnd, NULL, TRUE);
+    // Force redraw of the widget only; controls paint their whole area, so skip the erase
+    if (dirty & (LG_WIDGET_DIRTY_TEXT | LG_WIDGET_DIRTY_ENABLED | LG_WIDGET_DIRTY_COLOR)) {
+        InvalidateRect(hwnd, NULL, FALSE);
+    }
+}
+
+/**
+ * @brief Compute the SetWindowPos flags for a widget's dirty geometry and visibility
+ * 
+ * @return The flags, or 0 if neither geometry nor visibility changed
+ */
+static UINT GetWidgetPosFlags(LG_WidgetHandle widget) {
+    unsigned int dirty = widget->dirty;
+    UINT flags = SWP_NOZORDER | SWP_NOACTIVATE;
+    
+    if (!(dirty & (LG_WIDGET_DIRTY_GEOMETRY | LG_WIDGET_DIRTY_VISIBILITY))) {
+        return 0;
+    }
+    
+    if (!(dirty & LG_WIDGET_DIRTY_GEOMETRY)) {
+        flags |= SWP_NOMOVE | SWP_NOSIZE;
+    }
+    
+    if (dirty & LG_WIDGET_DIRTY_VISIBILITY) {
+        flags |= widget->visible ? SWP_SHOWWINDOW : SWP_HIDEWINDOW;
+    }
+    
+    return flags;
+}
+
+static void Win32UpdateWidget(LG_WidgetHandle widget) {
+    if (!widget || !widget->platform_data) return;
+    
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    
+    // Windowless widgets are repainted through the window's damage region
+    if (!data->hwnd) return;
+    
+    // Update position, size and visibility
+    UINT pos_flags = GetWidgetPosFlags(widget);
+    if (pos_flags) {
+        SetWindowPos(data->hwnd, NULL, 
+                    widget->rect.x, widget->rect.y, 
+                    widget->rect.width, widget->rect.height, 
+                    pos_flags);
+    }
+    
+    ApplyWidgetState(widget, data->hwnd);
 }
 
-bool LG_PlatformProcessEvents(void) {
+static void Win32UpdateWidgets(LG_WidgetHandle* widgets, size_t count) {
+    // Move, resize, show and hide all native widgets in a single operation
+    int deferred = 0;
+    for (size_t i = 0; i < count; i++) {
+        WidgetData* data = (WidgetData*)widgets[i]->platform_data;
+        if (data && data->hwnd && GetWidgetPosFlags(widgets[i])) {
+            deferred++;
+        }
+    }
+    
+    HDWP hdwp = deferred ? BeginDeferWindowPos(deferred) : NULL;
+    
+    for (size_t i = 0; i < count && hdwp; i++) {
+        LG_WidgetHandle widget = widgets[i];
+        WidgetData* data = (WidgetData*)widget->platform_data;
+        if (!data || !data->hwnd) continue;
+        
+        UINT pos_flags = GetWidgetPosFlags(widget);
+        if (!pos_flags) continue;
+        
+        // On failure the whole deferral is discarded
+        hdwp = DeferWindowPos(hdwp, data->hwnd, NULL,
+                              widget->rect.x, widget->rect.y,
+                              widget->rect.width, widget->rect.height,
+                              pos_flags);
+    }
+    
+    if (hdwp) {
+        EndDeferWindowPos(hdwp);
+    } else if (deferred) {
+        // Deferring failed; apply every change directly instead
+        for (size_t i = 0; i < count; i++) {
+            LG_WidgetHandle widget = widgets[i];
+            WidgetData* data = (WidgetData*)widget->platform_data;
+            UINT pos_flags = GetWidgetPosFlags(widget);
+            if (data && data->hwnd && pos_flags) {
+                SetWindowPos(data->hwnd, NULL,
+                            widget->rect.x, widget->rect.y,
+                            widget->rect.width, widget->rect.height,
+                            pos_flags);
+            }
+        }
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        WidgetData* data = (WidgetData*)widgets[i]->platform_data;
+        if (data && data->hwnd) {
+            ApplyWidgetState(widgets[i], data->hwnd);
+        }
+    }
+}
+
+static bool Win32ProcessEvents(void) {
     MSG msg;
     
     // Process all pending messages
@@ -733,31 +1303,336 @@ bool LG_PlatformProcessEvents(void) {
     return true;
 }
 
-void LG_PlatformRenderWindow(LG_WindowHandle window) {
+static void* Win32GetNativeHandle(LG_WidgetHandle widget) {
+    if (!widget || !widget->platform_data) return NULL;
+    
+    WidgetData* data = (WidgetData*)widget->platform_data;
+    return data->hwnd;
+}
+
+static bool Win32GetCanvasBuffer(LG_WidgetHandle canvas, LG_CanvasBuffer* buffer) {
+    if (!canvas || !canvas->platform_data || !buffer) return false;
+    
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    if (!data->canvas_pixels) return false;
+    
+    // GDI may still be reading the DIB section; finish before the caller writes
+    GdiFlush();
+    
+    buffer->pixels = data->canvas_pixels;
+    buffer->width = data->canvas_width;
+    buffer->height = data->canvas_height;
+    buffer->stride = data->canvas_width;  // 32-bit rows need no padding
+    return true;
+}
+
+static void Win32PresentCanvas(LG_WidgetHandle canvas, LG_Rect rect) {
+    if (!canvas || !canvas->platform_data) return;
+    
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    if (!data->hwnd) return;
+    
+    // WM_PAINT copies the accumulated invalid area straight from the DIB section
+    RECT area = {rect.x, rect.y, rect.x + rect.width, rect.y + rect.height};
+    InvalidateRect(data->hwnd, &area, FALSE);
+}
+
+static bool Win32BuildGlyphAtlas(LG_GlyphAtlas* atlas) {
+    // Grayscale antialiasing; ClearType fringes make no sense as coverage
+    LOGFONTW log_font;
+    if (!GetObjectW(GetStockObject(DEFAULT_GUI_FONT), sizeof(log_font), &log_font)) {
+        return false;
+    }
+    log_font.lfQuality = ANTIALIASED_QUALITY;
+    HFONT font = CreateFontIndirectW(&log_font);
+    if (!font) return false;
+    
+    HDC dc = CreateCompatibleDC(NULL);
+    if (!dc) {
+        DeleteObject(font);
+        return false;
+    }
+    HGDIOBJ old_font = SelectObject(dc, font);
+    
+    TEXTMETRICW metrics;
+    GetTextMetricsW(dc, &metrics);
+    atlas->ascent = metrics.tmAscent;
+    atlas->descent = metrics.tmDescent;
+    atlas->origin_x = 1 + metrics.tmOverhang;  // Room for glyphs reaching left of the pen
+    atlas->cell_width = metrics.tmMaxCharWidth + 2 * atlas->origin_x;
+    
+    int width = atlas->cell_width * LG_GLYPH_COUNT;
+    int height = atlas->ascent + atlas->descent;
+    
+    BITMAPINFO info;
+    memset(&info, 0, sizeof(info));
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = width;
+    info.bmiHeader.biHeight = -height;  // Top-down rows
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+    
+    void* bits = NULL;
+    HBITMAP bitmap = height > 0 ? CreateDIBSection(NULL, &info, DIB_RGB_COLORS, &bits, NULL, 0)
+                                : NULL;
+    if (!bitmap || !bits) {
+        SelectObject(dc, old_font);
+        DeleteObject(font);
+        DeleteDC(dc);
+        return false;
+    }
+    HGDIOBJ old_bitmap = SelectObject(dc, bitmap);
+    
+    // White glyphs on black, so any channel is the coverage
+    memset(bits, 0, (size_t)width * height * 4);
+    SetTextColor(dc, RGB(255, 255, 255));
+    SetBkMode(dc, TRANSPARENT);
+    for (int i = 0; i < LG_GLYPH_COUNT; i++) {
+        wchar_t c = (wchar_t)(LG_GLYPH_FIRST + i);
+        SIZE size;
+        GetTextExtentPoint32W(dc, &c, 1, &size);
+        atlas->advance[i] = size.cx;
+        TextOutW(dc, i * atlas->cell_width + atlas->origin_x, 0, &c, 1);
+    }
+    GdiFlush();
+    
+    atlas->stride = width;
+    atlas->coverage = (uint8_t*)malloc((size_t)width * height);
+    if (atlas->coverage) {
+        const uint32_t* pixels = (const uint32_t*)bits;
+        for (size_t i = 0; i < (size_t)width * height; i++) {
+            atlas->coverage[i] = (uint8_t)((pixels[i] >> 8) & 0xFF);
+        }
+    }
+    
+    SelectObject(dc, old_bitmap);
+    SelectObject(dc, old_font);
+    DeleteObject(bitmap);
+    DeleteObject(font);
+    DeleteDC(dc);
+    return atlas->coverage != NULL;
+}
+
+static void Win32RedrawList(LG_WidgetHandle list, LG_Rect rect) {
+    if (!list || !list->platform_data) return;
+    
+    WidgetData* data = (WidgetData*)list->platform_data;
+    if (!data->hwnd || !data->canvas_dc) return;
+    
+    DrawListRows(data->canvas_dc, list, 0, 0, rect);
+    RECT area = {rect.x, rect.y, rect.x + rect.width, rect.y + rect.height};
+    InvalidateRect(data->hwnd, &area, FALSE);
+}
+
+static void Win32ScrollList(LG_WidgetHandle list, int dy) {
+    if (!list || !list->platform_data) return;
+    
+    WidgetData* data = (WidgetData*)list->platform_data;
+    if (!data->hwnd || !data->canvas_dc) return;
+    
+    // Move the rows that stay visible within the buffer
+    RECT all = {0, 0, data->canvas_width, data->canvas_height};
+    ScrollDC(data->canvas_dc, 0, dy, &all, &all, NULL, NULL);
+    
+    int kept = list->rect.height - (dy < 0 ? -dy : dy);
+    LG_Rect strip = {0, dy < 0 ? kept : 0, list->rect.width, list->rect.height - kept};
+    DrawListRows(data->canvas_dc, list, 0, 0, strip);
+    InvalidateRect(data->hwnd, NULL, FALSE);
+}
+
+static void Win32Flush(void) {
+    // Submit any batched GDI calls of this thread
+    GdiFlush();
+}
+
+static bool Win32GLMakeCurrent(LG_WidgetHandle canvas) {
+    if (!canvas || !canvas->platform_data) return false;
+    
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    return data->gl_context && wglMakeCurrent(data->gl_dc, data->gl_context);
+}
+
+static void Win32GLSwapBuffers(LG_WidgetHandle canvas) {
+    if (!canvas || !canvas->platform_data) return;
+    
+    WidgetData* data = (WidgetData*)canvas->platform_data;
+    if (data->gl_context) {
+        SwapBuffers(data->gl_dc);
+    }
+}
+
+static bool Win32GLSetSwapInterval(LG_WidgetHandle canvas, int interval) {
+    (void)canvas;
+    
+    // WGL_EXT_swap_control applies to the current context's window
+    SwapIntervalEXTProc swap_interval = (SwapIntervalEXTProc)wglGetProcAddress("wglSwapIntervalEXT");
+    return swap_interval && swap_interval(interval);
+}
+
+static bool Win32WaitEvents(int timeout_ms, const LG_WaitHandle* handles, size_t handle_count) {
+    DWORD timeout = timeout_ms < 0 ? INFINITE : (DWORD)timeout_ms;
+    HANDLE objects[1 + LG_MAX_WAIT_HANDLES];
+    DWORD count = 0;
+    
+    if (g_wake_event) {
+        objects[count++] = g_wake_event;
+    }
+    for (size_t i = 0; i < handle_count; i++) {
+        objects[count++] = (HANDLE)handles[i];
+    }
+    
+    // MWMO_INPUTAVAILABLE also returns for messages that are already queued
+    DWORD result = MsgWaitForMultipleObjectsEx(
+        count, count ? objects : NULL, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+    
+    return result != WAIT_TIMEOUT && result != WAIT_FAILED;
+}
+
+static void Win32Wakeup(void) {
+    if (g_wake_event) {
+        SetEvent(g_wake_event);
+    }
+}
+
+/**
+ * @brief Convert performance counter ticks to microseconds without overflow
+ */
+static uint64_t QpcToMicroseconds(uint64_t ticks) {
+    static LARGE_INTEGER frequency;
+    if (!frequency.QuadPart) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    uint64_t rate = (uint64_t)frequency.QuadPart;
+    return ticks / rate * 1000000 + ticks % rate * 1000000 / rate;
+}
+
+static uint64_t Win32GetTime(void) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    return QpcToMicroseconds((uint64_t)now.QuadPart);
+}
+
+static bool Win32GetVBlankTiming(uint64_t* last_vblank, uint64_t* interval) {
+    // Fails while desktop composition is off
+    DWM_TIMING_INFO info;
+    memset(&info, 0, sizeof(info));
+    info.cbSize = sizeof(info);
+    if (FAILED(DwmGetCompositionTimingInfo(NULL, &info)) || !info.qpcRefreshPeriod) {
+        return false;
+    }
+    
+    *last_vblank = QpcToMicroseconds(info.qpcVBlank);
+    *interval = QpcToMicroseconds(info.qpcRefreshPeriod);
+    return true;
+}
+
+/**
+ * @brief Draw the damaged parts of the memory DC
+ * 
+ * Only touches the window's own memory DC and GDI objects created here,
+ * so windows can be drawn on different render threads at once.
+ */
+static void Win32RasterizeWindow(LG_WindowHandle window) {
     if (!window || !window->platform_data) return;
     
     WindowData* data = (WindowData*)window->platform_data;
+    const LG_DamageRegion* damage = &window->damage;
     
-    // Only redraw if needed
-    if (data->needs_redraw) {
-        // Clear background
+    for (int i = 0; i < damage->count; i++) {
         RECT rect;
-        GetClientRect(data->hwnd, &rect);
-        FillRect(data->memory_dc, &rect, (HBRUSH)(COLOR_WINDOW + 1));
-        
-        // Blit memory DC to window DC
-        HDC hdc = GetDC(data->hwnd);
-        BitBlt(hdc, 0, 0, window->width, window->height, 
-               data->memory_dc, 0, 0, SRCCOPY);
-        ReleaseDC(data->hwnd, hdc);
+        rect.left = damage->rects[i].x;
+        rect.top = damage->rects[i].y;
+        rect.right = damage->rects[i].x + damage->rects[i].width;
+        rect.bottom = damage->rects[i].y + damage->rects[i].height;
         
-        // Force a redraw
-        InvalidateRect(data->hwnd, NULL, FALSE);
-        UpdateWindow(data->hwnd);
+        // Clear background
+        FillRect(data->memory_dc, &rect, (HBRUSH)(COLOR_WINDOW + 1));
         
-        // Reset the needs_redraw flag
-        data->needs_redraw = false;
+        // Draw windowless widgets that overlap this rectangle, clipped to it
+        int saved_dc = SaveDC(data->memory_dc);
+        IntersectClipRect(data->memory_dc, rect.left, rect.top, rect.right, rect.bottom);
+        SelectObject(data->memory_dc, GetStockObject(DEFAULT_GUI_FONT));
+        LG_WidgetHandle* overlapping;
+        size_t overlapping_count = SpatialQuery(window, &damage->rects[i], 1, &overlapping);
+        for (size_t j = 0; j < overlapping_count; j++) {
+            LG_WidgetHandle widget = overlapping[j];
+            if (widget->windowless && widget->visible) {
+                DrawWindowlessWidget(data->memory_dc, widget);
+            }
+        }
+        RestoreDC(data->memory_dc, saved_dc);
     }
+    
+    // Let the main thread's blit see everything drawn here
+    GdiFlush();
 }
 
+static void Win32RenderWindow(LG_WindowHandle window) {
+    if (!window || !window->platform_data) return;
+    
+    WindowData* data = (WindowData*)window->platform_data;
+    const LG_DamageRegion* damage = &window->damage;
+    
+    // Only redraw if needed
+    if (damage->count == 0) return;
+    
+    // Present through WM_PAINT alone, which copies the union of the damage
+    for (int i = 0; i < damage->count; i++) {
+        RECT rect;
+        rect.left = damage->rects[i].x;
+        rect.top = damage->rects[i].y;
+        rect.right = damage->rects[i].x + damage->rects[i].width;
+        rect.bottom = damage->rects[i].y + damage->rects[i].height;
+        InvalidateRect(data->hwnd, &rect, FALSE);
+    }
+    
+    // Paint now rather than when the queue is empty, so the frame isn't held back by input
+    UpdateWindow(data->hwnd);
+}
+
+static bool Win32WaitForVBlank(void) {
+    // Fails while desktop composition is off
+    return SUCCEEDED(DwmFlush());
+}
+
+/* ========================================================================= */
+/*                        Backend Table                                      */
+/* ========================================================================= */
+
+const LG_PlatformBackend g_native_backend = {
+    "win32",
+    Win32Initialize,
+    Win32Terminate,
+    Win32CreateWindow,
+    Win32DestroyWindow,
+    Win32ShowWindow,
+    Win32HideWindow,
+    Win32SetWindowTitle,
+    Win32CreateWidget,
+    Win32DestroyWidget,
+    Win32UpdateWidget,
+    Win32UpdateWidgets,
+    Win32ProcessEvents,
+    Win32WaitEvents,
+    Win32Wakeup,
+    Win32GetTime,
+    Win32GetVBlankTiming,
+    Win32RenderWindow,
+    Win32GetNativeHandle,
+    Win32GetCanvasBuffer,
+    Win32PresentCanvas,
+    Win32RedrawList,
+    Win32ScrollList,
+    Win32BuildGlyphAtlas,
+    Win32Flush,
+    NULL,  // inject_event
+    NULL,  // get_window_frame
+    Win32RasterizeWindow,
+    Win32WaitForVBlank,
+    Win32GLMakeCurrent,
+    Win32GLSwapBuffers,
+    Win32GLSetSwapInterval
+};
+
 #endif /* _WIN32 */ 
\ No newline at end of file
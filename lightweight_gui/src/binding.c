@@ -0,0 +1,377 @@
+/**
+ * @file binding.c
+ * @brief Widget text bound to number and string sources
+ *
+ * Writing a source only stores the value and, the first time in a frame,
+ * queues the source. Once per frame the queued sources format their latest
+ * value into each bound widget's reusable buffer, and only text that
+ * differs from the widget's current text reaches LG_SetWidgetText. The
+ * platform updates of a frame are applied per window in one batch.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    SOURCE_NUMBER,
+    SOURCE_STRING
+} SourceType;
+
+typedef struct LG_Binding LG_Binding;
+
+/**
+ * @brief A value that widgets display, created with LG_CreateNumberSource
+ *        or LG_CreateStringSource
+ */
+struct LG_Source {
+    SourceType type;
+    double number;
+    char* string;  // NUL-terminated; string sources only
+    size_t string_capacity;
+    bool queued;  // In g_queued, waiting for the next frame
+    LG_Binding* bindings;  // Widgets showing this source
+    struct LG_Source* next;  // In g_sources
+};
+
+/**
+ * @brief A widget's text bound to a source
+ */
+struct LG_Binding {
+    LG_WidgetHandle widget;
+    LG_SourceHandle source;
+    char* format;  // Copy of the format, with exactly one conversion
+    char* buffer;  // The widget's formatted text, reused every frame
+    size_t buffer_capacity;
+    LG_Binding* next;  // In source->bindings
+};
+
+static LG_SourceHandle g_sources = NULL;  // Every live source, for LG_Terminate
+static LG_SourceHandle* g_queued = NULL;  // Sources written since the last frame
+static size_t g_queued_count = 0;
+static size_t g_queued_capacity = 0;
+
+/* ========================================================================= */
+/*                        Formatting                                         */
+/* ========================================================================= */
+
+/**
+ * @brief Check that a format has exactly one conversion of the source's type
+ *
+ * Flags, width and precision are allowed, but not '*' or length modifiers,
+ * so the value passed to snprintf always matches the conversion.
+ */
+static bool ValidFormat(const char* format, SourceType type) {
+    int conversions = 0;
+    for (const char* p = format; *p; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        if (*++p == '%') {
+            continue;
+        }
+
+        p += strspn(p, "-+ #0");
+        p += strspn(p, "0123456789");
+        if (*p == '.') {
+            p++;
+            p += strspn(p, "0123456789");
+        }
+
+        const char* allowed = type == SOURCE_NUMBER ? "aAeEfFgG" : "s";
+        if (*p == '\0' || !strchr(allowed, *p)) {
+            return false;
+        }
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+/**
+ * @brief Format a source's value into a binding's buffer
+ *
+ * @return The formatted text, or NULL if the buffer could not grow
+ */
+static const char* FormatBinding(LG_Binding* binding) {
+    LG_SourceHandle source = binding->source;
+    for (;;) {
+        int length = source->type == SOURCE_NUMBER
+            ? snprintf(binding->buffer, binding->buffer_capacity, binding->format, source->number)
+            : snprintf(binding->buffer, binding->buffer_capacity, binding->format, source->string);
+        if (length < 0) {
+            return NULL;
+        }
+        if ((size_t)length < binding->buffer_capacity) {
+            return binding->buffer;
+        }
+
+        // Grown once to the longest text seen, then reused
+        size_t capacity = (size_t)length + 1 > 64 ? (size_t)length + 1 : 64;
+        char* buffer = (char*)realloc(binding->buffer, capacity);
+        if (!buffer) {
+            return NULL;
+        }
+        binding->buffer = buffer;
+        binding->buffer_capacity = capacity;
+        g_stats.heap_allocations++;
+    }
+}
+
+/**
+ * @brief Bring a bound widget's text up to date with its source
+ */
+static void ApplyBinding(LG_Binding* binding) {
+    const char* text = FormatBinding(binding);
+    if (!text) {
+        fprintf(stderr, "LightGUI: Failed to format bound text\n");
+        return;
+    }
+
+    // LG_SetWidgetText drops unchanged text before touching the platform
+    LG_SetWidgetText(binding->widget, text);
+}
+
+/* ========================================================================= */
+/*                        Sources                                            */
+/* ========================================================================= */
+
+static LG_SourceHandle CreateSource(SourceType type) {
+    LG_SourceHandle source = (LG_SourceHandle)calloc(1, sizeof(struct LG_Source));
+    if (!source) {
+        fprintf(stderr, "LightGUI: Failed to allocate source\n");
+        return NULL;
+    }
+
+    source->type = type;
+    source->next = g_sources;
+    g_sources = source;
+    return source;
+}
+
+/**
+ * @brief Queue a source for the next frame, once per frame
+ */
+static void QueueSource(LG_SourceHandle source) {
+    if (source->queued || !source->bindings) {
+        return;
+    }
+
+    if (g_queued_count == g_queued_capacity) {
+        size_t capacity = g_queued_capacity ? g_queued_capacity * 2 : 64;
+        LG_SourceHandle* queued = (LG_SourceHandle*)realloc(g_queued, capacity * sizeof(LG_SourceHandle));
+        if (!queued) {
+            // Apply at once rather than lose the write
+            for (LG_Binding* binding = source->bindings; binding; binding = binding->next) {
+                ApplyBinding(binding);
+            }
+            return;
+        }
+        g_queued = queued;
+        g_queued_capacity = capacity;
+    }
+
+    g_queued[g_queued_count++] = source;
+    source->queued = true;
+}
+
+/**
+ * @brief Store a string source's value in its reusable buffer
+ */
+static bool StoreString(LG_SourceHandle source, const char* value) {
+    size_t size = strlen(value) + 1;
+    if (size > source->string_capacity) {
+        size_t capacity = size > 32 ? size : 32;
+        char* string = (char*)realloc(source->string, capacity);
+        if (!string) {
+            fprintf(stderr, "LightGUI: Failed to allocate source string\n");
+            return false;
+        }
+        source->string = string;
+        source->string_capacity = capacity;
+        g_stats.heap_allocations++;
+    }
+
+    memcpy(source->string, value, size);
+    return true;
+}
+
+LG_SourceHandle LG_CreateNumberSource(double value) {
+    LG_SourceHandle source = CreateSource(SOURCE_NUMBER);
+    if (source) {
+        source->number = value;
+    }
+    return source;
+}
+
+LG_SourceHandle LG_CreateStringSource(const char* value) {
+    LG_SourceHandle source = CreateSource(SOURCE_STRING);
+    if (source && !StoreString(source, value ? value : "")) {
+        LG_DestroySource(source);
+        return NULL;
+    }
+    return source;
+}
+
+void LG_SetSourceNumber(LG_SourceHandle source, double value) {
+    if (!source || source->type != SOURCE_NUMBER) {
+        return;
+    }
+
+    // Unchanged values need no frame
+    if (value == source->number) {
+        return;
+    }
+    source->number = value;
+    QueueSource(source);
+}
+
+void LG_SetSourceString(LG_SourceHandle source, const char* value) {
+    if (!source || source->type != SOURCE_STRING || !value) {
+        return;
+    }
+
+    if (strcmp(value, source->string) == 0) {
+        return;
+    }
+    if (StoreString(source, value)) {
+        QueueSource(source);
+    }
+}
+
+/**
+ * @brief Detach a binding from its source and widget and free it
+ */
+static void FreeBinding(LG_Binding* binding) {
+    LG_Binding** link = &binding->source->bindings;
+    while (*link != binding) {
+        link = &(*link)->next;
+    }
+    *link = binding->next;
+
+    binding->widget->binding = NULL;
+    free(binding->format);
+    free(binding->buffer);
+    free(binding);
+}
+
+void LG_DestroySource(LG_SourceHandle source) {
+    if (!source) {
+        return;
+    }
+
+    // Bound widgets keep the text they show
+    while (source->bindings) {
+        FreeBinding(source->bindings);
+    }
+
+    if (source->queued) {
+        for (size_t i = 0; i < g_queued_count; i++) {
+            if (g_queued[i] == source) {
+                g_queued[i] = g_queued[--g_queued_count];
+                break;
+            }
+        }
+    }
+
+    LG_SourceHandle* link = &g_sources;
+    while (*link != source) {
+        link = &(*link)->next;
+    }
+    *link = source->next;
+
+    free(source->string);
+    free(source);
+}
+
+/* ========================================================================= */
+/*                        Bindings                                           */
+/* ========================================================================= */
+
+bool LG_BindWidgetText(LG_WidgetHandle widget, LG_SourceHandle source, const char* format) {
+    if (!widget || !source) {
+        return false;
+    }
+
+    if (!format) {
+        format = source->type == SOURCE_NUMBER ? "%g" : "%s";
+    }
+    if (!ValidFormat(format, source->type)) {
+        fprintf(stderr, "LightGUI: Invalid format \"%s\" for a %s source\n", format,
+                source->type == SOURCE_NUMBER ? "number" : "string");
+        return false;
+    }
+
+    LG_Binding* binding = (LG_Binding*)calloc(1, sizeof(LG_Binding));
+    char* format_copy = (char*)malloc(strlen(format) + 1);
+    if (!binding || !format_copy) {
+        fprintf(stderr, "LightGUI: Failed to allocate binding\n");
+        free(binding);
+        free(format_copy);
+        return false;
+    }
+    strcpy(format_copy, format);
+
+    // A widget shows one source at a time
+    LG_UnbindWidget(widget);
+
+    binding->widget = widget;
+    binding->source = source;
+    binding->format = format_copy;
+    binding->next = source->bindings;
+    source->bindings = binding;
+    widget->binding = binding;
+
+    // Show the current value right away
+    ApplyBinding(binding);
+    return true;
+}
+
+void LG_UnbindWidget(LG_WidgetHandle widget) {
+    if (widget && widget->binding) {
+        FreeBinding(widget->binding);
+    }
+}
+
+/* ========================================================================= */
+/*                        Frame Integration                                  */
+/* ========================================================================= */
+
+bool BindingsPending(void) {
+    return g_queued_count > 0;
+}
+
+void FlushBindings(void) {
+    if (g_queued_count == 0) {
+        return;
+    }
+
+    // Text updates of the whole frame reach the platform in one batch per window
+    for (size_t i = 0; i < g_windows.count; i++) {
+        LG_BeginUpdate(g_windows.windows[i]);
+    }
+
+    for (size_t i = 0; i < g_queued_count; i++) {
+        LG_SourceHandle source = g_queued[i];
+        source->queued = false;
+        for (LG_Binding* binding = source->bindings; binding; binding = binding->next) {
+            ApplyBinding(binding);
+        }
+    }
+    g_queued_count = 0;
+
+    for (size_t i = 0; i < g_windows.count; i++) {
+        LG_EndUpdate(g_windows.windows[i]);
+    }
+}
+
+void BindingsTerminate(void) {
+    while (g_sources) {
+        LG_DestroySource(g_sources);
+    }
+
+    free(g_queued);
+    g_queued = NULL;
+    g_queued_count = 0;
+    g_queued_capacity = 0;
+}
@@ -0,0 +1,191 @@
+/**
+ * @file glcanvas.c
+ * @brief OpenGL canvases
+ *
+ * An OpenGL canvas is a canvas widget whose native window has a GL
+ * context in place of a pixel buffer. The backend creates the context
+ * along with the widget. This file keeps the swap interval and render
+ * callback, and renders the canvases that have a callback once per frame
+ * from LG_Run, so they animate at the frame rate without busy-looping.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct LG_GLCanvasState {
+    int swap_interval;
+    bool interval_applied;  // swap_interval has been set on the context
+    LG_CanvasRenderCallback callback;
+    void* user_data;
+};
+
+// Canvases with a render callback, in the order they got one
+static LG_WidgetHandle* g_animated = NULL;
+static size_t g_animated_count = 0;
+static size_t g_animated_capacity = 0;
+
+static bool IsGLCanvas(LG_WidgetHandle widget) {
+    return widget && widget->type == LG_WIDGET_CANVAS && widget->gl;
+}
+
+static bool AddAnimated(LG_WidgetHandle canvas) {
+    if (g_animated_count == g_animated_capacity) {
+        size_t capacity = g_animated_capacity ? g_animated_capacity * 2 : 4;
+        LG_WidgetHandle* animated = (LG_WidgetHandle*)realloc(g_animated,
+                                                              capacity * sizeof(LG_WidgetHandle));
+        if (!animated) {
+            return false;
+        }
+        g_animated = animated;
+        g_animated_capacity = capacity;
+    }
+
+    g_animated[g_animated_count++] = canvas;
+    return true;
+}
+
+static void RemoveAnimated(LG_WidgetHandle canvas) {
+    for (size_t i = 0; i < g_animated_count; i++) {
+        if (g_animated[i] == canvas) {
+            g_animated_count--;
+            memmove(&g_animated[i], &g_animated[i + 1],
+                    (g_animated_count - i) * sizeof(LG_WidgetHandle));
+            break;
+        }
+    }
+
+    if (g_animated_count == 0) {
+        free(g_animated);
+        g_animated = NULL;
+        g_animated_capacity = 0;
+    }
+}
+
+static bool IsShown(LG_WidgetHandle canvas) {
+    return canvas->window->visible && WidgetInView(canvas);
+}
+
+/* ========================================================================= */
+/*                        Internal Interface                                 */
+/* ========================================================================= */
+
+bool GLCanvasCreateState(LG_WidgetHandle canvas) {
+    canvas->gl = (LG_GLCanvasState*)calloc(1, sizeof(LG_GLCanvasState));
+    if (!canvas->gl) {
+        return false;
+    }
+
+    canvas->gl->swap_interval = 1;
+    return true;
+}
+
+void GLCanvasDestroyState(LG_WidgetHandle canvas) {
+    if (!canvas->gl) {
+        return;
+    }
+
+    if (canvas->gl->callback) {
+        RemoveAnimated(canvas);
+    }
+    free(canvas->gl);
+    canvas->gl = NULL;
+}
+
+bool GLCanvasesAnimating(void) {
+    for (size_t i = 0; i < g_animated_count; i++) {
+        if (IsShown(g_animated[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RenderGLCanvases(void) {
+    uint64_t start = LG_PlatformGetTime();
+
+    // A callback may destroy canvases, so re-check the count on every step
+    for (size_t i = 0; i < g_animated_count; i++) {
+        LG_WidgetHandle canvas = g_animated[i];
+        if (!IsShown(canvas) || !LG_CanvasMakeCurrent(canvas)) {
+            continue;
+        }
+
+        canvas->gl->callback(canvas, canvas->rect.width, canvas->rect.height,
+                             canvas->gl->user_data);
+
+        // The callback may have destroyed the canvas or removed its callback
+        if (i < g_animated_count && g_animated[i] == canvas) {
+            LG_CanvasSwapBuffers(canvas);
+        }
+    }
+
+    g_stats.render_us += LG_PlatformGetTime() - start;
+}
+
+/* ========================================================================= */
+/*                        Public API                                         */
+/* ========================================================================= */
+
+bool LG_CanvasMakeCurrent(LG_WidgetHandle canvas) {
+    if (!IsGLCanvas(canvas)) {
+        return false;
+    }
+
+    // Hidden canvases get their context on first use
+    if (!RealizeWidget(canvas)) {
+        fprintf(stderr, "LightGUI: Failed to create OpenGL canvas\n");
+        return false;
+    }
+    if (!LG_PlatformGLMakeCurrent(canvas)) {
+        return false;
+    }
+
+    LG_GLCanvasState* state = canvas->gl;
+    if (!state->interval_applied) {
+        if (!LG_PlatformGLSetSwapInterval(canvas, state->swap_interval)) {
+            fprintf(stderr, "LightGUI: Swap interval not supported\n");
+        }
+        state->interval_applied = true;  // Don't retry every frame
+    }
+    return true;
+}
+
+void LG_CanvasSwapBuffers(LG_WidgetHandle canvas) {
+    if (!IsGLCanvas(canvas) || !canvas->realized) {
+        return;
+    }
+
+    LG_PlatformGLSwapBuffers(canvas);
+    StatsPresented((uint64_t)canvas->rect.width * (uint64_t)canvas->rect.height);
+}
+
+bool LG_SetCanvasSwapInterval(LG_WidgetHandle canvas, int interval) {
+    if (!IsGLCanvas(canvas)) {
+        return false;
+    }
+
+    canvas->gl->swap_interval = interval < 0 ? 0 : interval;
+    canvas->gl->interval_applied = false;
+    return true;
+}
+
+void LG_SetCanvasRenderCallback(LG_WidgetHandle canvas, LG_CanvasRenderCallback callback,
+                                void* user_data) {
+    if (!IsGLCanvas(canvas)) {
+        return;
+    }
+
+    LG_GLCanvasState* state = canvas->gl;
+    if (callback && !state->callback && !AddAnimated(canvas)) {
+        fprintf(stderr, "LightGUI: Failed to register render callback\n");
+        return;
+    }
+    if (!callback && state->callback) {
+        RemoveAnimated(canvas);
+    }
+
+    state->callback = callback;
+    state->user_data = user_data;
+}
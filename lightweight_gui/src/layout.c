@@ -0,0 +1,291 @@
+/**
+ * @file layout.c
+ * @brief Binary layout files for LG_CreateWidgets
+ *
+ * A layout is a 16-byte header, one 40-byte record per widget and a
+ * table of NUL-terminated strings. All fields are little-endian and are
+ * read byte by byte, so a layout can be used straight from a mapped file
+ * on any platform and at any alignment:
+ *
+ *   header:  "LGL1", u32 widget count, u32 string table size, u32 0
+ *   record:  u16 type, u16 flags, i32 x, y, width, height, row_height,
+ *            u32 background 0xAARRGGBB, u32 text color 0xAARRGGBB,
+ *            u32 text offset in the string table or 0xFFFFFFFF, u32 0
+ *
+ * type and flags are LG_WidgetType and LG_WIDGET_DESC_* values.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define LAYOUT_HEADER_SIZE 16
+#define LAYOUT_RECORD_SIZE 40
+#define LAYOUT_NO_TEXT 0xFFFFFFFFu
+
+static const unsigned char g_layout_magic[4] = {'L', 'G', 'L', '1'};
+
+/* ========================================================================= */
+/*                        Encoding                                           */
+/* ========================================================================= */
+
+static uint32_t ReadU32(const unsigned char* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static uint16_t ReadU16(const unsigned char* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static void WriteU32(unsigned char* p, uint32_t value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+static void WriteU16(unsigned char* p, uint16_t value) {
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+}
+
+static LG_Color UnpackColor(uint32_t argb) {
+    return LG_CreateColor((uint8_t)(argb >> 16), (uint8_t)(argb >> 8), (uint8_t)argb,
+                          (uint8_t)(argb >> 24));
+}
+
+static uint32_t PackColor(LG_Color color) {
+    return (uint32_t)color.a << 24 | (uint32_t)color.r << 16 | (uint32_t)color.g << 8 | color.b;
+}
+
+static bool HasText(const LG_WidgetDesc* desc) {
+    return desc->text && desc->type != LG_WIDGET_CANVAS && desc->type != LG_WIDGET_LIST;
+}
+
+/* ========================================================================= */
+/*                        Loading                                            */
+/* ========================================================================= */
+
+/**
+ * @brief Decode and check a layout into widget descriptions
+ *
+ * @return The descriptions, pointing into layout for their text, or NULL
+ *         if the layout is invalid or empty
+ */
+static LG_WidgetDesc* DecodeLayout(const unsigned char* layout, size_t size, size_t* count) {
+    if (size < LAYOUT_HEADER_SIZE || memcmp(layout, g_layout_magic, sizeof(g_layout_magic)) != 0) {
+        fprintf(stderr, "LightGUI: Not a layout\n");
+        return NULL;
+    }
+
+    size_t widget_count = ReadU32(layout + 4);
+    size_t strings_size = ReadU32(layout + 8);
+    size_t records_size = size - LAYOUT_HEADER_SIZE;
+    if (widget_count == 0 || widget_count > records_size / LAYOUT_RECORD_SIZE ||
+        strings_size != records_size - widget_count * LAYOUT_RECORD_SIZE) {
+        fprintf(stderr, "LightGUI: Layout is truncated or corrupt\n");
+        return NULL;
+    }
+
+    LG_WidgetDesc* descs = (LG_WidgetDesc*)malloc(widget_count * sizeof(LG_WidgetDesc));
+    if (!descs) {
+        fprintf(stderr, "LightGUI: Failed to allocate layout\n");
+        return NULL;
+    }
+
+    const char* strings = (const char*)layout + LAYOUT_HEADER_SIZE + widget_count * LAYOUT_RECORD_SIZE;
+    for (size_t i = 0; i < widget_count; i++) {
+        const unsigned char* record = layout + LAYOUT_HEADER_SIZE + i * LAYOUT_RECORD_SIZE;
+        LG_WidgetDesc* desc = &descs[i];
+        desc->type = (LG_WidgetType)ReadU16(record);
+        desc->flags = ReadU16(record + 2);
+        desc->rect.x = (int32_t)ReadU32(record + 4);
+        desc->rect.y = (int32_t)ReadU32(record + 8);
+        desc->rect.width = (int32_t)ReadU32(record + 12);
+        desc->rect.height = (int32_t)ReadU32(record + 16);
+        desc->row_height = (int32_t)ReadU32(record + 20);
+        desc->bg_color = UnpackColor(ReadU32(record + 24));
+        desc->text_color = UnpackColor(ReadU32(record + 28));
+
+        // Text must be a terminated string inside the table
+        uint32_t offset = ReadU32(record + 32);
+        desc->text = NULL;
+        if (offset != LAYOUT_NO_TEXT) {
+            if (offset >= strings_size || !memchr(strings + offset, '\0', strings_size - offset)) {
+                fprintf(stderr, "LightGUI: Layout text is out of bounds\n");
+                free(descs);
+                return NULL;
+            }
+            desc->text = strings + offset;
+        }
+    }
+
+    *count = widget_count;
+    return descs;
+}
+
+size_t LG_CreateWidgetsFromLayout(LG_WindowHandle window, const void* layout, size_t size,
+                                  LG_WidgetHandle* out, size_t out_count) {
+    if (!window || !layout) {
+        return 0;
+    }
+
+    size_t count;
+    LG_WidgetDesc* descs = DecodeLayout((const unsigned char*)layout, size, &count);
+    if (!descs) {
+        return 0;
+    }
+
+    // Collect handles separately only when the caller wants fewer than all
+    LG_WidgetHandle* handles = NULL;
+    if (out && out_count < count) {
+        handles = (LG_WidgetHandle*)malloc(count * sizeof(LG_WidgetHandle));
+        if (!handles) {
+            fprintf(stderr, "LightGUI: Failed to allocate layout\n");
+            free(descs);
+            return 0;
+        }
+    }
+
+    bool created = LG_CreateWidgets(window, descs, count, handles ? handles : out);
+    if (created && handles) {
+        memcpy(out, handles, out_count * sizeof(LG_WidgetHandle));
+    }
+
+    free(handles);
+    free(descs);
+    return created ? count : 0;
+}
+
+size_t LG_LoadLayout(LG_WindowHandle window, const char* path, LG_WidgetHandle* out,
+                     size_t out_count) {
+    if (!window || !path) {
+        return 0;
+    }
+
+    // Map the file so the records are read in place rather than copied
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER file_size;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        fprintf(stderr, "LightGUI: Failed to open %s\n", path);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+        return 0;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const void* layout = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    size_t size = (size_t)file_size.QuadPart;
+#else
+    int file = open(path, O_RDONLY);
+    struct stat info;
+    if (file < 0 || fstat(file, &info) != 0 || info.st_size == 0) {
+        fprintf(stderr, "LightGUI: Failed to open %s\n", path);
+        if (file >= 0) close(file);
+        return 0;
+    }
+
+    size_t size = (size_t)info.st_size;
+    const void* layout = mmap(NULL, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (layout == MAP_FAILED) {
+        layout = NULL;
+    }
+#endif
+
+    size_t created = 0;
+    if (layout) {
+        created = LG_CreateWidgetsFromLayout(window, layout, size, out, out_count);
+    } else {
+        fprintf(stderr, "LightGUI: Failed to map %s\n", path);
+    }
+
+#ifdef _WIN32
+    if (layout) UnmapViewOfFile(layout);
+    if (mapping) CloseHandle(mapping);
+    CloseHandle(file);
+#else
+    if (layout) munmap((void*)layout, size);
+    close(file);
+#endif
+    return created;
+}
+
+/* ========================================================================= */
+/*                        Saving                                             */
+/* ========================================================================= */
+
+bool LG_SaveLayout(const char* path, const LG_WidgetDesc* descs, size_t count) {
+    if (!path || !descs || count == 0 || count > UINT32_MAX / LAYOUT_RECORD_SIZE) {
+        return false;
+    }
+
+    size_t strings_size = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (HasText(&descs[i])) {
+            strings_size += strlen(descs[i].text) + 1;
+        }
+    }
+    if (strings_size > UINT32_MAX - 1) {
+        return false;
+    }
+
+    // Build the whole file in memory and write it at once
+    size_t size = LAYOUT_HEADER_SIZE + count * LAYOUT_RECORD_SIZE + strings_size;
+    unsigned char* data = (unsigned char*)calloc(1, size);
+    if (!data) {
+        fprintf(stderr, "LightGUI: Failed to allocate layout\n");
+        return false;
+    }
+
+    memcpy(data, g_layout_magic, sizeof(g_layout_magic));
+    WriteU32(data + 4, (uint32_t)count);
+    WriteU32(data + 8, (uint32_t)strings_size);
+
+    char* strings = (char*)data + LAYOUT_HEADER_SIZE + count * LAYOUT_RECORD_SIZE;
+    size_t offset = 0;
+    for (size_t i = 0; i < count; i++) {
+        const LG_WidgetDesc* desc = &descs[i];
+        unsigned char* record = data + LAYOUT_HEADER_SIZE + i * LAYOUT_RECORD_SIZE;
+        WriteU16(record, (uint16_t)desc->type);
+        WriteU16(record + 2, (uint16_t)desc->flags);
+        WriteU32(record + 4, (uint32_t)desc->rect.x);
+        WriteU32(record + 8, (uint32_t)desc->rect.y);
+        WriteU32(record + 12, (uint32_t)desc->rect.width);
+        WriteU32(record + 16, (uint32_t)desc->rect.height);
+        WriteU32(record + 20, (uint32_t)desc->row_height);
+        WriteU32(record + 24, PackColor(desc->bg_color));
+        WriteU32(record + 28, PackColor(desc->text_color));
+
+        if (HasText(desc)) {
+            size_t length = strlen(desc->text) + 1;
+            memcpy(strings + offset, desc->text, length);
+            WriteU32(record + 32, (uint32_t)offset);
+            offset += length;
+        } else {
+            WriteU32(record + 32, LAYOUT_NO_TEXT);
+        }
+    }
+
+    FILE* file = fopen(path, "wb");
+    bool ok = file && fwrite(data, 1, size, file) == size;
+    if (file && fclose(file) != 0) {
+        ok = false;
+    }
+    free(data);
+
+    if (!ok) {
+        fprintf(stderr, "LightGUI: Failed to write %s\n", path);
+    }
+    return ok;
+}
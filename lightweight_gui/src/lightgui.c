@@ -36,6 +36,13 @@
 
 static bool g_initialized = false;
 static bool g_event_loop_running = false;
+static LG_RunMode g_run_mode = LG_RUN_MODE_WAIT;
+static int g_run_timeout_ms = -1;
+static uint64_t g_frame_interval_us = 1000000 / 60;  // Used without vblank timing
+static uint64_t g_next_frame_us = 0;  // Earliest time LG_Run renders again
+static bool g_wait_for_vblank = false;  // Block on the compositor after each frame
+static void** g_render_batch = NULL;  // Windows rasterized together in a frame
+static size_t g_render_batch_capacity = 0;
 LG_WindowList g_windows = {NULL, 0, 0};  /* Define the global window list */
 
 /* ========================================================================= */
@@ -43,12 +50,17 @@ LG_WindowList g_windows = {NULL, 0, 0};  /* Define the global window list */
 /* ========================================================================= */
 
 bool LG_Initialize(void) {
+    return LG_InitializeBackend(LG_BACKEND_DEFAULT);
+}
+
+bool LG_InitializeBackend(LG_Backend backend) {
     if (g_initialized) {
         fprintf(stderr, "LightGUI: Already initialized\n");
         return true;
     }
 
     // Initialize platform-specific backend
+    PlatformSelectBackend(backend);
     if (!LG_PlatformInitialize()) {
         fprintf(stderr, "LightGUI: Failed to initialize platform backend\n");
         return false;
@@ -65,6 +77,9 @@ bool LG_Initialize(void) {
         return false;
     }
 
+    RasterInitialize();
+    LG_ResetStats();
+
     g_initialized = true;
     return true;
 }
@@ -75,9 +90,9 @@ void LG_Terminate(void) {
         return;
     }
 
-    // Destroy all windows
-    for (size_t i = 0; i < g_windows.count; i++) {
-        LG_DestroyWindow(g_windows.windows[i]);
+    // Destroy all windows (each destroy removes the window from the list)
+    while (g_windows.count > 0) {
+        LG_DestroyWindow(g_windows.windows[g_windows.count - 1]);
     }
 
     // Free window list
@@ -87,6 +102,15 @@ void LG_Terminate(void) {
     g_windows.capacity = 0;
 
     // Terminate platform-specific backend
+    DiscardPostedItems();
+    TimersTerminate();
+    BindingsTerminate();
+    ReplayTerminate();
+    WorkersStop();
+    free(g_render_batch);
+    g_render_batch = NULL;
+    g_render_batch_capacity = 0;
+    RasterTerminate();
     LG_PlatformTerminate();
 
     g_initialized = false;
@@ -166,6 +190,9 @@ LG_WindowHandle LG_CreateWindow(const char* title, int width, int height, bool r
 
     g_windows.windows[g_windows.count++] = window;
 
+    // Nothing has been drawn yet
+    DamageWindow(window);
+
     return window;
 }
 
@@ -174,13 +201,21 @@ void LG_DestroyWindow(LG_WindowHandle window) {
         return;
     }
 
-    // Destroy all widgets
-    for (size_t i = 0; i < window->widgets.count; i++) {
-        LG_DestroyWidget(window->widgets.widgets[i]);
+    // Nothing can receive the output of the window's processes any more
+    DestroyWindowProcesses(window);
+
+    // Destroy all widgets (each destroy removes the widget from the list)
+    while (window->widgets.count > 0) {
+        LG_DestroyWidget(window->widgets.widgets[window->widgets.count - 1]);
     }
 
-    // Free widget list
+    // Free widget lists
     free(window->widgets.widgets);
+    free(window->pending_updates.widgets);
+    free(window->motion_history);
+    PoolDestroy(window->widget_pool);
+    PoolDestroy(window->widget_data_pool);
+    SpatialDestroy(window);
 
     // Destroy platform-specific window
     LG_PlatformDestroyWindow(window);
@@ -205,6 +240,7 @@ void LG_ShowWindow(LG_WindowHandle window) {
     }
 
     window->visible = true;
+    DamageWindow(window);
     LG_PlatformShowWindow(window);
 }
 
@@ -217,6 +253,14 @@ void LG_HideWindow(LG_WindowHandle window) {
     LG_PlatformHideWindow(window);
 }
 
+void LG_SetWindowlessWidgets(LG_WindowHandle window, bool enabled) {
+    if (!g_initialized || !window) {
+        return;
+    }
+
+    window->windowless_widgets = enabled;
+}
+
 void LG_SetWindowTitle(LG_WindowHandle window, const char* title) {
     if (!g_initialized || !window || !title) {
         return;
@@ -230,28 +274,367 @@ void LG_SetWindowTitle(LG_WindowHandle window, const char* title) {
     LG_PlatformSetWindowTitle(window, title);
 }
 
+/* ========================================================================= */
+/*                              Damage Tracking                              */
+/* ========================================================================= */
+
+static long RectArea(LG_Rect rect) {
+    return (long)rect.width * (long)rect.height;
+}
+
+static bool RectContains(LG_Rect outer, LG_Rect inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width &&
+           inner.y + inner.height <= outer.y + outer.height;
+}
+
+bool RectIntersect(LG_Rect a, LG_Rect b, LG_Rect* out) {
+    int x1 = a.x > b.x ? a.x : b.x;
+    int y1 = a.y > b.y ? a.y : b.y;
+    int x2 = (a.x + a.width) < (b.x + b.width) ? (a.x + a.width) : (b.x + b.width);
+    int y2 = (a.y + a.height) < (b.y + b.height) ? (a.y + a.height) : (b.y + b.height);
+
+    if (x2 <= x1 || y2 <= y1) {
+        return false;
+    }
+
+    if (out) {
+        out->x = x1;
+        out->y = y1;
+        out->width = x2 - x1;
+        out->height = y2 - y1;
+    }
+    return true;
+}
+
+LG_Rect RectUnion(LG_Rect a, LG_Rect b) {
+    int x1 = a.x < b.x ? a.x : b.x;
+    int y1 = a.y < b.y ? a.y : b.y;
+    int x2 = (a.x + a.width) > (b.x + b.width) ? (a.x + a.width) : (b.x + b.width);
+    int y2 = (a.y + a.height) > (b.y + b.height) ? (a.y + a.height) : (b.y + b.height);
+
+    LG_Rect result = {x1, y1, x2 - x1, y2 - y1};
+    return result;
+}
+
+void DamageWindowRect(LG_WindowHandle window, LG_Rect rect) {
+    if (!window) {
+        return;
+    }
+
+    // Only the visible part of the window can ever be repainted
+    LG_Rect bounds = {0, 0, window->width, window->height};
+    if (!RectIntersect(rect, bounds, &rect)) {
+        return;
+    }
+
+    LG_DamageRegion* damage = &window->damage;
+
+    for (int i = 0; i < damage->count; i++) {
+        if (RectContains(damage->rects[i], rect)) {
+            return;
+        }
+    }
+
+    // Absorb every rectangle that overlaps the new one. The union may
+    // overlap rectangles that were checked earlier, so restart the scan.
+    int i = 0;
+    while (i < damage->count) {
+        if (RectIntersect(damage->rects[i], rect, NULL)) {
+            rect = RectUnion(rect, damage->rects[i]);
+            damage->rects[i] = damage->rects[--damage->count];
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+
+    if (damage->count == LG_MAX_DAMAGE_RECTS) {
+        // Region is full: merge with the rectangle that wastes the least area
+        int best = 0;
+        long best_cost = 0;
+        for (i = 0; i < damage->count; i++) {
+            long cost = RectArea(RectUnion(rect, damage->rects[i])) -
+                        RectArea(damage->rects[i]) - RectArea(rect);
+            if (i == 0 || cost < best_cost) {
+                best = i;
+                best_cost = cost;
+            }
+        }
+
+        rect = RectUnion(rect, damage->rects[best]);
+        damage->rects[best] = damage->rects[--damage->count];
+        DamageWindowRect(window, rect);
+        return;
+    }
+
+    damage->rects[damage->count++] = rect;
+}
+
+void DamageWindow(LG_WindowHandle window) {
+    if (!window) {
+        return;
+    }
+
+    window->damage.rects[0].x = 0;
+    window->damage.rects[0].y = 0;
+    window->damage.rects[0].width = window->width;
+    window->damage.rects[0].height = window->height;
+    window->damage.count = (window->width > 0 && window->height > 0) ? 1 : 0;
+}
+
+void DamageWidget(LG_WidgetHandle widget) {
+    if (!widget || !widget->visible) {
+        return;
+    }
+
+    DamageWindowRect(widget->window, widget->rect);
+}
+
 /* ========================================================================= */
 /*                              Widget Management                            */
 /* ========================================================================= */
 
-void AddWidgetToWindow(LG_WindowHandle window, LG_WidgetHandle widget) {
+/**
+ * @brief Append a widget to a widget list, growing it if necessary
+ */
+static bool AppendWidget(LG_WidgetList* list, LG_WidgetHandle widget) {
     // Resize widget list if necessary
-    if (window->widgets.count >= window->widgets.capacity) {
-        size_t new_capacity = window->widgets.capacity * 2;
+    if (list->count >= list->capacity) {
+        size_t new_capacity = list->capacity ? list->capacity * 2 : 16;
         LG_WidgetHandle* new_widgets = (LG_WidgetHandle*)realloc(
-            window->widgets.widgets, new_capacity * sizeof(LG_WidgetHandle));
+            list->widgets, new_capacity * sizeof(LG_WidgetHandle));
         
         if (!new_widgets) {
             fprintf(stderr, "LightGUI: Failed to resize widget list\n");
-            return;
+            return false;
         }
 
-        window->widgets.widgets = new_widgets;
-        window->widgets.capacity = new_capacity;
+        list->widgets = new_widgets;
+        list->capacity = new_capacity;
+        g_stats.heap_allocations++;
     }
 
     // Add widget to list
-    window->widgets.widgets[window->widgets.count++] = widget;
+    list->widgets[list->count++] = widget;
+    return true;
+}
+
+/**
+ * @brief Remove a widget from a widget list
+ * 
+ * @param keep_order Shift the following widgets down instead of moving the
+ *        last one into the gap; needed where the list order is the z-order
+ */
+static void RemoveWidget(LG_WidgetList* list, LG_WidgetHandle widget, bool keep_order) {
+    for (size_t i = 0; i < list->count; i++) {
+        if (list->widgets[i] == widget) {
+            list->count--;
+            if (keep_order) {
+                memmove(&list->widgets[i], &list->widgets[i + 1],
+                        (list->count - i) * sizeof(LG_WidgetHandle));
+            } else {
+                // Move last widget to this position
+                list->widgets[i] = list->widgets[list->count];
+            }
+            break;
+        }
+    }
+}
+
+void AddWidgetToWindow(LG_WindowHandle window, LG_WidgetHandle widget) {
+    // New widgets stack on top of the existing ones
+    widget->z_order = ++window->next_z_order;
+    AppendWidget(&window->widgets, widget);
+    SpatialInsert(window, widget);
+}
+
+bool WidgetInView(LG_WidgetHandle widget) {
+    LG_Rect area = {0, 0, widget->window->width, widget->window->height};
+    return widget->visible && RectIntersect(widget->rect, area, NULL);
+}
+
+bool RealizeWidget(LG_WidgetHandle widget) {
+    if (widget->realized) {
+        return true;
+    }
+    if (!LG_PlatformCreateWidget(widget)) {
+        return false;
+    }
+    widget->realized = true;
+    widget->window->unrealized_count--;
+
+    // Backends create widgets shown and enabled; apply what differs directly
+    unsigned int state = (widget->visible ? 0 : LG_WIDGET_DIRTY_VISIBILITY) |
+                         (widget->enabled ? 0 : LG_WIDGET_DIRTY_ENABLED);
+    if (state) {
+        unsigned int dirty = widget->dirty;
+        widget->dirty = state;
+        LG_PlatformUpdateWidget(widget);
+        widget->dirty = dirty;
+    }
+    return true;
+}
+
+/**
+ * @brief Destroy the platform side of a widget, keeping the widget itself
+ */
+static void UnrealizeWidget(LG_WidgetHandle widget) {
+    LG_PlatformDestroyWidget(widget);
+    widget->realized = false;
+    widget->window->unrealized_count++;
+}
+
+/**
+ * @brief Add a new widget to its window, realizing it if it is in view
+ */
+static bool AttachWidget(LG_WindowHandle window, struct LG_Widget* widget) {
+    AddWidgetToWindow(window, widget);
+    window->unrealized_count++;
+    if (!widget->visible) {
+        widget->hidden_since = LG_PlatformGetTime();
+    }
+
+    if (WidgetInView(widget) && !RealizeWidget(widget)) {
+        SpatialRemove(window, widget);
+        RemoveWidget(&window->widgets, widget, true);
+        window->unrealized_count--;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Realize the widgets of a window that have come into view
+ */
+static void RealizeWidgetsInView(LG_WindowHandle window) {
+    for (size_t i = 0; i < window->widgets.count && window->unrealized_count > 0; i++) {
+        LG_WidgetHandle widget = window->widgets.widgets[i];
+        if (!widget->realized && WidgetInView(widget) && !RealizeWidget(widget)) {
+            fprintf(stderr, "LightGUI: Failed to create platform widget\n");
+        }
+    }
+}
+
+/**
+ * @brief Record changed widget properties and apply them unless batching
+ */
+static void MarkWidgetDirty(LG_WidgetHandle widget, unsigned int flags) {
+    LG_WindowHandle window = widget->window;
+    bool was_clean = (widget->dirty == 0);
+
+    // Realizing applies every property, so unrealized widgets only need that
+    if (!widget->realized) {
+        if (WidgetInView(widget) && !RealizeWidget(widget)) {
+            fprintf(stderr, "LightGUI: Failed to create platform widget\n");
+        }
+        return;
+    }
+
+    widget->dirty |= flags;
+
+    if (window->update_depth > 0) {
+        // Applied by LG_EndUpdate; queue each widget only once
+        if (was_clean && !AppendWidget(&window->pending_updates, widget)) {
+            LG_PlatformUpdateWidget(widget);
+            widget->dirty = 0;
+        }
+        return;
+    }
+
+    LG_PlatformUpdateWidget(widget);
+    widget->dirty = 0;
+    g_stats.widget_updates++;
+}
+
+LG_WidgetHandle HitTestWidget(LG_WindowHandle window, int x, int y) {
+    if (!window) {
+        return NULL;
+    }
+
+    return SpatialHitTest(window, x, y);
+}
+
+/**
+ * @brief Allocate a zeroed widget from its window's pool
+ */
+static struct LG_Widget* AllocWidget(LG_WindowHandle window) {
+    if (!window->widget_pool) {
+        window->widget_pool = PoolCreate(sizeof(struct LG_Widget), 32);
+        if (!window->widget_pool) {
+            return NULL;
+        }
+    }
+
+    return (struct LG_Widget*)PoolAlloc(window->widget_pool);
+}
+
+/**
+ * @brief Store a copy of text in a widget, reusing its buffer when possible
+ * 
+ * Text that fits in text_inline needs no allocation. Longer text gets a
+ * heap buffer which is grown geometrically and kept for later texts.
+ */
+static bool SetWidgetTextStorage(struct LG_Widget* widget, const char* text) {
+    size_t size = strlen(text) + 1;
+    size_t capacity = widget->text_capacity ? widget->text_capacity : sizeof(widget->text_inline);
+
+    if (size > capacity) {
+        while (capacity < size) {
+            capacity *= 2;
+        }
+
+        char* buffer = widget->text_capacity ? (char*)realloc(widget->text, capacity)
+                                             : (char*)malloc(capacity);
+        if (!buffer) {
+            return false;
+        }
+        widget->text = buffer;
+        widget->text_capacity = capacity;
+        g_stats.heap_allocations++;
+    } else if (!widget->text_capacity) {
+        widget->text = widget->text_inline;
+    }
+
+    memmove(widget->text, text, size);
+    widget->text_length = size - 1;
+    widget->text_width = -1;  // Measured again when next drawn
+    return true;
+}
+
+/**
+ * @brief Free a widget's text and list state and return the widget to its window's pool
+ */
+static void FreeWidget(struct LG_Widget* widget) {
+    CancelWidgetAnimations(widget);
+    LG_UnbindWidget(widget);
+    if (widget->text_capacity) {
+        free(widget->text);
+    }
+    ListDestroyState(widget);
+    GLCanvasDestroyState(widget);
+    PoolFree(widget->window->widget_pool, widget);
+}
+
+void* AllocWidgetData(LG_WindowHandle window, size_t size) {
+    if (!window->widget_data_pool) {
+        window->widget_data_pool = PoolCreate(size, 32);
+        if (!window->widget_data_pool) {
+            return NULL;
+        }
+    }
+
+    // Every backend allocates one fixed structure type
+    if (size > PoolItemSize(window->widget_data_pool)) {
+        fprintf(stderr, "LightGUI: Widget data larger than its pool\n");
+        return NULL;
+    }
+
+    return PoolAlloc(window->widget_data_pool);
+}
+
+void FreeWidgetData(LG_WindowHandle window, void* data) {
+    PoolFree(window->widget_data_pool, data);
 }
 
 LG_WidgetHandle LG_CreateButton(LG_WindowHandle window, const char* text, 
@@ -260,17 +643,17 @@ LG_WidgetHandle LG_CreateButton(LG_WindowHandle window, const char* text,
         return NULL;
     }
 
-    // Allocate widget structure
-    struct LG_Widget* widget = (struct LG_Widget*)malloc(sizeof(struct LG_Widget));
+    // Allocate widget structure from the window's pool
+    struct LG_Widget* widget = AllocWidget(window);
     if (!widget) {
         fprintf(stderr, "LightGUI: Failed to allocate button widget\n");
         return NULL;
     }
 
     // Initialize widget structure
-    memset(widget, 0, sizeof(struct LG_Widget));
     widget->type = LG_WIDGET_BUTTON;
     widget->window = window;
+    widget->windowless = window->windowless_widgets;
     widget->rect.x = x;
     widget->rect.y = y;
     widget->rect.width = width;
@@ -280,24 +663,20 @@ LG_WidgetHandle LG_CreateButton(LG_WindowHandle window, const char* text,
     widget->bg_color = LG_COLOR_WHITE;
     widget->text_color = LG_COLOR_BLACK;
     
-    // Copy text
-    widget->text = STRDUP(text);
-    if (!widget->text) {
+    // Copy text (short strings are stored inline)
+    if (!SetWidgetTextStorage(widget, text)) {
         fprintf(stderr, "LightGUI: Failed to allocate button text\n");
-        free(widget);
+        FreeWidget(widget);
         return NULL;
     }
 
-    // Create platform-specific widget
-    if (!LG_PlatformCreateWidget(widget)) {
+    // Add widget to window; the platform widget follows once it is in view
+    if (!AttachWidget(window, widget)) {
         fprintf(stderr, "LightGUI: Failed to create platform button\n");
-        free(widget->text);
-        free(widget);
+        FreeWidget(widget);
         return NULL;
     }
-
-    // Add widget to window
-    AddWidgetToWindow(window, widget);
+    DamageWidget(widget);
 
     return widget;
 }
@@ -308,17 +687,17 @@ LG_WidgetHandle LG_CreateLabel(LG_WindowHandle window, const char* text,
         return NULL;
     }
 
-    // Allocate widget structure
-    struct LG_Widget* widget = (struct LG_Widget*)malloc(sizeof(struct LG_Widget));
+    // Allocate widget structure from the window's pool
+    struct LG_Widget* widget = AllocWidget(window);
     if (!widget) {
         fprintf(stderr, "LightGUI: Failed to allocate label widget\n");
         return NULL;
     }
 
     // Initialize widget structure
-    memset(widget, 0, sizeof(struct LG_Widget));
     widget->type = LG_WIDGET_LABEL;
     widget->window = window;
+    widget->windowless = window->windowless_widgets;
     widget->rect.x = x;
     widget->rect.y = y;
     widget->rect.width = width;
@@ -328,24 +707,20 @@ LG_WidgetHandle LG_CreateLabel(LG_WindowHandle window, const char* text,
     widget->bg_color = LG_COLOR_TRANSPARENT;
     widget->text_color = LG_COLOR_BLACK;
     
-    // Copy text
-    widget->text = STRDUP(text);
-    if (!widget->text) {
+    // Copy text (short strings are stored inline)
+    if (!SetWidgetTextStorage(widget, text)) {
         fprintf(stderr, "LightGUI: Failed to allocate label text\n");
-        free(widget);
+        FreeWidget(widget);
         return NULL;
     }
 
-    // Create platform-specific widget
-    if (!LG_PlatformCreateWidget(widget)) {
+    // Add widget to window; the platform widget follows once it is in view
+    if (!AttachWidget(window, widget)) {
         fprintf(stderr, "LightGUI: Failed to create platform label\n");
-        free(widget->text);
-        free(widget);
+        FreeWidget(widget);
         return NULL;
     }
-
-    // Add widget to window
-    AddWidgetToWindow(window, widget);
+    DamageWidget(widget);
 
     return widget;
 }
@@ -356,15 +731,14 @@ LG_WidgetHandle LG_CreateTextField(LG_WindowHandle window, const char* text,
         return NULL;
     }
 
-    // Allocate widget structure
-    struct LG_Widget* widget = (struct LG_Widget*)malloc(sizeof(struct LG_Widget));
+    // Allocate widget structure from the window's pool
+    struct LG_Widget* widget = AllocWidget(window);
     if (!widget) {
         fprintf(stderr, "LightGUI: Failed to allocate text field widget\n");
         return NULL;
     }
 
     // Initialize widget structure
-    memset(widget, 0, sizeof(struct LG_Widget));
     widget->type = LG_WIDGET_TEXTFIELD;
     widget->window = window;
     widget->rect.x = x;
@@ -376,105 +750,440 @@ LG_WidgetHandle LG_CreateTextField(LG_WindowHandle window, const char* text,
     widget->bg_color = LG_COLOR_WHITE;
     widget->text_color = LG_COLOR_BLACK;
     
-    // Copy text
-    widget->text = STRDUP(text ? text : "");
-    if (!widget->text) {
+    // Copy text (short strings are stored inline)
+    if (!SetWidgetTextStorage(widget, text ? text : "")) {
         fprintf(stderr, "LightGUI: Failed to allocate text field text\n");
-        free(widget);
+        FreeWidget(widget);
         return NULL;
     }
 
-    // Create platform-specific widget
-    if (!LG_PlatformCreateWidget(widget)) {
+    // Add widget to window; the platform widget follows once it is in view
+    if (!AttachWidget(window, widget)) {
         fprintf(stderr, "LightGUI: Failed to create platform text field\n");
-        free(widget->text);
-        free(widget);
+        FreeWidget(widget);
         return NULL;
     }
-
-    // Add widget to window
-    AddWidgetToWindow(window, widget);
+    DamageWidget(widget);
 
     return widget;
 }
 
-void LG_DestroyWidget(LG_WidgetHandle widget) {
-    if (!g_initialized || !widget) {
-        return;
+LG_WidgetHandle LG_CreateCanvas(LG_WindowHandle window, int x, int y, int width, int height) {
+    if (!g_initialized || !window) {
+        return NULL;
     }
 
-    // Destroy platform-specific widget
-    LG_PlatformDestroyWidget(widget);
-
-    // Remove widget from window
-    LG_WindowHandle window = widget->window;
-    for (size_t i = 0; i < window->widgets.count; i++) {
-        if (window->widgets.widgets[i] == widget) {
-            // Move last widget to this position
-            window->widgets.widgets[i] = window->widgets.widgets[--window->widgets.count];
-            break;
-        }
+    // Allocate widget structure from the window's pool
+    struct LG_Widget* widget = AllocWidget(window);
+    if (!widget) {
+        fprintf(stderr, "LightGUI: Failed to allocate canvas widget\n");
+        return NULL;
     }
 
-    // Free widget resources
-    free(widget->text);
-    free(widget);
-}
-
-void LG_SetWidgetText(LG_WidgetHandle widget, const char* text) {
-    if (!g_initialized || !widget || !text) {
-        return;
+    // Initialize widget structure
+    widget->type = LG_WIDGET_CANVAS;
+    widget->window = window;
+    widget->rect.x = x;
+    widget->rect.y = y;
+    widget->rect.width = width;
+    widget->rect.height = height;
+    widget->visible = true;
+    widget->enabled = true;
+    widget->bg_color = LG_COLOR_WHITE;
+    widget->text_color = LG_COLOR_BLACK;
+    
+    // Canvases have no text, but the rest of the code expects a string
+    if (!SetWidgetTextStorage(widget, "")) {
+        fprintf(stderr, "LightGUI: Failed to allocate canvas text\n");
+        FreeWidget(widget);
+        return NULL;
     }
 
-    // Free old text and set new one
-    free(widget->text);
-    widget->text = STRDUP(text);
+    // Add widget to window; the platform widget follows once it is in view
+    if (!AttachWidget(window, widget)) {
+        fprintf(stderr, "LightGUI: Failed to create platform canvas\n");
+        FreeWidget(widget);
+        return NULL;
+    }
+    DamageWidget(widget);
 
-    // Update platform widget
-    LG_PlatformUpdateWidget(widget);
+    return widget;
 }
 
-int LG_GetWidgetText(LG_WidgetHandle widget, char* buffer, size_t buffer_size) {
-    if (!g_initialized || !widget || !buffer || buffer_size == 0) {
-        return -1;
+LG_WidgetHandle LG_CreateGLCanvas(LG_WindowHandle window, int x, int y, int width, int height) {
+    if (!g_initialized || !window) {
+        return NULL;
     }
 
-    if (!widget->text) {
-        buffer[0] = '\0';
-        return 0;
+    if (!LG_PlatformSupportsGL()) {
+        fprintf(stderr, "LightGUI: OpenGL canvases are not supported by this backend\n");
+        return NULL;
     }
 
-    size_t text_len = strlen(widget->text);
-    size_t copy_len = text_len < buffer_size - 1 ? text_len : buffer_size - 1;
-    
-    memcpy(buffer, widget->text, copy_len);
-    buffer[copy_len] = '\0';
-    
-    return (int)copy_len;
-}
-
-void LG_SetWidgetPosition(LG_WidgetHandle widget, int x, int y) {
-    if (!g_initialized || !widget) {
-        return;
+    // Allocate widget structure from the window's pool
+    struct LG_Widget* widget = AllocWidget(window);
+    if (!widget) {
+        fprintf(stderr, "LightGUI: Failed to allocate canvas widget\n");
+        return NULL;
     }
 
+    // Initialize widget structure
+    widget->type = LG_WIDGET_CANVAS;
+    widget->window = window;
     widget->rect.x = x;
     widget->rect.y = y;
-
-    // Update platform widget
-    LG_PlatformUpdateWidget(widget);
-}
-
-void LG_SetWidgetSize(LG_WidgetHandle widget, int width, int height) {
-    if (!g_initialized || !widget) {
-        return;
-    }
-
     widget->rect.width = width;
     widget->rect.height = height;
+    widget->visible = true;
+    widget->enabled = true;
+    widget->bg_color = LG_COLOR_BLACK;
+    widget->text_color = LG_COLOR_BLACK;
+
+    // The backend creates a context instead of a buffer for canvases with GL state
+    if (!SetWidgetTextStorage(widget, "") || !GLCanvasCreateState(widget)) {
+        fprintf(stderr, "LightGUI: Failed to allocate canvas state\n");
+        FreeWidget(widget);
+        return NULL;
+    }
+
+    // Add widget to window; the platform widget follows once it is in view
+    if (!AttachWidget(window, widget)) {
+        fprintf(stderr, "LightGUI: Failed to create OpenGL canvas\n");
+        FreeWidget(widget);
+        return NULL;
+    }
+    DamageWidget(widget);
+
+    return widget;
+}
+
+LG_WidgetHandle LG_CreateList(LG_WindowHandle window, int x, int y, int width, int height,
+                              int row_height) {
+    if (!g_initialized || !window) {
+        return NULL;
+    }
+
+    // Allocate widget structure from the window's pool
+    struct LG_Widget* widget = AllocWidget(window);
+    if (!widget) {
+        fprintf(stderr, "LightGUI: Failed to allocate list widget\n");
+        return NULL;
+    }
+
+    // Initialize widget structure
+    widget->type = LG_WIDGET_LIST;
+    widget->window = window;
+    widget->rect.x = x;
+    widget->rect.y = y;
+    widget->rect.width = width;
+    widget->rect.height = height;
+    widget->visible = true;
+    widget->enabled = true;
+    widget->windowless = window->windowless_widgets;
+    widget->bg_color = LG_COLOR_WHITE;
+    widget->text_color = LG_COLOR_BLACK;
+
+    // Rows carry their own text; the widget's text stays empty
+    if (!SetWidgetTextStorage(widget, "") || !ListCreateState(widget, row_height)) {
+        fprintf(stderr, "LightGUI: Failed to allocate list state\n");
+        FreeWidget(widget);
+        return NULL;
+    }
+
+    // Add widget to window; the platform widget follows once it is in view
+    if (!AttachWidget(window, widget)) {
+        fprintf(stderr, "LightGUI: Failed to create platform list\n");
+        FreeWidget(widget);
+        return NULL;
+    }
+    DamageWidget(widget);
+
+    return widget;
+}
+
+/**
+ * @brief Create one described widget without damaging it
+ */
+static struct LG_Widget* CreateDescribedWidget(LG_WindowHandle window, const LG_WidgetDesc* desc) {
+    struct LG_Widget* widget = AllocWidget(window);
+    if (!widget) {
+        return NULL;
+    }
+
+    // Same defaults as the LG_Create* function of each type
+    widget->type = desc->type;
+    widget->window = window;
+    widget->rect = desc->rect;
+    widget->visible = !(desc->flags & LG_WIDGET_DESC_HIDDEN);
+    widget->enabled = !(desc->flags & LG_WIDGET_DESC_DISABLED);
+    widget->windowless = window->windowless_widgets &&
+                         (desc->type == LG_WIDGET_BUTTON || desc->type == LG_WIDGET_LABEL ||
+                          desc->type == LG_WIDGET_LIST);
+    widget->bg_color = desc->type == LG_WIDGET_LABEL ? LG_COLOR_TRANSPARENT : LG_COLOR_WHITE;
+    widget->text_color = LG_COLOR_BLACK;
+    if (desc->flags & LG_WIDGET_DESC_BG_COLOR) {
+        widget->bg_color = desc->bg_color;
+    }
+    if (desc->flags & LG_WIDGET_DESC_TEXT_COLOR) {
+        widget->text_color = desc->text_color;
+    }
+
+    bool has_text = desc->text && desc->type != LG_WIDGET_CANVAS && desc->type != LG_WIDGET_LIST;
+    if (!SetWidgetTextStorage(widget, has_text ? desc->text : "") ||
+        (desc->type == LG_WIDGET_LIST && !ListCreateState(widget, desc->row_height))) {
+        FreeWidget(widget);
+        return NULL;
+    }
+
+    if (!AttachWidget(window, widget)) {
+        FreeWidget(widget);
+        return NULL;
+    }
+    return widget;
+}
+
+/**
+ * @brief Make room for count more widgets in a window's pool and lists
+ */
+static bool ReserveWidgets(LG_WindowHandle window, size_t count) {
+    if (!window->widget_pool) {
+        window->widget_pool = PoolCreate(sizeof(struct LG_Widget), 32);
+        if (!window->widget_pool) {
+            return false;
+        }
+    }
+    if (!PoolReserve(window->widget_pool, count)) {
+        return false;
+    }
+
+    LG_WidgetList* list = &window->widgets;
+    if (list->capacity - list->count < count) {
+        size_t capacity = list->count + count;
+        LG_WidgetHandle* widgets = (LG_WidgetHandle*)realloc(list->widgets,
+                                                             capacity * sizeof(LG_WidgetHandle));
+        if (!widgets) {
+            return false;
+        }
+        list->widgets = widgets;
+        list->capacity = capacity;
+        g_stats.heap_allocations++;
+    }
+    return true;
+}
+
+bool LG_CreateWidgets(LG_WindowHandle window, const LG_WidgetDesc* descs, size_t count,
+                      LG_WidgetHandle* out) {
+    if (!g_initialized || !window || (!descs && count > 0)) {
+        return false;
+    }
+
+    // Count the widgets realized right away, which need platform data
+    LG_Rect area = {0, 0, window->width, window->height};
+    size_t in_view = 0;
+    for (size_t i = 0; i < count; i++) {
+        LG_WidgetType type = descs[i].type;
+        if (type != LG_WIDGET_BUTTON && type != LG_WIDGET_LABEL && type != LG_WIDGET_TEXTFIELD &&
+            type != LG_WIDGET_CANVAS && type != LG_WIDGET_LIST) {
+            fprintf(stderr, "LightGUI: Unsupported widget type in description\n");
+            return false;
+        }
+        if (!(descs[i].flags & LG_WIDGET_DESC_HIDDEN) && RectIntersect(descs[i].rect, area, NULL)) {
+            in_view++;
+        }
+    }
+
+    if (!ReserveWidgets(window, count)) {
+        fprintf(stderr, "LightGUI: Failed to allocate widgets\n");
+        return false;
+    }
+
+    bool data_reserved = false;
+    size_t created = 0;
+    while (created < count) {
+        const LG_WidgetDesc* desc = &descs[created];
+        struct LG_Widget* widget = CreateDescribedWidget(window, desc);
+        if (!widget) {
+            break;
+        }
+
+        // The backend creates its data pool with the first realized widget
+        if (widget->realized && in_view > 0) {
+            in_view--;
+        }
+        if (!data_reserved && window->widget_data_pool) {
+            PoolReserve(window->widget_data_pool, in_view);
+            data_reserved = true;
+        }
+
+        DamageWidget(widget);
+        if (out) {
+            out[created] = widget;
+        }
+        created++;
+    }
+
+    if (created < count) {
+        fprintf(stderr, "LightGUI: Failed to create widget from description\n");
+
+        // The new widgets are the last ones in the window's list
+        while (created-- > 0) {
+            LG_DestroyWidget(window->widgets.widgets[window->widgets.count - 1]);
+            if (out) {
+                out[created] = NULL;
+            }
+        }
+        return false;
+    }
+
+    LG_Flush();
+    return true;
+}
+
+void* LG_GetCanvasContext(LG_WidgetHandle canvas) {
+    if (!g_initialized || !canvas || canvas->type != LG_WIDGET_CANVAS) {
+        return NULL;
+    }
+
+    // Drawing into a canvas that is out of view still needs its buffer
+    if (!RealizeWidget(canvas)) {
+        fprintf(stderr, "LightGUI: Failed to create platform canvas\n");
+        return NULL;
+    }
+    return LG_PlatformGetNativeHandle(canvas);
+}
+
+bool LG_GetCanvasBuffer(LG_WidgetHandle canvas, LG_CanvasBuffer* buffer) {
+    if (!g_initialized || !canvas || !buffer || canvas->type != LG_WIDGET_CANVAS || canvas->gl) {
+        return false;
+    }
+
+    if (!RealizeWidget(canvas)) {
+        fprintf(stderr, "LightGUI: Failed to create platform canvas\n");
+        return false;
+    }
+    return LG_PlatformGetCanvasBuffer(canvas, buffer);
+}
+
+void LG_UpdateCanvas(LG_WidgetHandle canvas) {
+    if (!canvas) {
+        return;
+    }
+
+    LG_Rect rect = {0, 0, canvas->rect.width, canvas->rect.height};
+    LG_UpdateCanvasRect(canvas, rect);
+}
+
+void LG_UpdateCanvasRect(LG_WidgetHandle canvas, LG_Rect rect) {
+    if (!g_initialized || !canvas || canvas->type != LG_WIDGET_CANVAS || !canvas->visible ||
+        !canvas->realized || canvas->gl) {
+        return;
+    }
+
+    LG_Rect bounds = {0, 0, canvas->rect.width, canvas->rect.height};
+    if (!RectIntersect(rect, bounds, &rect)) {
+        return;
+    }
+
+    LG_PlatformPresentCanvas(canvas, rect);
+    StatsPresented((uint64_t)rect.width * (uint64_t)rect.height);
+}
+
+void LG_DestroyWidget(LG_WidgetHandle widget) {
+    if (!g_initialized || !widget) {
+        return;
+    }
+
+    // Destroy platform-specific widget
+    DamageWidget(widget);
+    if (widget->realized) {
+        LG_PlatformDestroyWidget(widget);
+    } else {
+        widget->window->unrealized_count--;
+    }
+
+    // Remove widget from window
+    LG_WindowHandle window = widget->window;
+    SpatialRemove(window, widget);
+    RemoveWidget(&window->widgets, widget, true);
+    if (widget->dirty) {
+        RemoveWidget(&window->pending_updates, widget, false);
+    }
+
+    // Return the widget to the window's pool
+    FreeWidget(widget);
+}
+
+void LG_SetWidgetText(LG_WidgetHandle widget, const char* text) {
+    if (!g_initialized || !widget || !text) {
+        return;
+    }
+
+    // Nothing to do if the text is unchanged
+    if (widget->text && strcmp(widget->text, text) == 0) {
+        return;
+    }
+
+    // Reuse the existing buffer when the new text fits
+    if (!SetWidgetTextStorage(widget, text)) {
+        fprintf(stderr, "LightGUI: Failed to allocate widget text\n");
+        return;
+    }
+    DamageWidget(widget);
 
     // Update platform widget
-    LG_PlatformUpdateWidget(widget);
+    MarkWidgetDirty(widget, LG_WIDGET_DIRTY_TEXT);
+}
+
+int LG_GetWidgetText(LG_WidgetHandle widget, char* buffer, size_t buffer_size) {
+    if (!g_initialized || !widget || !buffer || buffer_size == 0) {
+        return -1;
+    }
+
+    if (!widget->text) {
+        buffer[0] = '\0';
+        return 0;
+    }
+
+    size_t text_len = strlen(widget->text);
+    size_t copy_len = text_len < buffer_size - 1 ? text_len : buffer_size - 1;
+    
+    memcpy(buffer, widget->text, copy_len);
+    buffer[copy_len] = '\0';
+    
+    return (int)copy_len;
+}
+
+void LG_SetWidgetPosition(LG_WidgetHandle widget, int x, int y) {
+    if (!g_initialized || !widget) {
+        return;
+    }
+
+    // Repaint both the area the widget leaves and the one it moves to
+    LG_Rect old_rect = widget->rect;
+    DamageWidget(widget);
+    widget->rect.x = x;
+    widget->rect.y = y;
+    SpatialMove(widget->window, widget, old_rect);
+    DamageWidget(widget);
+
+    // Update platform widget
+    MarkWidgetDirty(widget, LG_WIDGET_DIRTY_GEOMETRY);
+}
+
+void LG_SetWidgetSize(LG_WidgetHandle widget, int width, int height) {
+    if (!g_initialized || !widget) {
+        return;
+    }
+
+    LG_Rect old_rect = widget->rect;
+    DamageWidget(widget);
+    widget->rect.width = width;
+    widget->rect.height = height;
+    SpatialMove(widget->window, widget, old_rect);
+    DamageWidget(widget);
+
+    // Update platform widget
+    MarkWidgetDirty(widget, LG_WIDGET_DIRTY_GEOMETRY);
 }
 
 void LG_SetWidgetVisible(LG_WidgetHandle widget, bool visible) {
@@ -482,10 +1191,39 @@ void LG_SetWidgetVisible(LG_WidgetHandle widget, bool visible) {
         return;
     }
 
+    if (widget->visible && !visible) {
+        widget->hidden_since = LG_PlatformGetTime();
+    }
     widget->visible = visible;
+    DamageWindowRect(widget->window, widget->rect);
 
     // Update platform widget
-    LG_PlatformUpdateWidget(widget);
+    MarkWidgetDirty(widget, LG_WIDGET_DIRTY_VISIBILITY);
+}
+
+size_t LG_ReleaseHiddenWidgets(LG_WindowHandle window, uint32_t min_hidden_ms) {
+    if (!g_initialized || !window) {
+        return 0;
+    }
+
+    uint64_t now = LG_PlatformGetTime();
+    size_t released = 0;
+    for (size_t i = 0; i < window->widgets.count; i++) {
+        LG_WidgetHandle widget = window->widgets.widgets[i];
+        if (!widget->realized || widget->visible ||
+            now - widget->hidden_since < (uint64_t)min_hidden_ms * 1000) {
+            continue;
+        }
+
+        // Only the platform side knows a text field's edits or a canvas's pixels
+        if (widget->type == LG_WIDGET_TEXTFIELD || widget->type == LG_WIDGET_CANVAS) {
+            continue;
+        }
+
+        UnrealizeWidget(widget);
+        released++;
+    }
+    return released;
 }
 
 void LG_SetWidgetEnabled(LG_WidgetHandle widget, bool enabled) {
@@ -494,9 +1232,10 @@ void LG_SetWidgetEnabled(LG_WidgetHandle widget, bool enabled) {
     }
 
     widget->enabled = enabled;
+    DamageWidget(widget);
 
     // Update platform widget
-    LG_PlatformUpdateWidget(widget);
+    MarkWidgetDirty(widget, LG_WIDGET_DIRTY_ENABLED);
 }
 
 void LG_SetWidgetBackgroundColor(LG_WidgetHandle widget, LG_Color color) {
@@ -505,9 +1244,10 @@ void LG_SetWidgetBackgroundColor(LG_WidgetHandle widget, LG_Color color) {
     }
 
     widget->bg_color = color;
+    DamageWidget(widget);
 
     // Update platform widget
-    LG_PlatformUpdateWidget(widget);
+    MarkWidgetDirty(widget, LG_WIDGET_DIRTY_COLOR);
 }
 
 void LG_SetWidgetTextColor(LG_WidgetHandle widget, LG_Color color) {
@@ -516,9 +1256,37 @@ void LG_SetWidgetTextColor(LG_WidgetHandle widget, LG_Color color) {
     }
 
     widget->text_color = color;
+    DamageWidget(widget);
 
     // Update platform widget
-    LG_PlatformUpdateWidget(widget);
+    MarkWidgetDirty(widget, LG_WIDGET_DIRTY_COLOR);
+}
+
+void LG_BeginUpdate(LG_WindowHandle window) {
+    if (!g_initialized || !window) {
+        return;
+    }
+
+    window->update_depth++;
+}
+
+void LG_EndUpdate(LG_WindowHandle window) {
+    if (!g_initialized || !window || window->update_depth == 0) {
+        return;
+    }
+
+    if (--window->update_depth > 0 || window->pending_updates.count == 0) {
+        return;
+    }
+
+    LG_WidgetList* pending = &window->pending_updates;
+    LG_PlatformUpdateWidgets(pending->widgets, pending->count);
+    g_stats.widget_updates += pending->count;
+
+    for (size_t i = 0; i < pending->count; i++) {
+        pending->widgets[i]->dirty = 0;
+    }
+    pending->count = 0;
 }
 
 /* ========================================================================= */
@@ -534,42 +1302,540 @@ void LG_SetEventCallback(LG_WindowHandle window, LG_EventCallback callback, void
     window->user_data = user_data;
 }
 
+/**
+ * @brief Call a window's event callback
+ */
+static void CallEventCallback(LG_WindowHandle window, LG_Event* event) {
+    if ((unsigned)event->type < LG_EVENT_TYPE_COUNT) {
+        g_stats.events[event->type]++;
+    }
+
+    // Latency is measured from the first input delivered after a present
+    switch (event->type) {
+        case LG_EVENT_MOUSE_MOVE:
+        case LG_EVENT_MOUSE_BUTTON:
+        case LG_EVENT_KEY:
+        case LG_EVENT_WIDGET_CLICKED:
+            StatsInputReceived();
+            break;
+        default:
+            break;
+    }
+
+    if (window) {
+        RecordEvent(window, event);
+    }
+
+    if (window && window->event_callback) {
+        event->window = window;
+        uint64_t start = LG_PlatformGetTime();
+        window->event_callback(event, window->user_data);
+        g_stats.callback_us += LG_PlatformGetTime() - start;
+    }
+}
+
+/**
+ * @brief Send a mouse move event and remember the position for the next delta
+ */
+static void SendMotionEvent(LG_WindowHandle window, LG_Point position,
+                            const LG_Point* history, size_t history_count) {
+    LG_Event event;
+    memset(&event, 0, sizeof(event));
+    event.type = LG_EVENT_MOUSE_MOVE;
+    event.data.mouse_move.x = position.x;
+    event.data.mouse_move.y = position.y;
+    if (window->has_mouse_position) {
+        event.data.mouse_move.delta_x = position.x - window->last_mouse.x;
+        event.data.mouse_move.delta_y = position.y - window->last_mouse.y;
+    }
+    event.data.mouse_move.history = history;
+    event.data.mouse_move.history_count = history_count;
+
+    window->last_mouse = position;
+    window->has_mouse_position = true;
+
+    CallEventCallback(window, &event);
+}
+
+/**
+ * @brief Dispatch a window's coalesced motion, if any
+ */
+static void FlushWindowMotion(LG_WindowHandle window) {
+    if (!window->motion_pending) {
+        return;
+    }
+    window->motion_pending = false;
+
+    LG_Point position = window->pending_mouse;
+    if (window->motion_history_count > 0) {
+        SendMotionEvent(window, position, window->motion_history, window->motion_history_count);
+    } else {
+        SendMotionEvent(window, position, &position, 1);
+    }
+    window->motion_history_count = 0;
+}
+
+void DispatchWindowEvent(LG_WindowHandle window, LG_Event* event) {
+    if (!window) {
+        return;
+    }
+
+    FlushWindowMotion(window);
+    CallEventCallback(window, event);
+}
+
+void DispatchMouseMotion(LG_WindowHandle window, int x, int y) {
+    if (!window) {
+        return;
+    }
+
+    LG_Point position = {x, y};
+    if (window->motion_mode == LG_MOTION_EVERY_SAMPLE) {
+        SendMotionEvent(window, position, &position, 1);
+        return;
+    }
+
+    if (window->motion_mode == LG_MOTION_COALESCE_HISTORY) {
+        if (window->motion_history_count == window->motion_history_capacity) {
+            size_t capacity = window->motion_history_capacity ? window->motion_history_capacity * 2 : 64;
+            LG_Point* history = (LG_Point*)realloc(window->motion_history, capacity * sizeof(LG_Point));
+            if (history) {
+                window->motion_history = history;
+                window->motion_history_capacity = capacity;
+                g_stats.heap_allocations++;
+            }
+        }
+
+        // If the history cannot grow, the sample is still coalesced
+        if (window->motion_history_count < window->motion_history_capacity) {
+            window->motion_history[window->motion_history_count++] = position;
+        }
+    }
+
+    window->pending_mouse = position;
+    window->motion_pending = true;
+}
+
+void FlushPendingMotion(void) {
+    // A callback may destroy windows, so re-check the count on every step
+    for (size_t i = 0; i < g_windows.count; i++) {
+        FlushWindowMotion(g_windows.windows[i]);
+    }
+}
+
+void DispatchWindowResize(LG_WindowHandle window, int width, int height) {
+    if (width < 0) width = 0;
+    if (height < 0) height = 0;
+    if (width == window->width && height == window->height) {
+        return;  // A move, or a configure that only restates the size
+    }
+
+    window->width = width;
+    window->height = height;
+    window->resize_pending = true;
+}
+
+void FlushPendingResizes(void) {
+    // A callback may destroy windows, so re-check the count on every step
+    for (size_t i = 0; i < g_windows.count; i++) {
+        LG_WindowHandle window = g_windows.windows[i];
+        if (!window->resize_pending) continue;
+        window->resize_pending = false;
+
+        // Whatever the buffer held outside the old size is undefined
+        DamageWindow(window);
+        if (window->unrealized_count > 0) {
+            RealizeWidgetsInView(window);
+        }
+
+        LG_Event event;
+        event.type = LG_EVENT_WINDOW_RESIZE;
+        event.data.window_resize.width = window->width;
+        event.data.window_resize.height = window->height;
+        DispatchWindowEvent(window, &event);
+    }
+}
+
+bool BackBufferSize(int buffer_width, int buffer_height, int* width, int* height) {
+    int needed_width = *width > 0 ? *width : 1;
+    int needed_height = *height > 0 ? *height : 1;
+
+    bool fits = needed_width <= buffer_width && needed_height <= buffer_height;
+    bool wasteful = (int64_t)needed_width * needed_height * 4 < (int64_t)buffer_width * buffer_height;
+    if (fits && !wasteful) {
+        return false;
+    }
+
+    if (!wasteful) {
+        // Grow past the request so the next few steps of a drag fit as well
+        if (needed_width > buffer_width) {
+            int grown = buffer_width + buffer_width / 2;
+            needed_width = grown > needed_width ? grown : needed_width;
+        } else {
+            needed_width = buffer_width;
+        }
+        if (needed_height > buffer_height) {
+            int grown = buffer_height + buffer_height / 2;
+            needed_height = grown > needed_height ? grown : needed_height;
+        } else {
+            needed_height = buffer_height;
+        }
+    }
+
+    *width = needed_width;
+    *height = needed_height;
+    return true;
+}
+
+void LG_SetMotionMode(LG_WindowHandle window, LG_MotionMode mode) {
+    if (!g_initialized || !window) {
+        return;
+    }
+
+    // Deliver what was collected under the old mode first
+    FlushWindowMotion(window);
+    window->motion_mode = mode;
+}
+
+/**
+ * @brief Process platform events, timing them apart from the callbacks they run
+ */
+static bool ProcessPlatformEvents(void) {
+    uint64_t callback_us = g_stats.callback_us;
+    uint64_t start = LG_PlatformGetTime();
+    bool running = LG_PlatformProcessEvents();
+    uint64_t elapsed = LG_PlatformGetTime() - start;
+    uint64_t in_callbacks = g_stats.callback_us - callback_us;
+    g_stats.process_events_us += elapsed > in_callbacks ? elapsed - in_callbacks : 0;
+    return running;
+}
+
+/**
+ * @brief Send buffered requests, completing any open latency sample
+ */
+static void FlushPlatform(void) {
+    LG_PlatformFlush();
+    StatsFlushed();
+}
+
 bool LG_ProcessEvents(void) {
     if (!g_initialized) {
         return false;
     }
 
-    return LG_PlatformProcessEvents();
+    bool running = ProcessPlatformEvents();
+    PollProcesses();
+    RunPostedItems();
+    RunTimers();
+    RunReplay();
+    FlushBindings();
+    FlushPendingResizes();
+    FlushPendingMotion();
+    FlushPlatform();
+    return running;
 }
 
-void LG_RenderWindow(LG_WindowHandle window) {
-    if (!g_initialized || !window || !window->visible) {
+void LG_Flush(void) {
+    if (!g_initialized) {
         return;
     }
 
+    FlushPlatform();
+}
+
+/**
+ * @brief Present a window whose back buffer is drawn, and clear its damage
+ */
+static void PresentDamagedWindow(LG_WindowHandle window) {
+    uint64_t pixels = 0;
+    for (size_t i = 0; i < window->damage.count; i++) {
+        pixels += (uint64_t)window->damage.rects[i].width * (uint64_t)window->damage.rects[i].height;
+    }
+
     LG_PlatformRenderWindow(window);
+
+    window->damage.count = 0;
+    StatsPresented(pixels);
+}
+
+/**
+ * @brief Repaint a window's damaged areas, if it has any
+ */
+static void RenderDamagedWindow(LG_WindowHandle window) {
+    if (!window->visible || window->damage.count == 0) {
+        return;
+    }
+
+    uint64_t start = LG_PlatformGetTime();
+    LG_PlatformRasterizeWindow(window);
+    PresentDamagedWindow(window);
+    g_stats.render_us += LG_PlatformGetTime() - start;
+}
+
+/**
+ * @brief Do the parts of rasterizing a window that must stay on the main thread
+ */
+static void PrepareRasterize(LG_WindowHandle window) {
+    // Row callbacks are application code; call them here rather than on a render thread
+    LG_WidgetHandle* overlapping;
+    size_t overlapping_count = SpatialQuery(window, window->damage.rects, window->damage.count,
+                                            &overlapping);
+    for (size_t i = 0; i < overlapping_count; i++) {
+        if (overlapping[i]->type == LG_WIDGET_LIST && overlapping[i]->visible) {
+            ListPrepareRows(overlapping[i]);
+        }
+    }
+}
+
+static void RasterizeWindowItem(void* item) {
+    LG_PlatformRasterizeWindow((LG_WindowHandle)item);
+}
+
+/**
+ * @brief Rasterize all damaged windows on the render threads, then present them
+ * 
+ * @return false if the windows must be rendered one by one instead
+ */
+static bool RenderDamagedWindowsInParallel(void) {
+    if (WorkersCount() == 0 || !LG_PlatformCanRasterize()) {
+        return false;
+    }
+
+    if (g_render_batch_capacity < g_windows.count) {
+        void** batch = (void**)realloc(g_render_batch, g_windows.count * sizeof(void*));
+        if (!batch) {
+            return false;
+        }
+        g_render_batch = batch;
+        g_render_batch_capacity = g_windows.count;
+        g_stats.heap_allocations++;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < g_windows.count; i++) {
+        LG_WindowHandle window = g_windows.windows[i];
+        if (window->visible && window->damage.count > 0) {
+            PrepareRasterize(window);
+            g_render_batch[count++] = window;
+        }
+    }
+    if (count < 2) {
+        return false;
+    }
+
+    uint64_t start = LG_PlatformGetTime();
+
+    // The glyph atlas is built lazily; make sure that happens here
+    RasterTextHeight();
+    WorkersRun(RasterizeWindowItem, g_render_batch, count);
+
+    for (size_t i = 0; i < count; i++) {
+        PresentDamagedWindow((LG_WindowHandle)g_render_batch[i]);
+    }
+    g_stats.render_us += LG_PlatformGetTime() - start;
+    return true;
+}
+
+void RenderDamagedWindows(void) {
+    if (!RenderDamagedWindowsInParallel()) {
+        for (size_t i = 0; i < g_windows.count; i++) {
+            RenderDamagedWindow(g_windows.windows[i]);
+        }
+    }
+}
+
+void LG_RenderWindow(LG_WindowHandle window) {
+    if (!g_initialized || !window) {
+        return;
+    }
+
+    RenderDamagedWindow(window);
+    FlushPlatform();
+}
+
+void LG_RequestRedraw(LG_WindowHandle window) {
+    if (!g_initialized || !window) {
+        return;
+    }
+
+    DamageWindow(window);
+}
+
+void LG_SetFrameRate(int frames_per_second) {
+    g_frame_interval_us = frames_per_second > 0 ? 1000000 / (uint64_t)frames_per_second : 0;
+    g_next_frame_us = 0;
+}
+
+void LG_SetWaitForVBlank(bool enabled) {
+    g_wait_for_vblank = enabled;
+}
+
+bool LG_SetRenderThreads(int threads) {
+    if (!g_initialized) {
+        fprintf(stderr, "LightGUI: Not initialized\n");
+        return false;
+    }
+
+    return WorkersStart(threads < 0 ? 1 : threads);
+}
+
+/**
+ * @brief Pick the time of the frame after one rendered at now
+ */
+static uint64_t NextFrameTime(uint64_t now) {
+    uint64_t vblank, interval;
+    if (LG_PlatformGetVBlankTiming(&vblank, &interval) && interval > 0) {
+        // The first vblank at least half a refresh away, so that a frame
+        // rendered just before a vblank is not followed by another right after
+        uint64_t target = now + interval / 2;
+        if (vblank >= target) {
+            return vblank;
+        }
+        return vblank + ((target - vblank) / interval + 1) * interval;
+    }
+
+    return now + g_frame_interval_us;
+}
+
+/**
+ * @brief Render the damaged windows and animated OpenGL canvases if a frame is due
+ * 
+ * @return Microseconds until damaged windows can be rendered, 0 if they
+ *         were just rendered, or -1 if no window is damaged
+ */
+static int64_t RunFrame(void) {
+    bool damaged = GLCanvasesAnimating() || AnimationsRunning() || BindingsPending();
+    for (size_t i = 0; i < g_windows.count && !damaged; i++) {
+        LG_WindowHandle window = g_windows.windows[i];
+        damaged = window->resize_pending || (window->visible && window->damage.count > 0);
+    }
+    if (!damaged) {
+        return -1;
+    }
+
+    uint64_t now = LG_PlatformGetTime();
+    if (now < g_next_frame_us) {
+        return (int64_t)(g_next_frame_us - now);
+    }
+
+    // Bound text and animations change first, so the frame shows their new state
+    FlushBindings();
+    StepAnimations(now);
+    
+    // However many configure events arrived, lay out once for the final size
+    FlushPendingResizes();
+    RenderDamagedWindows();
+    RenderGLCanvases();
+
+    uint64_t frame_us = LG_PlatformGetTime() - now;
+    g_stats.frames++;
+    g_stats.last_frame_us = frame_us;
+    if (frame_us > g_stats.max_frame_us) {
+        g_stats.max_frame_us = frame_us;
+    }
+
+    g_next_frame_us = NextFrameTime(now);
+    return 0;
 }
 
 void LG_Run(void) {
     bool running = true;
+    g_event_loop_running = true;
     
-    while (running) {
+    while (running && g_event_loop_running) {
         // Process platform events
-        running = LG_PlatformProcessEvents();
+        running = ProcessPlatformEvents();
         
-        // Render all windows
-        for (size_t i = 0; i < g_windows.count; i++) {
-            LG_PlatformRenderWindow(g_windows.windows[i]);
+        // Deliver what child processes wrote and whether they exited
+        PollProcesses();
+        
+        // Run everything other threads posted since the last iteration
+        RunPostedItems();
+        
+        // Call the timers that are due
+        RunTimers();
+        
+        // Dispatch the replayed input that is due
+        RunReplay();
+        
+        // Deliver at most one coalesced motion event per window
+        FlushPendingMotion();
+        
+        // Repaint whatever changed in each window, once per frame
+        int64_t frame_wait_us = RunFrame();
+        
+        // Send everything produced by this iteration in one go
+        FlushPlatform();
+        
+        // Hold the loop until the compositor has taken the frame
+        if (frame_wait_us == 0 && g_wait_for_vblank) {
+            LG_PlatformWaitForVBlank();
+        }
+        
+        if (!running || !g_event_loop_running) {
+            break;
         }
         
-        // Add a small sleep to prevent excessive CPU usage
-        // This helps reduce flickering and event spam
-        SLEEP_MS(10);  // 10ms delay
+        // Don't sleep past a frame that is waiting to be rendered
+        int frame_wait_ms = frame_wait_us > 0 ? (int)((frame_wait_us + 999) / 1000) : -1;
+        
+        // Animations and animated canvases want the next frame even without new damage
+        if (frame_wait_us == 0 && (GLCanvasesAnimating() || AnimationsRunning())) {
+            uint64_t now = LG_PlatformGetTime();
+            frame_wait_ms = g_next_frame_us > now ? (int)((g_next_frame_us - now + 999) / 1000) : 0;
+        }
+        
+        if (g_run_mode == LG_RUN_MODE_WAIT) {
+            // Block until input, a wakeup, the timeout or the next frame arrives
+            int timeout_ms = g_run_timeout_ms;
+            if (frame_wait_ms >= 0 && (timeout_ms < 0 || frame_wait_ms < timeout_ms)) {
+                timeout_ms = frame_wait_ms;
+            }
+            LG_PlatformWaitEvents(ReplayWaitTimeout(TimersWaitTimeout(timeout_ms)));
+        } else {
+            // Add a small sleep to prevent excessive CPU usage
+            int sleep_ms = frame_wait_ms >= 0 && frame_wait_ms < 10 ? frame_wait_ms : 10;
+            SLEEP_MS(ReplayWaitTimeout(TimersWaitTimeout(sleep_ms)));
+        }
     }
+    
+    g_event_loop_running = false;
+}
+
+void LG_SetRunMode(LG_RunMode mode, int timeout_ms) {
+    g_run_mode = mode;
+    g_run_timeout_ms = timeout_ms < 0 ? -1 : timeout_ms;
+}
+
+bool LG_WaitEvents(int timeout_ms) {
+    if (!g_initialized) {
+        return false;
+    }
+
+    LG_PlatformWaitEvents(ReplayWaitTimeout(TimersWaitTimeout(timeout_ms < 0 ? -1 : timeout_ms)));
+    bool running = ProcessPlatformEvents();
+    PollProcesses();
+    RunPostedItems();
+    RunTimers();
+    RunReplay();
+    FlushBindings();
+    FlushPendingResizes();
+    FlushPendingMotion();
+    FlushPlatform();
+    return running;
+}
+
+void LG_PostWakeup(void) {
+    if (!g_initialized) {
+        return;
+    }
+
+    LG_PlatformWakeup();
 }
 
 void LG_QuitEventLoop(void) {
     g_event_loop_running = false;
+    LG_PostWakeup();
 }
 
 /* ========================================================================= */
@@ -11,14 +11,30 @@
 
 #include "../include/lightgui.h"
 #include <stddef.h>
+#include <stdbool.h>
 
 /* ========================================================================= */
 /*                        Internal Helper Functions                          */
 /* ========================================================================= */
 
+/**
+ * @brief Widget properties that changed since the last platform update
+ */
+enum {
+    LG_WIDGET_DIRTY_TEXT       = 1 << 0,
+    LG_WIDGET_DIRTY_GEOMETRY   = 1 << 1,
+    LG_WIDGET_DIRTY_VISIBILITY = 1 << 2,
+    LG_WIDGET_DIRTY_ENABLED    = 1 << 3,
+    LG_WIDGET_DIRTY_COLOR      = 1 << 4,
+    LG_WIDGET_DIRTY_ALL        = 0x1F
+};
+
 /* Global window list - declared here, defined in lightgui.c */
 extern LG_WindowList g_windows;
 
+/* Runtime counters - defined in stats.c, updated by the core on the main thread */
+extern LG_Stats g_stats;
+
 /**
  * @brief Add a widget to a window
  * 
@@ -27,4 +43,875 @@ extern LG_WindowList g_windows;
  */
 void AddWidgetToWindow(LG_WindowHandle window, LG_WidgetHandle widget);
 
+/**
+ * @brief Find the topmost visible windowless widget at a point
+ * 
+ * @param window The window
+ * @param x The x position in window coordinates
+ * @param y The y position in window coordinates
+ * @return The widget under the point, or NULL if there is none
+ */
+LG_WidgetHandle HitTestWidget(LG_WindowHandle window, int x, int y);
+
+/* ========================================================================= */
+/*                        Pool Allocation                                    */
+/* ========================================================================= */
+
+/**
+ * @brief Pool of fixed-size items allocated from growing slabs
+ */
+typedef struct LG_Pool LG_Pool;
+
+/**
+ * @brief Create a pool
+ * 
+ * @param item_size Size of every item
+ * @param initial_items Items in the first slab; later slabs double in size
+ * @return The pool, or NULL on allocation failure
+ */
+LG_Pool* PoolCreate(size_t item_size, size_t initial_items);
+
+/**
+ * @brief Destroy a pool and every item allocated from it
+ */
+void PoolDestroy(LG_Pool* pool);
+
+/**
+ * @brief Allocate a zeroed item, reusing freed items first
+ */
+void* PoolAlloc(LG_Pool* pool);
+
+/**
+ * @brief Return an item to its pool
+ */
+void PoolFree(LG_Pool* pool, void* item);
+
+/**
+ * @brief Make sure the next count allocations need no further slabs
+ * 
+ * @return false on allocation failure
+ */
+bool PoolReserve(LG_Pool* pool, size_t count);
+
+/**
+ * @brief Get the (aligned) item size of a pool
+ */
+size_t PoolItemSize(const LG_Pool* pool);
+
+/**
+ * @brief Get the number of items currently allocated from a pool
+ */
+size_t PoolLiveCount(const LG_Pool* pool);
+
+/**
+ * @brief Allocate zeroed platform data for a widget from its window's pool
+ * 
+ * Backends use this instead of malloc for their per-widget structure.
+ * 
+ * @param window The widget's window
+ * @param size Size of the platform structure; must be the same on every call
+ * @return The data, or NULL on failure
+ */
+void* AllocWidgetData(LG_WindowHandle window, size_t size);
+
+/**
+ * @brief Free platform data allocated with AllocWidgetData
+ */
+void FreeWidgetData(LG_WindowHandle window, void* data);
+
+/* ========================================================================= */
+/*                        Event Dispatch                                     */
+/* ========================================================================= */
+
+/**
+ * @brief Deliver an event to a window's callback
+ * 
+ * Any coalesced motion for the window is dispatched first so that the
+ * application sees events in the order they happened.
+ * 
+ * @param window The window
+ * @param event The event; its window field is filled in
+ */
+void DispatchWindowEvent(LG_WindowHandle window, LG_Event* event);
+
+/**
+ * @brief Report a pointer motion sample, honouring the window's motion mode
+ * 
+ * @param window The window
+ * @param x The x position in window coordinates
+ * @param y The y position in window coordinates
+ */
+void DispatchMouseMotion(LG_WindowHandle window, int x, int y);
+
+/**
+ * @brief Dispatch the coalesced motion of every window
+ * 
+ * Called once per event loop iteration, after platform events are processed.
+ */
+void FlushPendingMotion(void);
+
+/**
+ * @brief Report a new window size from the platform
+ * 
+ * Sizes equal to the current one are ignored. The window takes the size
+ * at once, but the repaint and LG_EVENT_WINDOW_RESIZE wait for
+ * FlushPendingResizes, so a drag resize is laid out once per frame.
+ * 
+ * @param window The window
+ * @param width The new client width
+ * @param height The new client height
+ */
+void DispatchWindowResize(LG_WindowHandle window, int width, int height);
+
+/**
+ * @brief Damage and report every window resized since the last call
+ * 
+ * LG_Run calls this when a frame is due, LG_ProcessEvents and
+ * LG_WaitEvents on every call.
+ */
+void FlushPendingResizes(void);
+
+/**
+ * @brief Decide whether a window's back buffer must be reallocated
+ * 
+ * Buffers grow by half again beyond what is needed, so a drag resize
+ * reallocates a few times rather than on every step, and are kept when
+ * the window shrinks unless it uses less than a quarter of them. Only
+ * the top-left window-sized part of a buffer is drawn and presented.
+ * 
+ * @param buffer_width Current buffer width, or 0 if there is none
+ * @param buffer_height Current buffer height
+ * @param width The window width; receives the new buffer width
+ * @param height The window height; receives the new buffer height
+ * @return true if a buffer of *width x *height must be allocated
+ */
+bool BackBufferSize(int buffer_width, int buffer_height, int* width, int* height);
+
+/**
+ * @brief Run the functions and user events posted from other threads
+ */
+void RunPostedItems(void);
+
+/**
+ * @brief Free everything still posted without running it
+ */
+void DiscardPostedItems(void);
+
+/* ========================================================================= */
+/*                        Statistics                                         */
+/* ========================================================================= */
+
+/**
+ * @brief Number of latency samples kept for LG_GetStats
+ */
+#define LG_LATENCY_WINDOW 256
+
+/**
+ * @brief Note that input was delivered; starts a latency sample if none is open
+ */
+void StatsInputReceived(void);
+
+/**
+ * @brief Count presented pixels; the next flush completes any open latency sample
+ * 
+ * @param pixels The number of pixels presented
+ */
+void StatsPresented(uint64_t pixels);
+
+/**
+ * @brief Note that presented pixels were flushed to the display
+ */
+void StatsFlushed(void);
+
+/**
+ * @brief Receives every completed latency sample, in microseconds
+ */
+typedef void (*LatencySink)(uint32_t latency_us);
+
+/**
+ * @brief Measure latency for a sink, whether or not tracking is enabled
+ * 
+ * @param sink The sink, or NULL to remove it
+ */
+void StatsSetLatencySink(LatencySink sink);
+
+/* ========================================================================= */
+/*                        Rectangles and Damage Tracking                     */
+/* ========================================================================= */
+
+/**
+ * @brief Compute the intersection of two rectangles
+ * 
+ * @param a The first rectangle
+ * @param b The second rectangle
+ * @param out Receives the intersection (may be NULL)
+ * @return true if the rectangles overlap
+ */
+bool RectIntersect(LG_Rect a, LG_Rect b, LG_Rect* out);
+
+/**
+ * @brief Compute the bounding rectangle of two rectangles
+ */
+LG_Rect RectUnion(LG_Rect a, LG_Rect b);
+
+/**
+ * @brief Add a rectangle to a window's damage region
+ * 
+ * The rectangle is clipped to the window. Overlapping rectangles are
+ * merged, and when the region is full the cheapest pair is combined.
+ * 
+ * @param window The window
+ * @param rect The area to repaint, in window coordinates
+ */
+void DamageWindowRect(LG_WindowHandle window, LG_Rect rect);
+
+/**
+ * @brief Mark the whole window as damaged
+ */
+void DamageWindow(LG_WindowHandle window);
+
+/**
+ * @brief Mark the area covered by a visible widget as damaged
+ */
+void DamageWidget(LG_WidgetHandle widget);
+
+/**
+ * @brief Whether a widget is shown and overlaps its window's area
+ */
+bool WidgetInView(LG_WidgetHandle widget);
+
+/**
+ * @brief Create the platform side of a widget from its current properties
+ * 
+ * Widgets are realized once they come into view; this does it earlier for
+ * callers that need the platform side, such as canvas drawing.
+ * 
+ * @return true if the widget is realized
+ */
+bool RealizeWidget(LG_WidgetHandle widget);
+
+/* ========================================================================= */
+/*                        Spatial Index                                      */
+/* ========================================================================= */
+
+typedef struct LG_SpatialIndex LG_SpatialIndex;
+
+/**
+ * @brief Add a widget to its window's spatial index at widget->rect
+ */
+void SpatialInsert(LG_WindowHandle window, LG_WidgetHandle widget);
+
+/**
+ * @brief Remove a widget from the spatial index; widget->rect must be the
+ *        rectangle it was indexed with
+ */
+void SpatialRemove(LG_WindowHandle window, LG_WidgetHandle widget);
+
+/**
+ * @brief Re-index a widget after widget->rect changed from old_rect
+ */
+void SpatialMove(LG_WindowHandle window, LG_WidgetHandle widget, LG_Rect old_rect);
+
+/**
+ * @brief Free a window's spatial index
+ */
+void SpatialDestroy(LG_WindowHandle window);
+
+/**
+ * @brief Find the topmost visible windowless widget containing a point
+ */
+LG_WidgetHandle SpatialHitTest(LG_WindowHandle window, int x, int y);
+
+/**
+ * @brief Find the widgets overlapping any of several rectangles
+ * 
+ * Each widget is reported once, bottom to top. Invisible and native
+ * widgets are included; callers filter as needed.
+ * 
+ * @param window The window
+ * @param rects The rectangles, in window coordinates
+ * @param rect_count The number of rectangles
+ * @param results Receives the widgets; valid until the next query
+ * @return The number of widgets found
+ */
+size_t SpatialQuery(LG_WindowHandle window, const LG_Rect* rects, int rect_count,
+                    LG_WidgetHandle** results);
+
+/* ========================================================================= */
+/*                        List Widgets                                       */
+/* ========================================================================= */
+
+/* Longest row text a list caches, including the terminator */
+#define LG_LIST_ROW_TEXT 256
+
+/* Rows scrolled per mouse wheel notch */
+#define LG_LIST_WHEEL_ROWS 3
+
+typedef struct LG_ListState LG_ListState;
+
+/**
+ * @brief Allocate the list state of a new list widget
+ */
+bool ListCreateState(LG_WidgetHandle list, int row_height);
+
+/**
+ * @brief Free the list state of a list widget
+ */
+void ListDestroyState(LG_WidgetHandle list);
+
+/**
+ * @brief Get the height of a list's rows
+ */
+int ListRowHeight(LG_WidgetHandle list);
+
+/**
+ * @brief Get the y position of a row, in list coordinates
+ */
+int ListRowY(LG_WidgetHandle list, size_t row);
+
+/**
+ * @brief Find the existing rows that overlap an area of a list
+ * 
+ * @param list The list widget
+ * @param area The area, in list coordinates
+ * @param first Receives the first row
+ * @param end Receives the row after the last one
+ * @return false if no row overlaps the area
+ */
+bool ListRowRange(LG_WidgetHandle list, LG_Rect area, size_t* first, size_t* end);
+
+/**
+ * @brief Check whether a row is the selected one
+ */
+bool ListRowSelected(LG_WidgetHandle list, size_t row);
+
+/**
+ * @brief Get a row's text, fetching it from the list's callback if needed
+ * 
+ * The string stays valid while the visible rows are drawn.
+ */
+const char* ListRowText(LG_WidgetHandle list, size_t row);
+
+/**
+ * @brief Fetch the text of every visible row into the list's row cache
+ * 
+ * Drawing the rows afterwards calls no callback, so it can happen off the
+ * main thread.
+ */
+void ListPrepareRows(LG_WidgetHandle list);
+
+/**
+ * @brief Scroll a list by a number of rows (negative scrolls up)
+ */
+void ListScrollBy(LG_WidgetHandle list, long rows);
+
+/**
+ * @brief Select the row at y, in list coordinates
+ */
+void ListClick(LG_WidgetHandle list, int y);
+
+/**
+ * @brief Repaint part of a native list from its rows
+ * 
+ * @param list The list widget
+ * @param rect The area, in list coordinates
+ */
+void LG_PlatformRedrawList(LG_WidgetHandle list, LG_Rect rect);
+
+/**
+ * @brief Scroll the pixels of a native list and draw the uncovered rows
+ * 
+ * @param list The list widget
+ * @param dy The distance to move the contents (negative moves them up)
+ */
+void LG_PlatformScrollList(LG_WidgetHandle list, int dy);
+
+/* ========================================================================= */
+/*                        Platform Widget Updates                            */
+/* ========================================================================= */
+
+/**
+ * @brief Apply the dirty properties of several widgets at once
+ * 
+ * Each widget's dirty flags say which properties to apply. The core
+ * clears the flags afterwards.
+ * 
+ * @param widgets The widgets to update
+ * @param count The number of widgets
+ */
+void LG_PlatformUpdateWidgets(LG_WidgetHandle* widgets, size_t count);
+
+/**
+ * @brief Send all buffered drawing and window requests to the display
+ * 
+ * The core calls this once per event loop iteration; backends must not
+ * flush after individual requests.
+ */
+void LG_PlatformFlush(void);
+
+/* ========================================================================= */
+/*                        Software Rasterizer                                */
+/* ========================================================================= */
+
+/**
+ * @brief Pick the fastest span kernels the CPU supports
+ * 
+ * Setting LIGHTGUI_SIMD=0 in the environment forces the scalar kernels.
+ */
+void RasterInitialize(void);
+
+/**
+ * @brief Get the name of the kernels in use ("scalar", "sse2", "avx2" or "neon")
+ */
+const char* RasterKernelName(void);
+
+/**
+ * @brief Free the glyph atlas; called before the platform shuts down
+ */
+void RasterTerminate(void);
+
+/* ========================================================================= */
+/*                        Glyph Atlas                                        */
+/* ========================================================================= */
+
+/* The atlas covers printable ASCII */
+#define LG_GLYPH_FIRST 32
+#define LG_GLYPH_COUNT 95
+
+/**
+ * @brief Coverage bitmaps and metrics of the default font
+ * 
+ * Glyphs sit side by side in cells of cell_width pixels. The pen position
+ * of glyph i is at x = i * cell_width + origin_x and the baseline at
+ * y = ascent, so glyphs that extend left of the pen still fit.
+ */
+typedef struct {
+    int ascent;
+    int descent;
+    int cell_width;
+    int origin_x;
+    int advance[LG_GLYPH_COUNT];
+    uint8_t* coverage;  // LG_GLYPH_COUNT * cell_width by ascent + descent, 0-255
+    int stride;  // Bytes per coverage row
+} LG_GlyphAtlas;
+
+/**
+ * @brief Rasterize the default font into an atlas
+ * 
+ * The backend allocates atlas->coverage with malloc; the core frees it.
+ * 
+ * @return true on success
+ */
+bool LG_PlatformBuildGlyphAtlas(LG_GlyphAtlas* atlas);
+
+/* ========================================================================= */
+/*                        Platform Canvas Support                            */
+/* ========================================================================= */
+
+/**
+ * @brief Get the native handle of a widget (HWND on Windows, Window on X11)
+ */
+void* LG_PlatformGetNativeHandle(LG_WidgetHandle widget);
+
+/**
+ * @brief Get the CPU pixel buffer of a canvas widget
+ * 
+ * Waits for any present that is still reading the buffer.
+ */
+bool LG_PlatformGetCanvasBuffer(LG_WidgetHandle canvas, LG_CanvasBuffer* buffer);
+
+/**
+ * @brief Present an area of a canvas's pixel buffer
+ * 
+ * @param canvas The canvas widget
+ * @param rect The area to present, in canvas coordinates
+ */
+void LG_PlatformPresentCanvas(LG_WidgetHandle canvas, LG_Rect rect);
+
+/* ========================================================================= */
+/*                        Platform Event Waiting                             */
+/* ========================================================================= */
+
+/**
+ * @brief Something the event loop waits on besides input and wakeups
+ * 
+ * A file descriptor to poll for input on POSIX systems, a HANDLE to wait
+ * for on Windows.
+ */
+#ifdef _WIN32
+typedef void* LG_WaitHandle;
+#else
+typedef int LG_WaitHandle;
+#endif
+
+/* Most handles passed to a wait, within MsgWaitForMultipleObjects' limit */
+#define LG_MAX_WAIT_HANDLES 60
+
+/**
+ * @brief Block until platform events are pending or the timeout expires
+ * 
+ * Also returns when a child process has output or has exited.
+ * 
+ * @param timeout_ms Maximum time to wait in milliseconds, or -1 to wait forever
+ * @return true if events or a wakeup are pending, false on timeout
+ */
+bool LG_PlatformWaitEvents(int timeout_ms);
+
+/**
+ * @brief Wake a thread blocked in LG_PlatformWaitEvents
+ * 
+ * Must be safe to call from any thread.
+ */
+void LG_PlatformWakeup(void);
+
+/* ========================================================================= */
+/*                        Child Processes                                    */
+/* ========================================================================= */
+
+/**
+ * @brief Get what the event loop must wait on for child processes
+ * 
+ * @param handles Receives at most LG_MAX_WAIT_HANDLES handles
+ * @return The number of handles
+ */
+size_t ProcessWaitHandles(LG_WaitHandle* handles);
+
+/**
+ * @brief Limit a wait so exits that have no handle to wait on are noticed
+ * 
+ * @param timeout_ms The timeout the event loop wants, or -1
+ * @return The timeout to wait with
+ */
+int ProcessWaitTimeout(int timeout_ms);
+
+/**
+ * @brief Deliver the output and exits of child processes
+ * 
+ * Called after platform events on every event loop iteration.
+ */
+void PollProcesses(void);
+
+/**
+ * @brief Kill, reap and free the processes of a window without events
+ */
+void DestroyWindowProcesses(LG_WindowHandle window);
+
+/* ========================================================================= */
+/*                        Timers and Animations                              */
+/* ========================================================================= */
+
+/**
+ * @brief Shorten a wait so that it ends when the next timer is due
+ * 
+ * @param timeout_ms The timeout the event loop wants, or -1
+ * @return The timeout to wait with
+ */
+int TimersWaitTimeout(int timeout_ms);
+
+/**
+ * @brief Call the callbacks of the timers that are due
+ * 
+ * Called after posted functions on every event loop iteration.
+ */
+void RunTimers(void);
+
+/**
+ * @brief Check whether any widget is being animated
+ */
+bool AnimationsRunning(void);
+
+/**
+ * @brief Advance every animation to a point in time, finishing those that end by then
+ * 
+ * This is what LG_Run does at the start of each frame.
+ */
+void StepAnimations(uint64_t now);
+
+/**
+ * @brief Stop the animations of a widget that is being destroyed
+ */
+void CancelWidgetAnimations(LG_WidgetHandle widget);
+
+/**
+ * @brief Free all timers and animations; called by LG_Terminate
+ */
+void TimersTerminate(void);
+
+/* ========================================================================= */
+/*                        Data Binding                                       */
+/* ========================================================================= */
+
+/**
+ * @brief Check whether sources were written since the last frame
+ */
+bool BindingsPending(void);
+
+/**
+ * @brief Apply the latest value of every written source to its widgets
+ * 
+ * This is what LG_Run does at the start of each frame.
+ */
+void FlushBindings(void);
+
+/**
+ * @brief Destroy all sources; called by LG_Terminate after the windows
+ */
+void BindingsTerminate(void);
+
+/* ========================================================================= */
+/*                        Recording and Replay                               */
+/* ========================================================================= */
+
+/**
+ * @brief Write an event reaching a callback to the recording, if one is open
+ * 
+ * @param window The window the event is for
+ * @param event The event
+ */
+void RecordEvent(LG_WindowHandle window, const LG_Event* event);
+
+/**
+ * @brief Dispatch the replayed events that are due
+ * 
+ * Called after the timers on every event loop iteration.
+ */
+void RunReplay(void);
+
+/**
+ * @brief Shorten a wait so that it ends when the next replayed event is due
+ * 
+ * @param timeout_ms The timeout the event loop wants, or -1
+ * @return The timeout to wait with
+ */
+int ReplayWaitTimeout(int timeout_ms);
+
+/**
+ * @brief Close any recording and abandon any replay; called by LG_Terminate
+ */
+void ReplayTerminate(void);
+
+/* ========================================================================= */
+/*                        Platform Timing                                    */
+/* ========================================================================= */
+
+/**
+ * @brief Get a monotonic timestamp in microseconds
+ */
+uint64_t LG_PlatformGetTime(void);
+
+/**
+ * @brief Get the display's vertical blank timing
+ * 
+ * @param last_vblank Receives the time of a recent vblank, on the
+ *        LG_PlatformGetTime clock
+ * @param interval Receives the refresh interval in microseconds
+ * @return false if the platform does not report vblank timing
+ */
+bool LG_PlatformGetVBlankTiming(uint64_t* last_vblank, uint64_t* interval);
+
+/**
+ * @brief Block until the compositor has shown the frame just presented
+ * 
+ * @return false if the platform cannot wait for the compositor
+ */
+bool LG_PlatformWaitForVBlank(void);
+
+/* ========================================================================= */
+/*                        OpenGL Canvases                                    */
+/* ========================================================================= */
+
+/**
+ * @brief Check whether the backend can create OpenGL canvases
+ */
+bool LG_PlatformSupportsGL(void);
+
+/**
+ * @brief Make an OpenGL canvas's context current on the calling thread
+ */
+bool LG_PlatformGLMakeCurrent(LG_WidgetHandle canvas);
+
+/**
+ * @brief Present the back buffer of an OpenGL canvas
+ */
+void LG_PlatformGLSwapBuffers(LG_WidgetHandle canvas);
+
+/**
+ * @brief Set the swap interval of the current context, which is canvas's
+ * 
+ * @return false if the platform cannot change it
+ */
+bool LG_PlatformGLSetSwapInterval(LG_WidgetHandle canvas, int interval);
+
+typedef struct LG_GLCanvasState LG_GLCanvasState;
+
+/**
+ * @brief Allocate the OpenGL state of a new canvas, before it is realized
+ */
+bool GLCanvasCreateState(LG_WidgetHandle canvas);
+
+/**
+ * @brief Free the OpenGL state of a canvas
+ */
+void GLCanvasDestroyState(LG_WidgetHandle canvas);
+
+/**
+ * @brief Check whether a shown OpenGL canvas has a render callback
+ */
+bool GLCanvasesAnimating(void);
+
+/**
+ * @brief Call the render callback of every shown OpenGL canvas and present it
+ * 
+ * This is what LG_Run does once per frame after repainting windows.
+ */
+void RenderGLCanvases(void);
+
+/* ========================================================================= */
+/*                        Parallel Rendering                                 */
+/* ========================================================================= */
+
+/**
+ * @brief Check whether the backend draws windows with LG_PlatformRasterizeWindow
+ */
+bool LG_PlatformCanRasterize(void);
+
+/**
+ * @brief Draw the damaged parts of a window's back buffer without presenting them
+ * 
+ * Backends that implement this only present in LG_PlatformRenderWindow,
+ * which the core calls next. It may run on a render thread, concurrently
+ * with other windows, so it must only touch the window, its widgets and
+ * their buffers. List rows and the glyph atlas are prepared beforehand.
+ */
+void LG_PlatformRasterizeWindow(LG_WindowHandle window);
+
+/**
+ * @brief Repaint every damaged window, on the render threads where possible
+ * 
+ * This is what LG_Run does once per frame.
+ */
+void RenderDamagedWindows(void);
+
+/**
+ * @brief Start the render threads, or stop them for threads <= 1
+ * 
+ * @param threads Threads including the main thread, or 0 for one per processor
+ * @return false if the threads could not be started
+ */
+bool WorkersStart(int threads);
+
+/**
+ * @brief Stop the render threads
+ */
+void WorkersStop(void);
+
+/**
+ * @brief Call func for every item, spread over the render threads
+ * 
+ * The main thread takes part and the call returns once all items are done.
+ * Without render threads the items run in order on the calling thread.
+ */
+void WorkersRun(void (*func)(void* item), void** items, size_t count);
+
+/**
+ * @brief Get the number of render threads besides the main thread
+ */
+int WorkersCount(void);
+
+/* ========================================================================= */
+/*                        Platform Backends                                  */
+/* ========================================================================= */
+
+/**
+ * @brief The platform hooks of one backend
+ * 
+ * The LG_Platform* functions above forward to the backend picked by
+ * LG_InitializeBackend. Each entry has the contract of the function of
+ * the same name. The last entries are optional and NULL where a backend
+ * does not support them.
+ */
+typedef struct {
+    const char* name;
+    bool (*initialize)(void);
+    void (*terminate)(void);
+    bool (*create_window)(LG_WindowHandle window);
+    void (*destroy_window)(LG_WindowHandle window);
+    void (*show_window)(LG_WindowHandle window);
+    void (*hide_window)(LG_WindowHandle window);
+    void (*set_window_title)(LG_WindowHandle window, const char* title);
+    bool (*create_widget)(LG_WidgetHandle widget);
+    void (*destroy_widget)(LG_WidgetHandle widget);
+    void (*update_widget)(LG_WidgetHandle widget);
+    void (*update_widgets)(LG_WidgetHandle* widgets, size_t count);
+    bool (*process_events)(void);
+    /* Also returns when any of handles is ready, as from ProcessWaitHandles */
+    bool (*wait_events)(int timeout_ms, const LG_WaitHandle* handles, size_t handle_count);
+    void (*wakeup)(void);
+    uint64_t (*get_time)(void);
+    bool (*get_vblank_timing)(uint64_t* last_vblank, uint64_t* interval);
+    void (*render_window)(LG_WindowHandle window);
+    void* (*get_native_handle)(LG_WidgetHandle widget);
+    bool (*get_canvas_buffer)(LG_WidgetHandle canvas, LG_CanvasBuffer* buffer);
+    void (*present_canvas)(LG_WidgetHandle canvas, LG_Rect rect);
+    void (*redraw_list)(LG_WidgetHandle list, LG_Rect rect);
+    void (*scroll_list)(LG_WidgetHandle list, int dy);
+    bool (*build_glyph_atlas)(LG_GlyphAtlas* atlas);
+    void (*flush)(void);
+    
+    /* Queue a synthetic event for a window, delivered by process_events */
+    bool (*inject_event)(LG_WindowHandle window, const LG_Event* event);
+    /* Get the rendered pixels of a window */
+    bool (*get_window_frame)(LG_WindowHandle window, LG_CanvasBuffer* frame);
+    /* Draw a window's back buffer off the main thread; render_window then presents */
+    void (*rasterize_window)(LG_WindowHandle window);
+    /* Block until the compositor has shown what was presented */
+    bool (*wait_for_vblank)(void);
+    /* OpenGL canvases; create_widget gives canvases with gl state a context */
+    bool (*gl_make_current)(LG_WidgetHandle canvas);
+    void (*gl_swap_buffers)(LG_WidgetHandle canvas);
+    bool (*gl_set_swap_interval)(LG_WidgetHandle canvas, int interval);
+} LG_PlatformBackend;
+
+/* The X11 or Win32 backend, defined in platform/ */
+extern const LG_PlatformBackend g_native_backend;
+
+/* In-memory surfaces and synthetic input, defined in platform/headless.c */
+extern const LG_PlatformBackend g_headless_backend;
+
+/**
+ * @brief Pick the backend the LG_Platform* functions forward to
+ * 
+ * LG_BACKEND_DEFAULT reads LIGHTGUI_BACKEND from the environment
+ * ("native" or "headless") and falls back to the native backend.
+ * Only called while the framework is not initialized.
+ */
+void PlatformSelectBackend(LG_Backend backend);
+
+/* ========================================================================= */
+/*                        Raster Targets                                     */
+/* ========================================================================= */
+
+/*
+ * The canvas primitives operate on any pixel buffer through these, so
+ * backends that render in software can draw widgets with the same
+ * kernels. Drawing is clipped to the buffer.
+ */
+
+/**
+ * @brief Fill or blend a rectangle into a pixel buffer
+ */
+void RasterFillRect(const LG_CanvasBuffer* buffer, LG_Rect rect, LG_Color color);
+
+/**
+ * @brief Draw a line of text with its top-left corner at (x, y)
+ * 
+ * @return The width of the text in pixels, or 0 without a glyph atlas
+ */
+int RasterDrawText(const LG_CanvasBuffer* buffer, int x, int y, const char* text, LG_Color color);
+
+/**
+ * @brief Get the line height of the glyph atlas, or 0 without one
+ */
+int RasterTextHeight(void);
+
 #endif /* LIGHTGUI_INTERNAL_H */
\ No newline at end of file
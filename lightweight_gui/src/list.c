@@ -0,0 +1,335 @@
+/**
+ * @file list.c
+ * @brief Virtual list widgets
+ *
+ * A list holds no per-row widgets. Its rows come from a callback, and only
+ * rows that are visible are ever asked for. Their text is kept in a ring
+ * of slots indexed by row number, so scrolling by a few rows fetches only
+ * the rows that come into view. Native lists scroll by moving the pixels
+ * already drawn and painting just the uncovered strip.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Cached text of one visible row
+ */
+typedef struct {
+    size_t row;
+    bool valid;
+    char text[LG_LIST_ROW_TEXT];
+} ListRowSlot;
+
+struct LG_ListState {
+    int row_height;
+    size_t row_count;
+    size_t top_row;  // First visible row
+    size_t selection;  // LG_LIST_NO_SELECTION if none
+    LG_ListRowCallback callback;
+    void* user_data;
+    ListRowSlot* slots;  // Row r lives in slot r % slot_count
+    size_t slot_count;
+};
+
+static bool IsList(LG_WidgetHandle widget) {
+    return widget && widget->type == LG_WIDGET_LIST && widget->list;
+}
+
+/**
+ * @brief Number of rows that fit in the list, counting a partial last row
+ */
+static size_t VisibleRows(LG_WidgetHandle list) {
+    int height = list->rect.height > 0 ? list->rect.height : 0;
+    return (size_t)((height + list->list->row_height - 1) / list->list->row_height);
+}
+
+/**
+ * @brief Largest top row that still fills the list
+ */
+static size_t MaxTopRow(LG_WidgetHandle list) {
+    size_t full_rows = (size_t)(list->rect.height / list->list->row_height);
+    return list->list->row_count > full_rows ? list->list->row_count - full_rows : 0;
+}
+
+static void InvalidateSlots(LG_ListState* state) {
+    for (size_t i = 0; i < state->slot_count; i++) {
+        state->slots[i].valid = false;
+    }
+}
+
+/**
+ * @brief Repaint part of a list, given in list coordinates
+ */
+static void RedrawList(LG_WidgetHandle list, LG_Rect rect) {
+    if (!list->visible) {
+        return;
+    }
+
+    if (list->windowless) {
+        rect.x += list->rect.x;
+        rect.y += list->rect.y;
+        DamageWindowRect(list->window, rect);
+    } else {
+        LG_PlatformRedrawList(list, rect);
+    }
+}
+
+static void RedrawRows(LG_WidgetHandle list, size_t first, size_t end) {
+    LG_ListState* state = list->list;
+    if (end <= state->top_row || first >= state->top_row + VisibleRows(list)) {
+        return;
+    }
+
+    if (first < state->top_row) first = state->top_row;
+    size_t last_visible = state->top_row + VisibleRows(list);
+    if (end > last_visible) end = last_visible;
+
+    LG_Rect rect = {0, ListRowY(list, first), list->rect.width,
+                    (int)(end - first) * state->row_height};
+    RedrawList(list, rect);
+}
+
+/* ========================================================================= */
+/*                        Internal Interface                                 */
+/* ========================================================================= */
+
+bool ListCreateState(LG_WidgetHandle list, int row_height) {
+    list->list = (LG_ListState*)calloc(1, sizeof(LG_ListState));
+    if (!list->list) {
+        return false;
+    }
+
+    list->list->row_height = row_height > 0 ? row_height : 1;
+    list->list->selection = LG_LIST_NO_SELECTION;
+    return true;
+}
+
+void ListDestroyState(LG_WidgetHandle list) {
+    if (!list->list) {
+        return;
+    }
+
+    free(list->list->slots);
+    free(list->list);
+    list->list = NULL;
+}
+
+int ListRowHeight(LG_WidgetHandle list) {
+    return list->list->row_height;
+}
+
+int ListRowY(LG_WidgetHandle list, size_t row) {
+    return (int)(row - list->list->top_row) * list->list->row_height;
+}
+
+bool ListRowRange(LG_WidgetHandle list, LG_Rect area, size_t* first, size_t* end) {
+    LG_ListState* state = list->list;
+    LG_Rect bounds = {0, 0, list->rect.width, list->rect.height};
+    if (!RectIntersect(area, bounds, &area)) {
+        return false;
+    }
+
+    *first = state->top_row + (size_t)(area.y / state->row_height);
+    *end = state->top_row + (size_t)((area.y + area.height + state->row_height - 1) /
+                                     state->row_height);
+    if (*end > state->row_count) *end = state->row_count;
+    return *first < *end;
+}
+
+bool ListRowSelected(LG_WidgetHandle list, size_t row) {
+    return list->list->selection == row;
+}
+
+const char* ListRowText(LG_WidgetHandle list, size_t row) {
+    LG_ListState* state = list->list;
+    if (!state->callback || row >= state->row_count) {
+        return "";
+    }
+
+    // One slot per visible row plus one for the partly scrolled-in row
+    size_t needed = VisibleRows(list) + 1;
+    if (state->slot_count < needed) {
+        ListRowSlot* slots = (ListRowSlot*)realloc(state->slots, needed * sizeof(ListRowSlot));
+        if (!slots) {
+            fprintf(stderr, "LightGUI: Failed to grow list row cache\n");
+            return "";
+        }
+        state->slots = slots;
+        state->slot_count = needed;
+        InvalidateSlots(state);  // Rows map to different slots now
+    }
+
+    ListRowSlot* slot = &state->slots[row % state->slot_count];
+    if (!slot->valid || slot->row != row) {
+        slot->text[0] = '\0';
+        state->callback(list, row, slot->text, sizeof(slot->text), state->user_data);
+        slot->text[sizeof(slot->text) - 1] = '\0';
+        slot->row = row;
+        slot->valid = true;
+    }
+    return slot->text;
+}
+
+void ListPrepareRows(LG_WidgetHandle list) {
+    LG_Rect area = {0, 0, list->rect.width, list->rect.height};
+    size_t first, end;
+    if (ListRowRange(list, area, &first, &end)) {
+        for (size_t row = first; row < end; row++) {
+            ListRowText(list, row);
+        }
+    }
+}
+
+void ListScrollBy(LG_WidgetHandle list, long rows) {
+    if (!IsList(list) || rows == 0) {
+        return;
+    }
+
+    size_t top = list->list->top_row;
+    if (rows < 0) {
+        top = (size_t)-rows > top ? 0 : top - (size_t)-rows;
+    } else {
+        top += (size_t)rows;
+    }
+    LG_ScrollList(list, top);
+}
+
+void ListClick(LG_WidgetHandle list, int y) {
+    if (!IsList(list) || y < 0) {
+        return;
+    }
+
+    size_t row = list->list->top_row + (size_t)(y / list->list->row_height);
+    if (row < list->list->row_count) {
+        LG_SetListSelection(list, row);
+    }
+}
+
+/* ========================================================================= */
+/*                        Public API                                         */
+/* ========================================================================= */
+
+void LG_SetListSource(LG_WidgetHandle list, size_t row_count,
+                      LG_ListRowCallback callback, void* user_data) {
+    if (!IsList(list)) {
+        return;
+    }
+
+    LG_ListState* state = list->list;
+    state->callback = callback;
+    state->user_data = user_data;
+    state->row_count = row_count;
+    state->top_row = 0;
+    state->selection = LG_LIST_NO_SELECTION;
+    InvalidateSlots(state);
+
+    LG_Rect rect = {0, 0, list->rect.width, list->rect.height};
+    RedrawList(list, rect);
+}
+
+void LG_SetListRowCount(LG_WidgetHandle list, size_t row_count) {
+    if (!IsList(list) || list->list->row_count == row_count) {
+        return;
+    }
+
+    LG_ListState* state = list->list;
+    size_t old_count = state->row_count;
+    state->row_count = row_count;
+
+    if (state->selection != LG_LIST_NO_SELECTION && state->selection >= row_count) {
+        state->selection = LG_LIST_NO_SELECTION;
+    }
+
+    // Rows before the change keep their text; later ones appear or vanish
+    if (state->top_row > MaxTopRow(list)) {
+        state->top_row = MaxTopRow(list);
+        InvalidateSlots(state);
+        LG_Rect rect = {0, 0, list->rect.width, list->rect.height};
+        RedrawList(list, rect);
+    } else {
+        size_t first = old_count < row_count ? old_count : row_count;
+        RedrawRows(list, first, state->top_row + VisibleRows(list));
+    }
+}
+
+void LG_InvalidateListRows(LG_WidgetHandle list, size_t first_row, size_t count) {
+    if (!IsList(list) || count == 0) {
+        return;
+    }
+
+    LG_ListState* state = list->list;
+    size_t end = count > SIZE_MAX - first_row ? SIZE_MAX : first_row + count;
+    for (size_t i = 0; i < state->slot_count; i++) {
+        if (state->slots[i].row >= first_row && state->slots[i].row < end) {
+            state->slots[i].valid = false;
+        }
+    }
+    RedrawRows(list, first_row, end);
+}
+
+void LG_ScrollList(LG_WidgetHandle list, size_t top_row) {
+    if (!IsList(list)) {
+        return;
+    }
+
+    LG_ListState* state = list->list;
+    if (top_row > MaxTopRow(list)) {
+        top_row = MaxTopRow(list);
+    }
+    if (top_row == state->top_row) {
+        return;
+    }
+
+    size_t distance = top_row > state->top_row ? top_row - state->top_row
+                                               : state->top_row - top_row;
+    bool down = top_row > state->top_row;
+    state->top_row = top_row;
+
+    if (!list->visible) {
+        return;
+    }
+
+    // Rows still on screen move; only the uncovered strip is drawn
+    if (!list->windowless && distance < VisibleRows(list)) {
+        int dy = (int)distance * state->row_height;
+        LG_PlatformScrollList(list, down ? -dy : dy);
+        return;
+    }
+
+    LG_Rect rect = {0, 0, list->rect.width, list->rect.height};
+    RedrawList(list, rect);
+}
+
+size_t LG_GetListTopRow(LG_WidgetHandle list) {
+    return IsList(list) ? list->list->top_row : 0;
+}
+
+void LG_SetListSelection(LG_WidgetHandle list, size_t row) {
+    if (!IsList(list)) {
+        return;
+    }
+
+    LG_ListState* state = list->list;
+    if (row != LG_LIST_NO_SELECTION && row >= state->row_count) {
+        row = LG_LIST_NO_SELECTION;
+    }
+    if (row == state->selection) {
+        return;
+    }
+
+    size_t old = state->selection;
+    state->selection = row;
+    if (old != LG_LIST_NO_SELECTION) {
+        RedrawRows(list, old, old + 1);
+    }
+    if (row != LG_LIST_NO_SELECTION) {
+        RedrawRows(list, row, row + 1);
+    }
+}
+
+size_t LG_GetListSelection(LG_WidgetHandle list) {
+    return IsList(list) ? list->list->selection : LG_LIST_NO_SELECTION;
+}
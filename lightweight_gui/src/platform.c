@@ -0,0 +1,217 @@
+/**
+ * @file platform.c
+ * @brief Selection of the platform backend and forwarding of the platform hooks
+ *
+ * Every build contains the native backend and the headless one. The core
+ * calls the LG_Platform* functions, which forward to whichever backend
+ * LG_InitializeBackend picked.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const LG_PlatformBackend* g_platform = &g_native_backend;
+
+void PlatformSelectBackend(LG_Backend backend) {
+    if (backend == LG_BACKEND_DEFAULT) {
+        const char* name = getenv("LIGHTGUI_BACKEND");
+        backend = (name && strcmp(name, "headless") == 0) ? LG_BACKEND_HEADLESS : LG_BACKEND_NATIVE;
+        if (name && backend == LG_BACKEND_NATIVE && strcmp(name, "native") != 0) {
+            fprintf(stderr, "LightGUI: Unknown backend \"%s\", using native\n", name);
+        }
+    }
+
+    g_platform = backend == LG_BACKEND_HEADLESS ? &g_headless_backend : &g_native_backend;
+}
+
+/* ========================================================================= */
+/*                        Forwarding                                         */
+/* ========================================================================= */
+
+bool LG_PlatformInitialize(void) {
+    return g_platform->initialize();
+}
+
+void LG_PlatformTerminate(void) {
+    g_platform->terminate();
+}
+
+bool LG_PlatformCreateWindow(LG_WindowHandle window) {
+    return g_platform->create_window(window);
+}
+
+void LG_PlatformDestroyWindow(LG_WindowHandle window) {
+    g_platform->destroy_window(window);
+}
+
+void LG_PlatformShowWindow(LG_WindowHandle window) {
+    g_platform->show_window(window);
+}
+
+void LG_PlatformHideWindow(LG_WindowHandle window) {
+    g_platform->hide_window(window);
+}
+
+void LG_PlatformSetWindowTitle(LG_WindowHandle window, const char* title) {
+    g_platform->set_window_title(window, title);
+}
+
+bool LG_PlatformCreateWidget(LG_WidgetHandle widget) {
+    return g_platform->create_widget(widget);
+}
+
+void LG_PlatformDestroyWidget(LG_WidgetHandle widget) {
+    g_platform->destroy_widget(widget);
+}
+
+void LG_PlatformUpdateWidget(LG_WidgetHandle widget) {
+    g_platform->update_widget(widget);
+}
+
+void LG_PlatformUpdateWidgets(LG_WidgetHandle* widgets, size_t count) {
+    g_platform->update_widgets(widgets, count);
+}
+
+bool LG_PlatformProcessEvents(void) {
+    return g_platform->process_events();
+}
+
+bool LG_PlatformWaitEvents(int timeout_ms) {
+    LG_WaitHandle handles[LG_MAX_WAIT_HANDLES];
+    size_t count = ProcessWaitHandles(handles);
+    return g_platform->wait_events(ProcessWaitTimeout(timeout_ms), handles, count);
+}
+
+void LG_PlatformWakeup(void) {
+    g_platform->wakeup();
+}
+
+uint64_t LG_PlatformGetTime(void) {
+    return g_platform->get_time();
+}
+
+bool LG_PlatformGetVBlankTiming(uint64_t* last_vblank, uint64_t* interval) {
+    return g_platform->get_vblank_timing(last_vblank, interval);
+}
+
+void LG_PlatformRenderWindow(LG_WindowHandle window) {
+    g_platform->render_window(window);
+}
+
+void* LG_PlatformGetNativeHandle(LG_WidgetHandle widget) {
+    return g_platform->get_native_handle(widget);
+}
+
+bool LG_PlatformGetCanvasBuffer(LG_WidgetHandle canvas, LG_CanvasBuffer* buffer) {
+    return g_platform->get_canvas_buffer(canvas, buffer);
+}
+
+void LG_PlatformPresentCanvas(LG_WidgetHandle canvas, LG_Rect rect) {
+    g_platform->present_canvas(canvas, rect);
+}
+
+void LG_PlatformRedrawList(LG_WidgetHandle list, LG_Rect rect) {
+    g_platform->redraw_list(list, rect);
+}
+
+void LG_PlatformScrollList(LG_WidgetHandle list, int dy) {
+    g_platform->scroll_list(list, dy);
+}
+
+bool LG_PlatformBuildGlyphAtlas(LG_GlyphAtlas* atlas) {
+    return g_platform->build_glyph_atlas(atlas);
+}
+
+void LG_PlatformFlush(void) {
+    g_platform->flush();
+}
+
+bool LG_PlatformWaitForVBlank(void) {
+    return g_platform->wait_for_vblank ? g_platform->wait_for_vblank() : false;
+}
+
+bool LG_PlatformCanRasterize(void) {
+    return g_platform->rasterize_window != NULL;
+}
+
+void LG_PlatformRasterizeWindow(LG_WindowHandle window) {
+    if (g_platform->rasterize_window) {
+        g_platform->rasterize_window(window);
+    }
+}
+
+bool LG_PlatformSupportsGL(void) {
+    return g_platform->gl_make_current != NULL;
+}
+
+bool LG_PlatformGLMakeCurrent(LG_WidgetHandle canvas) {
+    return g_platform->gl_make_current ? g_platform->gl_make_current(canvas) : false;
+}
+
+void LG_PlatformGLSwapBuffers(LG_WidgetHandle canvas) {
+    if (g_platform->gl_swap_buffers) {
+        g_platform->gl_swap_buffers(canvas);
+    }
+}
+
+bool LG_PlatformGLSetSwapInterval(LG_WidgetHandle canvas, int interval) {
+    return g_platform->gl_set_swap_interval ? g_platform->gl_set_swap_interval(canvas, interval)
+                                            : false;
+}
+
+/* ========================================================================= */
+/*                        Synthetic Input and Frames                         */
+/* ========================================================================= */
+
+bool LG_InjectEvent(LG_WindowHandle window, const LG_Event* event) {
+    if (!window || !event || !g_platform->inject_event) {
+        return false;
+    }
+
+    return g_platform->inject_event(window, event);
+}
+
+bool LG_GetWindowFrame(LG_WindowHandle window, LG_CanvasBuffer* frame) {
+    if (!window || !frame || !g_platform->get_window_frame) {
+        return false;
+    }
+
+    LG_RenderWindow(window);
+    return g_platform->get_window_frame(window, frame);
+}
+
+bool LG_SaveWindowFrame(LG_WindowHandle window, const char* path) {
+    LG_CanvasBuffer frame;
+    if (!path || !LG_GetWindowFrame(window, &frame)) {
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "LightGUI: Failed to open %s\n", path);
+        return false;
+    }
+
+    unsigned char* row = (unsigned char*)malloc((size_t)frame.width * 3);
+    bool ok = row != NULL && fprintf(file, "P6\n%d %d\n255\n", frame.width, frame.height) > 0;
+    for (int y = 0; ok && y < frame.height; y++) {
+        const uint32_t* src = frame.pixels + (size_t)y * frame.stride;
+        for (int x = 0; x < frame.width; x++) {
+            row[x * 3 + 0] = (unsigned char)(src[x] >> 16);
+            row[x * 3 + 1] = (unsigned char)(src[x] >> 8);
+            row[x * 3 + 2] = (unsigned char)src[x];
+        }
+        ok = fwrite(row, 3, (size_t)frame.width, file) == (size_t)frame.width;
+    }
+
+    free(row);
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        fprintf(stderr, "LightGUI: Failed to write %s\n", path);
+    }
+    return ok;
+}
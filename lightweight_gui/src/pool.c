@@ -0,0 +1,142 @@
+/**
+ * @file pool.c
+ * @brief Fixed-size object pools used for widgets and their platform data
+ *
+ * A pool hands out equally sized items carved from larger slabs. Freed
+ * items go onto a free list and are reused before any new slab is
+ * allocated, so creating and destroying widgets in steady state does not
+ * touch the heap and keeps a window's widgets close together in memory.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Alignment of every item; enough for any widget or platform structure */
+#define LG_POOL_ALIGN 16
+
+/* Upper bound on the number of items in one slab */
+#define LG_POOL_MAX_SLAB_ITEMS 1024
+
+/**
+ * @brief Header at the start of every slab
+ */
+typedef struct PoolSlab {
+    struct PoolSlab* next;
+} PoolSlab;
+
+struct LG_Pool {
+    size_t item_size;
+    size_t next_slab_items;  // Slabs double in size up to LG_POOL_MAX_SLAB_ITEMS
+    void* free_list;  // Linked through the first pointer of each free item
+    PoolSlab* slabs;
+    size_t live_count;
+    size_t free_count;  // Items on free_list
+};
+
+static size_t AlignUp(size_t size) {
+    return (size + LG_POOL_ALIGN - 1) & ~(size_t)(LG_POOL_ALIGN - 1);
+}
+
+LG_Pool* PoolCreate(size_t item_size, size_t initial_items) {
+    LG_Pool* pool = (LG_Pool*)calloc(1, sizeof(LG_Pool));
+    if (!pool) {
+        return NULL;
+    }
+
+    if (item_size < sizeof(void*)) {
+        item_size = sizeof(void*);
+    }
+    pool->item_size = AlignUp(item_size);
+    pool->next_slab_items = initial_items ? initial_items : 16;
+    return pool;
+}
+
+void PoolDestroy(LG_Pool* pool) {
+    if (!pool) {
+        return;
+    }
+
+    PoolSlab* slab = pool->slabs;
+    while (slab) {
+        PoolSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    free(pool);
+}
+
+/**
+ * @brief Allocate a new slab of count items and put them all on the free list
+ */
+static bool PoolGrow(LG_Pool* pool, size_t count) {
+    size_t header = AlignUp(sizeof(PoolSlab));
+
+    PoolSlab* slab = (PoolSlab*)malloc(header + count * pool->item_size);
+    if (!slab) {
+        fprintf(stderr, "LightGUI: Failed to allocate pool slab\n");
+        return false;
+    }
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    g_stats.heap_allocations++;
+
+    // Push in reverse so items are handed out in address order
+    char* items = (char*)slab + header;
+    for (size_t i = count; i-- > 0;) {
+        void* item = items + i * pool->item_size;
+        *(void**)item = pool->free_list;
+        pool->free_list = item;
+    }
+    pool->free_count += count;
+
+    if (pool->next_slab_items < LG_POOL_MAX_SLAB_ITEMS) {
+        pool->next_slab_items *= 2;
+    }
+    return true;
+}
+
+void* PoolAlloc(LG_Pool* pool) {
+    if (!pool || (!pool->free_list && !PoolGrow(pool, pool->next_slab_items))) {
+        return NULL;
+    }
+
+    void* item = pool->free_list;
+    pool->free_list = *(void**)item;
+    pool->free_count--;
+    pool->live_count++;
+    g_stats.pool_allocations++;
+
+    memset(item, 0, pool->item_size);
+    return item;
+}
+
+void PoolFree(LG_Pool* pool, void* item) {
+    if (!pool || !item) {
+        return;
+    }
+
+    *(void**)item = pool->free_list;
+    pool->free_list = item;
+    pool->free_count++;
+    pool->live_count--;
+}
+
+bool PoolReserve(LG_Pool* pool, size_t count) {
+    if (!pool) {
+        return false;
+    }
+
+    // One slab for the whole shortfall, however large
+    return count <= pool->free_count || PoolGrow(pool, count - pool->free_count);
+}
+
+size_t PoolItemSize(const LG_Pool* pool) {
+    return pool ? pool->item_size : 0;
+}
+
+size_t PoolLiveCount(const LG_Pool* pool) {
+    return pool ? pool->live_count : 0;
+}
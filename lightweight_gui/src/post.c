@@ -0,0 +1,181 @@
+/**
+ * @file post.c
+ * @brief Work posted to the main thread from other threads
+ *
+ * Posting pushes onto a lock-free stack with a single compare-and-swap, so
+ * any number of threads can post without a mutex. The main thread takes
+ * the whole stack with one atomic exchange per loop iteration and runs it
+ * in posting order. Only the post that finds the stack empty wakes the
+ * event loop; later posts ride along with that wakeup.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_MSC_VER)
+#include <windows.h>
+#endif
+
+/**
+ * @brief One posted closure or user event
+ */
+typedef struct PostedItem {
+    struct PostedItem* next;
+    LG_MainThreadFunc func;  // NULL for user events
+    void* user_data;
+    LG_WindowHandle window;  // Target of a user event
+    int code;
+} PostedItem;
+
+/* Most recently posted item; the list runs from newest to oldest */
+static PostedItem* volatile g_posted = NULL;
+
+/* ========================================================================= */
+/*                        Atomic Operations                                  */
+/* ========================================================================= */
+
+#if defined(_MSC_VER)
+static bool PushCompareExchange(PostedItem* expected, PostedItem* desired) {
+    return InterlockedCompareExchangePointer((PVOID volatile*)&g_posted, desired, expected) ==
+           expected;
+}
+
+static PostedItem* LoadHead(void) {
+    // Volatile reads have acquire semantics under MSVC
+    return g_posted;
+}
+
+static PostedItem* TakeAll(void) {
+    return (PostedItem*)InterlockedExchangePointer((PVOID volatile*)&g_posted, NULL);
+}
+#else
+static bool PushCompareExchange(PostedItem* expected, PostedItem* desired) {
+    return __atomic_compare_exchange_n(&g_posted, &expected, desired, true,
+                                       __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+static PostedItem* LoadHead(void) {
+    return __atomic_load_n(&g_posted, __ATOMIC_RELAXED);
+}
+
+static PostedItem* TakeAll(void) {
+    return __atomic_exchange_n(&g_posted, NULL, __ATOMIC_ACQUIRE);
+}
+#endif
+
+/* ========================================================================= */
+/*                        Posting                                            */
+/* ========================================================================= */
+
+static bool PushItem(PostedItem* item) {
+    PostedItem* head;
+    do {
+        head = LoadHead();
+        item->next = head;
+    } while (!PushCompareExchange(head, item));
+
+    // The main thread drains everything at once, so one wakeup per batch is enough
+    if (!head) {
+        LG_PlatformWakeup();
+    }
+    return true;
+}
+
+bool LG_PostToMainThread(LG_MainThreadFunc func, void* user_data) {
+    if (!func) {
+        return false;
+    }
+
+    PostedItem* item = (PostedItem*)calloc(1, sizeof(PostedItem));
+    if (!item) {
+        fprintf(stderr, "LightGUI: Failed to allocate posted function\n");
+        return false;
+    }
+
+    item->func = func;
+    item->user_data = user_data;
+    return PushItem(item);
+}
+
+bool LG_PostUserEvent(LG_WindowHandle window, int code, void* data) {
+    if (!window) {
+        return false;
+    }
+
+    PostedItem* item = (PostedItem*)calloc(1, sizeof(PostedItem));
+    if (!item) {
+        fprintf(stderr, "LightGUI: Failed to allocate user event\n");
+        return false;
+    }
+
+    item->window = window;
+    item->code = code;
+    item->user_data = data;
+    return PushItem(item);
+}
+
+/* ========================================================================= */
+/*                        Draining                                           */
+/* ========================================================================= */
+
+/**
+ * @brief Reverse a newest-first list into posting order
+ */
+static PostedItem* ReverseItems(PostedItem* item) {
+    PostedItem* reversed = NULL;
+    while (item) {
+        PostedItem* next = item->next;
+        item->next = reversed;
+        reversed = item;
+        item = next;
+    }
+    return reversed;
+}
+
+static bool IsLiveWindow(LG_WindowHandle window) {
+    for (size_t i = 0; i < g_windows.count; i++) {
+        if (g_windows.windows[i] == window) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RunPostedItems(void) {
+    if (!LoadHead()) {
+        return;
+    }
+
+    // Items posted while these run are picked up on the next iteration
+    PostedItem* item = ReverseItems(TakeAll());
+    while (item) {
+        PostedItem* next = item->next;
+
+        if (item->func) {
+            uint64_t start = LG_PlatformGetTime();
+            item->func(item->user_data);
+            g_stats.callback_us += LG_PlatformGetTime() - start;
+        } else if (IsLiveWindow(item->window)) {
+            LG_Event event;
+            memset(&event, 0, sizeof(event));
+            event.type = LG_EVENT_USER;
+            event.data.user.code = item->code;
+            event.data.user.data = item->user_data;
+            DispatchWindowEvent(item->window, &event);
+        }
+
+        free(item);
+        item = next;
+    }
+}
+
+void DiscardPostedItems(void) {
+    PostedItem* item = TakeAll();
+    while (item) {
+        PostedItem* next = item->next;
+        free(item);
+        item = next;
+    }
+}
@@ -0,0 +1,511 @@
+/**
+ * @file process.c
+ * @brief Child processes whose output is delivered as events
+ *
+ * A process runs a shell command with its stdout and stderr on one pipe.
+ * The parent end never blocks: its descriptor (POSIX) or overlapped read
+ * event (Windows) is part of the set the event loop waits on, and each
+ * loop iteration reads everything available into one
+ * LG_EVENT_PROCESS_OUTPUT event per process. The process is reaped once
+ * its output is closed and LG_EVENT_PROCESS_EXIT is delivered.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+#define PROCESS_CHUNK_SIZE 65536  // Most output delivered in one event
+
+/* How often to check for the exit of a process that closed its output */
+#define PROCESS_REAP_INTERVAL_MS 10
+
+struct LG_Process {
+    LG_WindowHandle window;
+#ifdef _WIN32
+    HANDLE process;
+    HANDLE job;   // Holds everything the command starts, for LG_KillProcess
+    HANDLE pipe;  // NULL once the output is closed
+    OVERLAPPED overlapped;
+    bool read_pending;
+    size_t read_at;  // Where the pending read stores its bytes
+#else
+    pid_t pid;
+    int pipe;  // -1 once the output is closed
+#endif
+    bool exited;
+    int exit_code;
+    char* buffer;
+    size_t buffered;  // Bytes read into buffer, not yet delivered
+};
+
+static LG_ProcessHandle* g_processes = NULL;
+static size_t g_process_count = 0;
+static size_t g_process_capacity = 0;
+
+/* ========================================================================= */
+/*                        Process List                                       */
+/* ========================================================================= */
+
+static bool AddProcess(LG_ProcessHandle process) {
+    if (g_process_count == LG_MAX_WAIT_HANDLES) {
+        fprintf(stderr, "LightGUI: Too many running processes\n");
+        return false;
+    }
+
+    if (g_process_count == g_process_capacity) {
+        size_t capacity = g_process_capacity ? g_process_capacity * 2 : 4;
+        LG_ProcessHandle* processes = (LG_ProcessHandle*)realloc(g_processes,
+                                                                 capacity * sizeof(LG_ProcessHandle));
+        if (!processes) {
+            fprintf(stderr, "LightGUI: Failed to allocate process list\n");
+            return false;
+        }
+        g_processes = processes;
+        g_process_capacity = capacity;
+    }
+
+    g_processes[g_process_count++] = process;
+    return true;
+}
+
+static void RemoveProcess(LG_ProcessHandle process) {
+    for (size_t i = 0; i < g_process_count; i++) {
+        if (g_processes[i] == process) {
+            g_process_count--;
+            memmove(&g_processes[i], &g_processes[i + 1],
+                    (g_process_count - i) * sizeof(LG_ProcessHandle));
+            break;
+        }
+    }
+
+    if (g_process_count == 0) {
+        free(g_processes);
+        g_processes = NULL;
+        g_process_capacity = 0;
+    }
+}
+
+static bool IsListed(LG_ProcessHandle process, size_t index) {
+    return index < g_process_count && g_processes[index] == process;
+}
+
+/* ========================================================================= */
+/*                        Platform Processes                                 */
+/* ========================================================================= */
+
+#ifdef _WIN32
+
+static void ClosePipe(LG_ProcessHandle process) {
+    if (process->pipe) {
+        if (process->read_pending) {
+            CancelIo(process->pipe);
+            DWORD ignored;
+            GetOverlappedResult(process->pipe, &process->overlapped, &ignored, TRUE);
+        }
+        CloseHandle(process->pipe);
+        process->pipe = NULL;
+        process->read_pending = false;
+    }
+}
+
+/**
+ * @brief Read until a read is left pending, the buffer is full or the pipe closes
+ */
+static void ReadPipe(LG_ProcessHandle process) {
+    while (process->pipe && process->buffered < PROCESS_CHUNK_SIZE) {
+        DWORD count = 0;
+        if (process->read_pending) {
+            if (!GetOverlappedResult(process->pipe, &process->overlapped, &count, FALSE)) {
+                if (GetLastError() == ERROR_IO_INCOMPLETE) {
+                    return;  // Still waiting for output
+                }
+                ClosePipe(process);  // ERROR_BROKEN_PIPE once the command is done
+                return;
+            }
+            process->read_pending = false;
+
+            // Output delivered while the read was pending moved the end of the buffer
+            memmove(process->buffer + process->buffered, process->buffer + process->read_at, count);
+            process->buffered += count;
+            continue;
+        }
+
+        process->read_at = process->buffered;
+        if (ReadFile(process->pipe, process->buffer + process->buffered,
+                     (DWORD)(PROCESS_CHUNK_SIZE - process->buffered), NULL,
+                     &process->overlapped) ||
+            GetLastError() == ERROR_IO_PENDING) {
+            // Completion, immediate or not, is collected through the overlapped result
+            process->read_pending = true;
+        } else {
+            ClosePipe(process);
+        }
+    }
+}
+
+static bool ReapProcess(LG_ProcessHandle process) {
+    if (WaitForSingleObject(process->process, 0) != WAIT_OBJECT_0) {
+        return false;
+    }
+
+    DWORD code = 0;
+    GetExitCodeProcess(process->process, &code);
+    process->exit_code = (int)code;
+    return true;
+}
+
+static bool SpawnPlatformProcess(LG_ProcessHandle process, const char* command) {
+    // Anonymous pipes can't be read asynchronously, so use a unique named pipe
+    static LONG serial = 0;
+    char name[64];
+    snprintf(name, sizeof(name), "\\\\.\\pipe\\LightGUI-%lu-%ld", GetCurrentProcessId(),
+             InterlockedIncrement(&serial));
+
+    process->pipe = CreateNamedPipeA(name, PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED |
+                                               FILE_FLAG_FIRST_PIPE_INSTANCE,
+                                     PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 1, 0,
+                                     PROCESS_CHUNK_SIZE, 0, NULL);
+    if (process->pipe == INVALID_HANDLE_VALUE) {
+        process->pipe = NULL;
+        return false;
+    }
+
+    SECURITY_ATTRIBUTES inherit = {sizeof(SECURITY_ATTRIBUTES), NULL, TRUE};
+    HANDLE output = CreateFileA(name, GENERIC_WRITE, 0, &inherit, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, NULL);
+    HANDLE input = CreateFileA("NUL", GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, &inherit,
+                               OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    process->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+    process->job = CreateJobObjectA(NULL, NULL);
+
+    size_t length = strlen(command) + sizeof("cmd.exe /c ");
+    char* command_line = (char*)malloc(length);
+    bool created = false;
+    if (output != INVALID_HANDLE_VALUE && input != INVALID_HANDLE_VALUE &&
+        process->overlapped.hEvent && process->job && command_line) {
+        snprintf(command_line, length, "cmd.exe /c %s", command);
+
+        STARTUPINFOA startup;
+        ZeroMemory(&startup, sizeof(startup));
+        startup.cb = sizeof(startup);
+        startup.dwFlags = STARTF_USESTDHANDLES;
+        startup.hStdInput = input;
+        startup.hStdOutput = output;
+        startup.hStdError = output;
+
+        // Start suspended so the job holds the command before it can start anything
+        PROCESS_INFORMATION info;
+        created = CreateProcessA(NULL, command_line, NULL, NULL, TRUE,
+                                 CREATE_NO_WINDOW | CREATE_SUSPENDED, NULL, NULL, &startup,
+                                 &info) != 0;
+        if (created) {
+            AssignProcessToJobObject(process->job, info.hProcess);
+            ResumeThread(info.hThread);
+            CloseHandle(info.hThread);
+            process->process = info.hProcess;
+        }
+    }
+
+    // The child has its own copies; only the read end stays open here
+    free(command_line);
+    if (output != INVALID_HANDLE_VALUE) CloseHandle(output);
+    if (input != INVALID_HANDLE_VALUE) CloseHandle(input);
+    if (!created) {
+        return false;
+    }
+
+    ReadPipe(process);
+    return true;
+}
+
+static void KillPlatformProcess(LG_ProcessHandle process) {
+    TerminateJobObject(process->job, 1);
+}
+
+static void FreePlatformProcess(LG_ProcessHandle process) {
+    ClosePipe(process);
+    if (process->overlapped.hEvent) CloseHandle(process->overlapped.hEvent);
+    if (process->process) CloseHandle(process->process);
+    if (process->job) CloseHandle(process->job);
+}
+
+static bool GetWaitHandle(LG_ProcessHandle process, LG_WaitHandle* handle) {
+    if (process->read_pending) {
+        *handle = process->overlapped.hEvent;
+        return true;
+    }
+    if (!process->pipe && !process->exited) {
+        *handle = process->process;
+        return true;
+    }
+    return false;
+}
+
+#else
+
+static void ClosePipe(LG_ProcessHandle process) {
+    if (process->pipe >= 0) {
+        close(process->pipe);
+        process->pipe = -1;
+    }
+}
+
+/**
+ * @brief Read until the pipe is empty, the buffer is full or the pipe closes
+ */
+static void ReadPipe(LG_ProcessHandle process) {
+    while (process->pipe >= 0 && process->buffered < PROCESS_CHUNK_SIZE) {
+        ssize_t count = read(process->pipe, process->buffer + process->buffered,
+                             PROCESS_CHUNK_SIZE - process->buffered);
+        if (count > 0) {
+            process->buffered += (size_t)count;
+        } else if (count < 0 && errno == EINTR) {
+            continue;
+        } else {
+            if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return;  // Nothing more for now
+            }
+            ClosePipe(process);  // End of output, or an error that ends it
+        }
+    }
+}
+
+static bool ReapProcess(LG_ProcessHandle process) {
+    int status;
+    pid_t result = waitpid(process->pid, &status, WNOHANG);
+    if (result == 0 || (result < 0 && errno == EINTR)) {
+        return false;
+    }
+
+    // Report signals the way a shell does
+    if (result < 0) {
+        process->exit_code = -1;
+    } else if (WIFEXITED(status)) {
+        process->exit_code = WEXITSTATUS(status);
+    } else if (WIFSIGNALED(status)) {
+        process->exit_code = 128 + WTERMSIG(status);
+    } else {
+        process->exit_code = -1;
+    }
+    return true;
+}
+
+static bool SpawnPlatformProcess(LG_ProcessHandle process, const char* command) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+
+    // Neither end may leak into other children, or the output would never close
+    for (int i = 0; i < 2; i++) {
+        fcntl(fds[i], F_SETFD, FD_CLOEXEC);
+    }
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attributes;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+
+    // A group of its own, so LG_KillProcess reaches everything the command starts
+    posix_spawnattr_init(&attributes);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attributes, 0);
+
+    char* argv[] = {"sh", "-c", (char*)command, NULL};
+    int result = posix_spawn(&process->pid, "/bin/sh", &actions, &attributes, argv, environ);
+
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (result != 0) {
+        close(fds[0]);
+        return false;
+    }
+
+    process->pipe = fds[0];
+    return true;
+}
+
+static void KillPlatformProcess(LG_ProcessHandle process) {
+    kill(-process->pid, SIGKILL);
+}
+
+static void FreePlatformProcess(LG_ProcessHandle process) {
+    ClosePipe(process);
+}
+
+static bool GetWaitHandle(LG_ProcessHandle process, LG_WaitHandle* handle) {
+    if (process->pipe >= 0) {
+        *handle = process->pipe;
+        return true;
+    }
+    return false;  // Exits are polled; see ProcessWaitTimeout
+}
+
+#endif
+
+static void FreeProcess(LG_ProcessHandle process) {
+    FreePlatformProcess(process);
+    free(process->buffer);
+    free(process);
+}
+
+/* ========================================================================= */
+/*                        Internal Interface                                 */
+/* ========================================================================= */
+
+size_t ProcessWaitHandles(LG_WaitHandle* handles) {
+    size_t count = 0;
+    for (size_t i = 0; i < g_process_count; i++) {
+        if (GetWaitHandle(g_processes[i], &handles[count])) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int ProcessWaitTimeout(int timeout_ms) {
+#ifdef _WIN32
+    // A full buffer leaves no read pending until the next iteration issues one
+    for (size_t i = 0; i < g_process_count; i++) {
+        if (g_processes[i]->pipe && !g_processes[i]->read_pending) {
+            return 0;
+        }
+    }
+    return timeout_ms;
+#else
+    for (size_t i = 0; i < g_process_count; i++) {
+        if (g_processes[i]->pipe < 0 &&
+            (timeout_ms < 0 || timeout_ms > PROCESS_REAP_INTERVAL_MS)) {
+            return PROCESS_REAP_INTERVAL_MS;
+        }
+    }
+    return timeout_ms;
+#endif
+}
+
+void PollProcesses(void) {
+    // Callbacks may spawn, kill or destroy windows, so re-check each step
+    for (size_t i = 0; i < g_process_count;) {
+        LG_ProcessHandle process = g_processes[i];
+
+        ReadPipe(process);
+        if (process->buffered > 0) {
+            LG_Event event;
+            memset(&event, 0, sizeof(event));
+            event.type = LG_EVENT_PROCESS_OUTPUT;
+            event.data.process_output.process = process;
+            event.data.process_output.data = process->buffer;
+            event.data.process_output.size = process->buffered;
+            process->buffered = 0;
+            DispatchWindowEvent(process->window, &event);
+            if (!IsListed(process, i)) {
+                continue;
+            }
+        }
+
+        // Only report the exit after the last output has been delivered
+        bool closed = process->buffered == 0 &&
+#ifdef _WIN32
+                      !process->pipe;
+#else
+                      process->pipe < 0;
+#endif
+        if (!closed || !ReapProcess(process)) {
+            i++;
+            continue;
+        }
+
+        process->exited = true;
+        RemoveProcess(process);
+
+        LG_Event event;
+        memset(&event, 0, sizeof(event));
+        event.type = LG_EVENT_PROCESS_EXIT;
+        event.data.process_exit.process = process;
+        event.data.process_exit.exit_code = process->exit_code;
+        DispatchWindowEvent(process->window, &event);
+        FreeProcess(process);
+    }
+}
+
+void DestroyWindowProcesses(LG_WindowHandle window) {
+    for (size_t i = g_process_count; i-- > 0;) {
+        LG_ProcessHandle process = g_processes[i];
+        if (process->window != window) {
+            continue;
+        }
+
+        // Nobody is left to report to, so stop the command and reap it now
+        RemoveProcess(process);
+        KillPlatformProcess(process);
+#ifdef _WIN32
+        WaitForSingleObject(process->process, INFINITE);
+#else
+        while (waitpid(process->pid, NULL, 0) < 0 && errno == EINTR) {
+        }
+#endif
+        FreeProcess(process);
+    }
+}
+
+/* ========================================================================= */
+/*                        Public API                                         */
+/* ========================================================================= */
+
+LG_ProcessHandle LG_SpawnProcess(LG_WindowHandle window, const char* command) {
+    if (!window || !command) {
+        return NULL;
+    }
+
+    LG_ProcessHandle process = (LG_ProcessHandle)calloc(1, sizeof(struct LG_Process));
+    if (!process) {
+        fprintf(stderr, "LightGUI: Failed to allocate process\n");
+        return NULL;
+    }
+    process->window = window;
+#ifndef _WIN32
+    process->pipe = -1;
+#endif
+
+    process->buffer = (char*)malloc(PROCESS_CHUNK_SIZE);
+    if (!process->buffer || !AddProcess(process)) {
+        free(process->buffer);
+        free(process);
+        return NULL;
+    }
+
+    if (!SpawnPlatformProcess(process, command)) {
+        fprintf(stderr, "LightGUI: Failed to start %s\n", command);
+        RemoveProcess(process);
+        FreeProcess(process);
+        return NULL;
+    }
+    return process;
+}
+
+void LG_KillProcess(LG_ProcessHandle process) {
+    if (!process || process->exited) {
+        return;
+    }
+
+    // The exit is reported as usual once the output closes
+    KillPlatformProcess(process);
+}
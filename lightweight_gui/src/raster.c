@@ -0,0 +1,887 @@
+/**
+ * @file raster.c
+ * @brief Software rasterizer for canvas drawing primitives
+ *
+ * Shapes are reduced to horizontal spans which are filled or blended by a
+ * small set of kernels. The kernels have SSE2, AVX2 and NEON versions; the
+ * best one the CPU supports is picked at runtime, with a scalar fallback.
+ *
+ * Pixels are 0xAARRGGBB. Blending is "source over" with straight alpha:
+ * out = (src * a + dst * (255 - a)) / 255 for every channel, including
+ * alpha, where the source is treated as opaque and a is its coverage
+ * times its alpha.
+ */
+
+#include "lightgui_internal.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || \
+    (defined(__i386__) && defined(__SSE2__)) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LG_RASTER_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+#define LG_RASTER_AVX2 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LG_RASTER_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(LG_RASTER_AVX2) && (defined(__GNUC__) || defined(__clang__))
+#define LG_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define LG_TARGET_AVX2
+#endif
+
+/* Pixels coloured per chunk of a masked span */
+#define LG_RASTER_CHUNK 256
+
+/* ========================================================================= */
+/*                        Span Kernels                                       */
+/* ========================================================================= */
+
+/**
+ * @brief Span kernels used by every primitive
+ */
+typedef struct {
+    const char* name;
+
+    // Store pixel into count pixels
+    void (*fill)(uint32_t* dst, int count, uint32_t pixel);
+
+    // Blend pixel over count pixels with a constant alpha (1-254)
+    void (*blend)(uint32_t* dst, int count, uint32_t pixel, unsigned alpha);
+
+    // Blend pixel over count pixels with a per-pixel alpha
+    void (*blend_mask)(uint32_t* dst, int count, uint32_t pixel, const uint8_t* alpha);
+
+    // Blend src over dst using each source pixel's alpha times opacity
+    void (*blend_pixels)(uint32_t* dst, const uint32_t* src, int count, unsigned opacity);
+} RasterKernels;
+
+static RasterKernels g_kernels;
+
+/**
+ * @brief Divide by 255 with rounding, exact for 0..255*255
+ */
+static inline unsigned Div255(unsigned value) {
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+/**
+ * @brief Blend one opaque source pixel over a destination pixel
+ */
+static inline uint32_t BlendPixel(uint32_t dst, uint32_t src, unsigned alpha) {
+    unsigned inverse = 255 - alpha;
+    uint32_t result = 0;
+    for (int shift = 0; shift < 32; shift += 8) {
+        unsigned s = (src >> shift) & 0xFF;
+        unsigned d = (dst >> shift) & 0xFF;
+        result |= (uint32_t)Div255(s * alpha + d * inverse) << shift;
+    }
+    return result;
+}
+
+static void FillScalar(uint32_t* dst, int count, uint32_t pixel) {
+    for (int i = 0; i < count; i++) {
+        dst[i] = pixel;
+    }
+}
+
+static void BlendScalar(uint32_t* dst, int count, uint32_t pixel, unsigned alpha) {
+    pixel |= 0xFF000000u;
+    for (int i = 0; i < count; i++) {
+        dst[i] = BlendPixel(dst[i], pixel, alpha);
+    }
+}
+
+static void BlendMaskScalar(uint32_t* dst, int count, uint32_t pixel, const uint8_t* alpha) {
+    pixel |= 0xFF000000u;
+    for (int i = 0; i < count; i++) {
+        if (alpha[i] == 255) {
+            dst[i] = pixel;
+        } else if (alpha[i]) {
+            dst[i] = BlendPixel(dst[i], pixel, alpha[i]);
+        }
+    }
+}
+
+static void BlendPixelsScalar(uint32_t* dst, const uint32_t* src, int count, unsigned opacity) {
+    for (int i = 0; i < count; i++) {
+        unsigned alpha = src[i] >> 24;
+        if (opacity != 255) {
+            alpha = Div255(alpha * opacity);
+        }
+
+        if (alpha == 255) {
+            dst[i] = src[i];
+        } else if (alpha) {
+            dst[i] = BlendPixel(dst[i], src[i] | 0xFF000000u, alpha);
+        }
+    }
+}
+
+#ifdef LG_RASTER_SSE2
+/**
+ * @brief Blend 4 opaque source pixels over 4 destination pixels
+ *
+ * @param alpha The blend factor of each pixel, repeated in all 4 bytes
+ */
+static inline __m128i Blend4SSE2(__m128i dst, __m128i src, __m128i alpha) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+
+    __m128i a_lo = _mm_unpacklo_epi8(alpha, zero);
+    __m128i a_hi = _mm_unpackhi_epi8(alpha, zero);
+
+    __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(src, zero), a_lo),
+                               _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), _mm_sub_epi16(max, a_lo)));
+    __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(src, zero), a_hi),
+                               _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), _mm_sub_epi16(max, a_hi)));
+
+    lo = _mm_add_epi16(lo, half);
+    hi = _mm_add_epi16(hi, half);
+    lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+    hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+    return _mm_packus_epi16(lo, hi);
+}
+
+/**
+ * @brief Repeat the top byte of each pixel into all of its bytes
+ */
+static inline __m128i SplatAlphaSSE2(__m128i pixels) {
+    __m128i alpha = _mm_srli_epi32(pixels, 24);
+    alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+    return _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+}
+
+static void FillSSE2(uint32_t* dst, int count, uint32_t pixel) {
+    __m128i value = _mm_set1_epi32((int)pixel);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128((__m128i*)(dst + i), value);
+    }
+    FillScalar(dst + i, count - i, pixel);
+}
+
+static void BlendSSE2(uint32_t* dst, int count, uint32_t pixel, unsigned alpha) {
+    __m128i src = _mm_set1_epi32((int)(pixel | 0xFF000000u));
+    __m128i factor = _mm_set1_epi8((char)alpha);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), Blend4SSE2(d, src, factor));
+    }
+    BlendScalar(dst + i, count - i, pixel, alpha);
+}
+
+static void BlendMaskSSE2(uint32_t* dst, int count, uint32_t pixel, const uint8_t* alpha) {
+    __m128i src = _mm_set1_epi32((int)(pixel | 0xFF000000u));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        int32_t mask;
+        memcpy(&mask, alpha + i, sizeof(mask));
+        if (mask == 0) continue;
+
+        __m128i factor = _mm_cvtsi32_si128(mask);
+        factor = _mm_unpacklo_epi8(factor, factor);
+        factor = _mm_unpacklo_epi16(factor, factor);
+
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), Blend4SSE2(d, src, factor));
+    }
+    BlendMaskScalar(dst + i, count - i, pixel, alpha + i);
+}
+
+static void BlendPixelsSSE2(uint32_t* dst, const uint32_t* src, int count, unsigned opacity) {
+    const __m128i opaque = _mm_set1_epi32((int)0xFF000000u);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i scale = _mm_set1_epi16((short)opacity);
+    const __m128i half = _mm_set1_epi16(128);
+    int i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i factor = SplatAlphaSSE2(s);
+
+        if (opacity != 255) {
+            __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(factor, zero), scale), half);
+            __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(factor, zero), scale), half);
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+            factor = _mm_packus_epi16(lo, hi);
+        }
+
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        _mm_storeu_si128((__m128i*)(dst + i), Blend4SSE2(d, _mm_or_si128(s, opaque), factor));
+    }
+    BlendPixelsScalar(dst + i, src + i, count - i, opacity);
+}
+#endif /* LG_RASTER_SSE2 */
+
+#ifdef LG_RASTER_AVX2
+/**
+ * @brief Blend 8 opaque source pixels over 8 destination pixels
+ */
+LG_TARGET_AVX2
+static inline __m256i Blend8AVX2(__m256i dst, __m256i src, __m256i alpha) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi16(255);
+    const __m256i half = _mm256_set1_epi16(128);
+
+    // Unpacking and packing both work per 128-bit lane, so pixel order is kept
+    __m256i a_lo = _mm256_unpacklo_epi8(alpha, zero);
+    __m256i a_hi = _mm256_unpackhi_epi8(alpha, zero);
+
+    __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(src, zero), a_lo),
+                                  _mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), _mm256_sub_epi16(max, a_lo)));
+    __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(src, zero), a_hi),
+                                  _mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), _mm256_sub_epi16(max, a_hi)));
+
+    lo = _mm256_add_epi16(lo, half);
+    hi = _mm256_add_epi16(hi, half);
+    lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+    hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+    return _mm256_packus_epi16(lo, hi);
+}
+
+LG_TARGET_AVX2
+static void FillAVX2(uint32_t* dst, int count, uint32_t pixel) {
+    __m256i value = _mm256_set1_epi32((int)pixel);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256((__m256i*)(dst + i), value);
+    }
+    FillScalar(dst + i, count - i, pixel);
+}
+
+LG_TARGET_AVX2
+static void BlendAVX2(uint32_t* dst, int count, uint32_t pixel, unsigned alpha) {
+    __m256i src = _mm256_set1_epi32((int)(pixel | 0xFF000000u));
+    __m256i factor = _mm256_set1_epi8((char)alpha);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), Blend8AVX2(d, src, factor));
+    }
+    BlendScalar(dst + i, count - i, pixel, alpha);
+}
+
+LG_TARGET_AVX2
+static void BlendMaskAVX2(uint32_t* dst, int count, uint32_t pixel, const uint8_t* alpha) {
+    __m256i src = _mm256_set1_epi32((int)(pixel | 0xFF000000u));
+    const __m256i splat = _mm256_set1_epi32(0x01010101);
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        int64_t mask;
+        memcpy(&mask, alpha + i, sizeof(mask));
+        if (mask == 0) continue;
+
+        __m256i factor = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(alpha + i)));
+        factor = _mm256_mullo_epi32(factor, splat);
+
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), Blend8AVX2(d, src, factor));
+    }
+    BlendMaskScalar(dst + i, count - i, pixel, alpha + i);
+}
+
+LG_TARGET_AVX2
+static void BlendPixelsAVX2(uint32_t* dst, const uint32_t* src, int count, unsigned opacity) {
+    const __m256i opaque = _mm256_set1_epi32((int)0xFF000000u);
+    const __m256i splat = _mm256_set1_epi32(0x01010101);
+    const __m256i scale = _mm256_set1_epi32((int)opacity);
+    const __m256i half = _mm256_set1_epi32(128);
+    int i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i alpha = _mm256_srli_epi32(s, 24);
+
+        if (opacity != 255) {
+            alpha = _mm256_add_epi32(_mm256_mullo_epi32(alpha, scale), half);
+            alpha = _mm256_srli_epi32(_mm256_add_epi32(alpha, _mm256_srli_epi32(alpha, 8)), 8);
+        }
+
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i factor = _mm256_mullo_epi32(alpha, splat);
+        _mm256_storeu_si256((__m256i*)(dst + i), Blend8AVX2(d, _mm256_or_si256(s, opaque), factor));
+    }
+    BlendPixelsScalar(dst + i, src + i, count - i, opacity);
+}
+
+/**
+ * @brief Check that both the CPU and the OS support AVX2
+ */
+static bool CpuHasAVX2(void) {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif /* LG_RASTER_AVX2 */
+
+#ifdef LG_RASTER_NEON
+/**
+ * @brief Blend 4 opaque source pixels over 4 destination pixels
+ */
+static inline uint8x16_t Blend4NEON(uint8x16_t dst, uint8x16_t src, uint8x16_t alpha) {
+    uint8x16_t inverse = vmvnq_u8(alpha);
+
+    uint16x8_t lo = vmull_u8(vget_low_u8(src), vget_low_u8(alpha));
+    uint16x8_t hi = vmull_u8(vget_high_u8(src), vget_high_u8(alpha));
+    lo = vmlal_u8(lo, vget_low_u8(dst), vget_low_u8(inverse));
+    hi = vmlal_u8(hi, vget_high_u8(dst), vget_high_u8(inverse));
+
+    // (t + ((t + 128) >> 8) + 128) >> 8 is an exact rounded divide by 255
+    return vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)),
+                       vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+}
+
+/**
+ * @brief Repeat the top byte of each pixel into all of its bytes
+ */
+static inline uint8x16_t SplatAlphaNEON(uint32x4_t pixels) {
+    uint32x4_t alpha = vshrq_n_u32(pixels, 24);
+    return vreinterpretq_u8_u32(vmulq_n_u32(alpha, 0x01010101u));
+}
+
+static void FillNEON(uint32_t* dst, int count, uint32_t pixel) {
+    uint32x4_t value = vdupq_n_u32(pixel);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u32(dst + i, value);
+    }
+    FillScalar(dst + i, count - i, pixel);
+}
+
+static void BlendNEON(uint32_t* dst, int count, uint32_t pixel, unsigned alpha) {
+    uint8x16_t src = vreinterpretq_u8_u32(vdupq_n_u32(pixel | 0xFF000000u));
+    uint8x16_t factor = vdupq_n_u8((uint8_t)alpha);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(Blend4NEON(d, src, factor)));
+    }
+    BlendScalar(dst + i, count - i, pixel, alpha);
+}
+
+static void BlendMaskNEON(uint32_t* dst, int count, uint32_t pixel, const uint8_t* alpha) {
+    uint8x16_t src = vreinterpretq_u8_u32(vdupq_n_u32(pixel | 0xFF000000u));
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32_t mask;
+        memcpy(&mask, alpha + i, sizeof(mask));
+        if (mask == 0) continue;
+
+        uint32x4_t spread = vmovl_u16(vget_low_u16(vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(mask)))));
+        uint8x16_t factor = vreinterpretq_u8_u32(vmulq_n_u32(spread, 0x01010101u));
+
+        uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(Blend4NEON(d, src, factor)));
+    }
+    BlendMaskScalar(dst + i, count - i, pixel, alpha + i);
+}
+
+static void BlendPixelsNEON(uint32_t* dst, const uint32_t* src, int count, unsigned opacity) {
+    const uint32x4_t opaque = vdupq_n_u32(0xFF000000u);
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t s = vld1q_u32(src + i);
+        uint8x16_t factor = SplatAlphaNEON(s);
+
+        if (opacity != 255) {
+            uint8x16_t scale = vdupq_n_u8((uint8_t)opacity);
+            uint16x8_t lo = vmull_u8(vget_low_u8(factor), vget_low_u8(scale));
+            uint16x8_t hi = vmull_u8(vget_high_u8(factor), vget_high_u8(scale));
+            factor = vcombine_u8(vraddhn_u16(lo, vrshrq_n_u16(lo, 8)),
+                                 vraddhn_u16(hi, vrshrq_n_u16(hi, 8)));
+        }
+
+        uint8x16_t d = vreinterpretq_u8_u32(vld1q_u32(dst + i));
+        uint8x16_t opaque_src = vreinterpretq_u8_u32(vorrq_u32(s, opaque));
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(Blend4NEON(d, opaque_src, factor)));
+    }
+    BlendPixelsScalar(dst + i, src + i, count - i, opacity);
+}
+#endif /* LG_RASTER_NEON */
+
+void RasterInitialize(void) {
+    g_kernels.name = "scalar";
+    g_kernels.fill = FillScalar;
+    g_kernels.blend = BlendScalar;
+    g_kernels.blend_mask = BlendMaskScalar;
+    g_kernels.blend_pixels = BlendPixelsScalar;
+
+    // LIGHTGUI_SIMD=0 forces the scalar kernels, e.g. to compare output
+    const char* simd = getenv("LIGHTGUI_SIMD");
+    if (simd && strcmp(simd, "0") == 0) {
+        return;
+    }
+
+#ifdef LG_RASTER_SSE2
+    g_kernels.name = "sse2";
+    g_kernels.fill = FillSSE2;
+    g_kernels.blend = BlendSSE2;
+    g_kernels.blend_mask = BlendMaskSSE2;
+    g_kernels.blend_pixels = BlendPixelsSSE2;
+#endif
+
+#ifdef LG_RASTER_AVX2
+    if (CpuHasAVX2()) {
+        g_kernels.name = "avx2";
+        g_kernels.fill = FillAVX2;
+        g_kernels.blend = BlendAVX2;
+        g_kernels.blend_mask = BlendMaskAVX2;
+        g_kernels.blend_pixels = BlendPixelsAVX2;
+    }
+#endif
+
+#ifdef LG_RASTER_NEON
+    g_kernels.name = "neon";
+    g_kernels.fill = FillNEON;
+    g_kernels.blend = BlendNEON;
+    g_kernels.blend_mask = BlendMaskNEON;
+    g_kernels.blend_pixels = BlendPixelsNEON;
+#endif
+}
+
+const char* RasterKernelName(void) {
+    if (!g_kernels.name) {
+        RasterInitialize();
+    }
+    return g_kernels.name;
+}
+
+/* ========================================================================= */
+/*                        Shape Rasterization                                */
+/* ========================================================================= */
+
+/**
+ * @brief Coverage (0-1) of the pixel centred at (x, y), plus shape parameters
+ */
+typedef float (*CoverageFunc)(const void* shape, float x, float y);
+
+/**
+ * @brief A thick line segment with round caps
+ */
+typedef struct {
+    float x1, y1, x2, y2;
+    float dx, dy;
+    float length_sq;
+    float radius;  // Half the thickness
+} LineShape;
+
+/**
+ * @brief A filled disc or ring
+ */
+typedef struct {
+    float cx, cy;
+    float radius;
+    float half_width;  // Half the ring width, or negative for a filled disc
+} CircleShape;
+
+static uint32_t ColorToPixel(LG_Color color) {
+    return ((uint32_t)color.a << 24) | ((uint32_t)color.r << 16) |
+           ((uint32_t)color.g << 8) | (uint32_t)color.b;
+}
+
+static float Clamp01(float value) {
+    return value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+}
+
+static float LineCoverage(const void* shape, float x, float y) {
+    const LineShape* line = (const LineShape*)shape;
+    float px = x - line->x1;
+    float py = y - line->y1;
+
+    float t = 0.0f;
+    if (line->length_sq > 0.0f) {
+        t = Clamp01((px * line->dx + py * line->dy) / line->length_sq);
+    }
+
+    float ex = px - t * line->dx;
+    float ey = py - t * line->dy;
+    return Clamp01(line->radius + 0.5f - sqrtf(ex * ex + ey * ey));
+}
+
+static float CircleCoverage(const void* shape, float x, float y) {
+    const CircleShape* circle = (const CircleShape*)shape;
+    float dx = x - circle->cx;
+    float dy = y - circle->cy;
+    float distance = sqrtf(dx * dx + dy * dy);
+
+    if (circle->half_width < 0.0f) {
+        return Clamp01(circle->radius + 0.5f - distance);
+    }
+    return Clamp01(circle->half_width + 0.5f - fabsf(distance - circle->radius));
+}
+
+/**
+ * @brief Blend a shape's coverage over the pixels [x0, x1] of row y
+ */
+static void CoverageSpan(const LG_CanvasBuffer* buffer, int y, int x0, int x1,
+                         uint32_t pixel, unsigned alpha, CoverageFunc coverage, const void* shape) {
+    if (x0 < 0) x0 = 0;
+    if (x1 >= buffer->width) x1 = buffer->width - 1;
+
+    uint32_t* row = buffer->pixels + (size_t)y * buffer->stride;
+    uint8_t mask[LG_RASTER_CHUNK];
+
+    for (int start = x0; start <= x1; start += LG_RASTER_CHUNK) {
+        int count = x1 - start + 1;
+        if (count > LG_RASTER_CHUNK) count = LG_RASTER_CHUNK;
+
+        for (int i = 0; i < count; i++) {
+            float value = coverage(shape, (float)(start + i), (float)y) * (float)alpha;
+            mask[i] = (uint8_t)(value + 0.5f);
+        }
+        g_kernels.blend_mask(row + start, count, pixel, mask);
+    }
+}
+
+/**
+ * @brief Fill or blend the pixels [x0, x1] of row y with a constant alpha
+ */
+static void SolidSpan(const LG_CanvasBuffer* buffer, int y, int x0, int x1,
+                      uint32_t pixel, unsigned alpha) {
+    if (x0 < 0) x0 = 0;
+    if (x1 >= buffer->width) x1 = buffer->width - 1;
+    if (x0 > x1) return;
+
+    uint32_t* row = buffer->pixels + (size_t)y * buffer->stride + x0;
+    if (alpha == 255) {
+        g_kernels.fill(row, x1 - x0 + 1, pixel | 0xFF000000u);
+    } else {
+        g_kernels.blend(row, x1 - x0 + 1, pixel, alpha);
+    }
+}
+
+/**
+ * @brief Narrow [lo, hi] to the x values where lo_f <= a * x + b <= hi_f
+ */
+static void ClipLinear(float a, float b, float lo_f, float hi_f, float* lo, float* hi) {
+    if (a == 0.0f) {
+        if (b < lo_f || b > hi_f) {
+            *lo = 1.0f;
+            *hi = 0.0f;
+        }
+        return;
+    }
+
+    float x0 = (lo_f - b) / a;
+    float x1 = (hi_f - b) / a;
+    if (x0 > x1) {
+        float swap = x0;
+        x0 = x1;
+        x1 = swap;
+    }
+    if (x0 > *lo) *lo = x0;
+    if (x1 < *hi) *hi = x1;
+}
+
+/**
+ * @brief Widen [lo, hi] by the chord of the disc (cx, cy, r) at row y
+ */
+static void AddDiscSpan(float cx, float cy, float r, float y, float* lo, float* hi) {
+    float dy = y - cy;
+    if (fabsf(dy) > r) return;
+
+    float half = sqrtf(r * r - dy * dy);
+    if (cx - half < *lo) *lo = cx - half;
+    if (cx + half > *hi) *hi = cx + half;
+}
+
+/* ========================================================================= */
+/*                        Canvas Primitives                                  */
+/* ========================================================================= */
+
+void LG_CanvasClear(LG_WidgetHandle canvas, LG_Color color) {
+    LG_CanvasBuffer buffer;
+    if (!LG_GetCanvasBuffer(canvas, &buffer)) return;
+
+    // Clearing replaces pixels outright, alpha included
+    uint32_t pixel = ColorToPixel(color);
+    for (int y = 0; y < buffer.height; y++) {
+        g_kernels.fill(buffer.pixels + (size_t)y * buffer.stride, buffer.width, pixel);
+    }
+}
+
+void RasterFillRect(const LG_CanvasBuffer* buffer, LG_Rect rect, LG_Color color) {
+    LG_Rect bounds = {0, 0, buffer->width, buffer->height};
+    if (color.a == 0 || !RectIntersect(rect, bounds, &rect)) return;
+
+    uint32_t pixel = ColorToPixel(color);
+    for (int y = rect.y; y < rect.y + rect.height; y++) {
+        SolidSpan(buffer, y, rect.x, rect.x + rect.width - 1, pixel, color.a);
+    }
+}
+
+void LG_CanvasFillRect(LG_WidgetHandle canvas, LG_Rect rect, LG_Color color) {
+    LG_CanvasBuffer buffer;
+    if (color.a == 0 || !LG_GetCanvasBuffer(canvas, &buffer)) return;
+
+    RasterFillRect(&buffer, rect, color);
+}
+
+void LG_CanvasDrawLine(LG_WidgetHandle canvas, int x1, int y1, int x2, int y2,
+                       float thickness, LG_Color color) {
+    LG_CanvasBuffer buffer;
+    if (color.a == 0 || !LG_GetCanvasBuffer(canvas, &buffer)) return;
+
+    LineShape line;
+    line.x1 = (float)x1;
+    line.y1 = (float)y1;
+    line.x2 = (float)x2;
+    line.y2 = (float)y2;
+    line.dx = line.x2 - line.x1;
+    line.dy = line.y2 - line.y1;
+    line.length_sq = line.dx * line.dx + line.dy * line.dy;
+    line.radius = thickness > 1.0f ? thickness * 0.5f : 0.5f;
+
+    // Any pixel whose centre is within reach gets some coverage
+    float reach = line.radius + 0.5f;
+    float length = sqrtf(line.length_sq);
+    int y_min = (int)floorf((y1 < y2 ? line.y1 : line.y2) - reach);
+    int y_max = (int)ceilf((y1 > y2 ? line.y1 : line.y2) + reach);
+    if (y_min < 0) y_min = 0;
+    if (y_max >= buffer.height) y_max = buffer.height - 1;
+
+    uint32_t pixel = ColorToPixel(color);
+    for (int y = y_min; y <= y_max; y++) {
+        float fy = (float)y;
+        float lo = 1.0f, hi = 0.0f;
+
+        // The shape is convex: the row crosses the band and the two caps
+        if (length > 0.0f) {
+            float band_lo = -1e9f, band_hi = 1e9f;
+            float py = fy - line.y1;
+            ClipLinear(line.dx / line.length_sq, (-line.x1 * line.dx + py * line.dy) / line.length_sq,
+                       0.0f, 1.0f, &band_lo, &band_hi);
+            ClipLinear(line.dy / length, (-line.x1 * line.dy - py * line.dx) / length,
+                       -reach, reach, &band_lo, &band_hi);
+            if (band_lo <= band_hi) {
+                lo = band_lo;
+                hi = band_hi;
+            }
+        }
+
+        if (lo > hi) {
+            lo = 1e9f;
+            hi = -1e9f;
+        }
+        AddDiscSpan(line.x1, line.y1, reach, fy, &lo, &hi);
+        AddDiscSpan(line.x2, line.y2, reach, fy, &lo, &hi);
+        if (lo > hi) continue;
+
+        CoverageSpan(&buffer, y, (int)floorf(lo), (int)ceilf(hi), pixel, color.a,
+                     LineCoverage, &line);
+    }
+}
+
+void LG_CanvasDrawCircle(LG_WidgetHandle canvas, int cx, int cy, int radius,
+                         LG_Color color, bool filled) {
+    LG_CanvasBuffer buffer;
+    if (color.a == 0 || radius < 0 || !LG_GetCanvasBuffer(canvas, &buffer)) return;
+
+    CircleShape circle;
+    circle.cx = (float)cx;
+    circle.cy = (float)cy;
+    circle.radius = (float)radius;
+    circle.half_width = filled ? -1.0f : 0.5f;
+
+    // Outside outer nothing is drawn; inside inner is solid (filled) or empty (ring)
+    float outer = filled ? circle.radius + 0.5f : circle.radius + 1.0f;
+    float inner = filled ? circle.radius - 0.5f : circle.radius - 1.0f;
+
+    int y_min = cy - (int)ceilf(outer);
+    int y_max = cy + (int)ceilf(outer);
+    if (y_min < 0) y_min = 0;
+    if (y_max >= buffer.height) y_max = buffer.height - 1;
+
+    uint32_t pixel = ColorToPixel(color);
+    for (int y = y_min; y <= y_max; y++) {
+        float dy = (float)(y - cy);
+        if (fabsf(dy) > outer) continue;
+
+        int outer_x = (int)ceilf(sqrtf(outer * outer - dy * dy));
+        int inner_x = -1;  // Pixels with |dx| <= inner_x are entirely inside
+        if (inner > 0.0f && fabsf(dy) < inner) {
+            inner_x = (int)floorf(sqrtf(inner * inner - dy * dy));
+        }
+
+        if (inner_x < 0) {
+            CoverageSpan(&buffer, y, cx - outer_x, cx + outer_x, pixel, color.a,
+                         CircleCoverage, &circle);
+            continue;
+        }
+
+        CoverageSpan(&buffer, y, cx - outer_x, cx - inner_x - 1, pixel, color.a,
+                     CircleCoverage, &circle);
+        if (filled) {
+            SolidSpan(&buffer, y, cx - inner_x, cx + inner_x, pixel, color.a);
+        }
+        CoverageSpan(&buffer, y, cx + inner_x + 1, cx + outer_x, pixel, color.a,
+                     CircleCoverage, &circle);
+    }
+}
+
+void LG_CanvasBlit(LG_WidgetHandle canvas, int x, int y, const LG_CanvasBuffer* source,
+                   uint8_t opacity) {
+    LG_CanvasBuffer buffer;
+    if (!source || !source->pixels || opacity == 0 || !LG_GetCanvasBuffer(canvas, &buffer)) return;
+
+    LG_Rect target = {x, y, source->width, source->height};
+    LG_Rect bounds = {0, 0, buffer.width, buffer.height};
+    if (!RectIntersect(target, bounds, &target)) return;
+
+    for (int row = 0; row < target.height; row++) {
+        const uint32_t* src = source->pixels + (size_t)(target.y - y + row) * source->stride +
+                              (target.x - x);
+        uint32_t* dst = buffer.pixels + (size_t)(target.y + row) * buffer.stride + target.x;
+        g_kernels.blend_pixels(dst, src, target.width, opacity);
+    }
+}
+
+/* ========================================================================= */
+/*                        Text                                               */
+/* ========================================================================= */
+
+static LG_GlyphAtlas g_atlas;
+static bool g_atlas_failed = false;  // Don't retry a failed build on every call
+
+static const LG_GlyphAtlas* GetGlyphAtlas(void) {
+    if (!g_atlas.coverage && !g_atlas_failed) {
+        if (!LG_PlatformBuildGlyphAtlas(&g_atlas) || !g_atlas.coverage) {
+            fprintf(stderr, "LightGUI: Failed to build glyph atlas\n");
+            memset(&g_atlas, 0, sizeof(g_atlas));
+            g_atlas_failed = true;
+        }
+    }
+    return g_atlas.coverage ? &g_atlas : NULL;
+}
+
+void RasterTerminate(void) {
+    free(g_atlas.coverage);
+    memset(&g_atlas, 0, sizeof(g_atlas));
+    g_atlas_failed = false;
+}
+
+static int GlyphIndex(unsigned char c) {
+    return (c >= LG_GLYPH_FIRST && c < LG_GLYPH_FIRST + LG_GLYPH_COUNT) ? c - LG_GLYPH_FIRST
+                                                                        : '?' - LG_GLYPH_FIRST;
+}
+
+static int TextWidth(const LG_GlyphAtlas* atlas, const char* text) {
+    int width = 0;
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        width += atlas->advance[GlyphIndex(*c)];
+    }
+    return width;
+}
+
+bool LG_CanvasMeasureText(const char* text, int* width, int* height) {
+    const LG_GlyphAtlas* atlas = text ? GetGlyphAtlas() : NULL;
+    if (!atlas) return false;
+
+    if (width) *width = TextWidth(atlas, text);
+    if (height) *height = atlas->ascent + atlas->descent;
+    return true;
+}
+
+int RasterTextHeight(void) {
+    const LG_GlyphAtlas* atlas = GetGlyphAtlas();
+    return atlas ? atlas->ascent + atlas->descent : 0;
+}
+
+int RasterDrawText(const LG_CanvasBuffer* buffer, int x, int y, const char* text, LG_Color color) {
+    const LG_GlyphAtlas* atlas = text ? GetGlyphAtlas() : NULL;
+    if (!atlas) return 0;
+
+    int width = TextWidth(atlas, text);
+    if (color.a == 0) return width;
+
+    // Glyph cells may reach origin_x left of the pen and past the last advance
+    int height = atlas->ascent + atlas->descent;
+    int left = x - atlas->origin_x;
+    int right = x + width + atlas->cell_width - atlas->origin_x;
+
+    LG_Rect area = {left, y, right - left, height};
+    LG_Rect bounds = {0, 0, buffer->width, buffer->height};
+    if (!RectIntersect(area, bounds, &area)) return width;
+
+    uint32_t pixel = ColorToPixel(color);
+    uint8_t mask[LG_RASTER_CHUNK];
+
+    // Build each row's coverage for the whole string, then blend it in one go
+    for (int row = area.y; row < area.y + area.height; row++) {
+        const uint8_t* atlas_row = atlas->coverage + (size_t)(row - y) * atlas->stride;
+        uint32_t* dst = buffer->pixels + (size_t)row * buffer->stride;
+
+        for (int start = area.x; start < area.x + area.width; start += LG_RASTER_CHUNK) {
+            int count = area.x + area.width - start;
+            if (count > LG_RASTER_CHUNK) count = LG_RASTER_CHUNK;
+            memset(mask, 0, (size_t)count);
+
+            int pen = x;
+            for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+                int glyph = GlyphIndex(*c);
+                int cell_x = pen - atlas->origin_x;
+                if (cell_x >= start + count) break;
+                pen += atlas->advance[glyph];
+
+                int from = cell_x > start ? cell_x : start;
+                int to = cell_x + atlas->cell_width < start + count ? cell_x + atlas->cell_width
+                                                                    : start + count;
+                const uint8_t* src = atlas_row + glyph * atlas->cell_width;
+                for (int i = from; i < to; i++) {
+                    // Neighbouring cells can overlap; keep the stronger coverage
+                    uint8_t value = src[i - cell_x];
+                    if (value > mask[i - start]) mask[i - start] = value;
+                }
+            }
+
+            if (color.a != 255) {
+                for (int i = 0; i < count; i++) {
+                    mask[i] = (uint8_t)Div255(mask[i] * color.a);
+                }
+            }
+            g_kernels.blend_mask(dst + start, count, pixel, mask);
+        }
+    }
+    return width;
+}
+
+int LG_CanvasDrawText(LG_WidgetHandle canvas, int x, int y, const char* text, LG_Color color) {
+    LG_CanvasBuffer buffer;
+    if (color.a == 0 || !LG_GetCanvasBuffer(canvas, &buffer)) {
+        int width = 0;
+        LG_CanvasMeasureText(text, &width, NULL);
+        return width;
+    }
+
+    return RasterDrawText(&buffer, x, y, text, color);
+}
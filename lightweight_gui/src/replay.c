@@ -0,0 +1,731 @@
+/**
+ * @file replay.c
+ * @brief Recording the input that reaches event callbacks, and replaying it
+ *
+ * A recording is the magic "LGR1" followed by one record per event, all
+ * integers little-endian:
+ *
+ *   u32 microseconds since the previous record (or the start)
+ *   u8  LG_EventType
+ *   u16 window, as its index among the open windows
+ *   payload:
+ *     mouse move      i32 x, y, delta_x, delta_y; u32 n; n x (i32 x, i32 y) history
+ *     mouse button    u8 button, u8 pressed; i32 x, y
+ *     key             i32 key_code; u8 pressed | ctrl << 1 | shift << 2 | alt << 3
+ *     window resize   i32 width, height
+ *     window close    nothing
+ *     widget clicked  u32 widget, as its index in the window; i32 x, y
+ *
+ * A replay reads the whole file up front and checks every record, then
+ * the event loop dispatches the records as they fall due. Each replayed
+ * input opens a latency sample that the next present completes.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RECORDING_MAGIC "LGR1"
+#define RECORDING_MAGIC_SIZE 4
+
+/* Longest motion history a record may hold */
+#define MAX_RECORDED_HISTORY (1u << 20)
+
+/**
+ * @brief Buffered little-endian output to a recording
+ */
+typedef struct {
+    uint8_t bytes[256];
+    size_t length;
+} RecordWriter;
+
+/**
+ * @brief Little-endian input from a recording in memory
+ */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+    size_t offset;
+} RecordReader;
+
+/**
+ * @brief A decoded record
+ */
+typedef struct {
+    uint32_t delta_us;
+    uint16_t window;
+    uint32_t widget;  // Widget clicked events only
+    size_t history_offset;  // Where the motion history starts in the file
+    LG_Event event;
+} Record;
+
+static FILE* g_record_file = NULL;
+static uint64_t g_record_time = 0;  // LG_PlatformGetTime() of the previous record
+
+static bool g_replaying = false;
+static uint8_t* g_replay_data = NULL;  // The whole recording
+static size_t g_replay_size = 0;
+static size_t g_replay_offset = 0;  // The next record
+static LG_ReplaySpeed g_replay_speed = LG_REPLAY_REALTIME;
+static LG_ReplayCallback g_replay_callback = NULL;
+static void* g_replay_user_data = NULL;
+static uint64_t g_replay_start = 0;  // LG_PlatformGetTime() when the replay started
+static uint64_t g_replay_clock = 0;  // Recorded time of the last dispatched record
+static LG_ReplayReport g_report;
+static bool g_awaiting_present = false;  // Dispatched since the last latency sample
+static uint64_t g_dispatch_frames = 0;  // g_stats.frames at the last dispatch
+static LG_Point* g_history = NULL;  // Motion history of the record being dispatched
+static size_t g_history_capacity = 0;
+static LG_Point g_history_position;  // History of one, if g_history cannot hold the record's
+static uint32_t* g_samples = NULL;  // Every latency sample of the replay
+static size_t g_sample_count = 0;
+static size_t g_sample_capacity = 0;
+
+/* ========================================================================= */
+/*                        Encoding                                           */
+/* ========================================================================= */
+
+static bool FlushWriter(RecordWriter* writer) {
+    bool written = fwrite(writer->bytes, 1, writer->length, g_record_file) == writer->length;
+    writer->length = 0;
+    return written;
+}
+
+static bool PutU32(RecordWriter* writer, uint32_t value) {
+    if (writer->length + 4 > sizeof(writer->bytes) && !FlushWriter(writer)) {
+        return false;
+    }
+    for (int i = 0; i < 4; i++) {
+        writer->bytes[writer->length++] = (uint8_t)(value >> (8 * i));
+    }
+    return true;
+}
+
+static bool PutU16(RecordWriter* writer, uint16_t value) {
+    if (writer->length + 2 > sizeof(writer->bytes) && !FlushWriter(writer)) {
+        return false;
+    }
+    writer->bytes[writer->length++] = (uint8_t)value;
+    writer->bytes[writer->length++] = (uint8_t)(value >> 8);
+    return true;
+}
+
+static bool PutU8(RecordWriter* writer, uint8_t value) {
+    if (writer->length + 1 > sizeof(writer->bytes) && !FlushWriter(writer)) {
+        return false;
+    }
+    writer->bytes[writer->length++] = value;
+    return true;
+}
+
+static bool PutI32(RecordWriter* writer, int value) {
+    return PutU32(writer, (uint32_t)value);
+}
+
+static bool GetU32(RecordReader* reader, uint32_t* value) {
+    if (reader->size - reader->offset < 4) {
+        return false;
+    }
+    const uint8_t* bytes = reader->data + reader->offset;
+    *value = (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 |
+             (uint32_t)bytes[3] << 24;
+    reader->offset += 4;
+    return true;
+}
+
+static bool GetU16(RecordReader* reader, uint16_t* value) {
+    if (reader->size - reader->offset < 2) {
+        return false;
+    }
+    const uint8_t* bytes = reader->data + reader->offset;
+    *value = (uint16_t)(bytes[0] | bytes[1] << 8);
+    reader->offset += 2;
+    return true;
+}
+
+static bool GetU8(RecordReader* reader, uint8_t* value) {
+    if (reader->size - reader->offset < 1) {
+        return false;
+    }
+    *value = reader->data[reader->offset++];
+    return true;
+}
+
+static bool GetI32(RecordReader* reader, int* value) {
+    uint32_t bits;
+    if (!GetU32(reader, &bits)) {
+        return false;
+    }
+    *value = (int)(int32_t)bits;
+    return true;
+}
+
+/**
+ * @brief Decode the next record, leaving its motion history in the file
+ *
+ * @return false if the record is truncated or malformed
+ */
+static bool ReadRecord(RecordReader* reader, Record* record) {
+    memset(record, 0, sizeof(*record));
+
+    uint8_t type;
+    if (!GetU32(reader, &record->delta_us) || !GetU8(reader, &type) ||
+        !GetU16(reader, &record->window)) {
+        return false;
+    }
+    record->event.type = (LG_EventType)type;
+
+    LG_Event* event = &record->event;
+    uint8_t flags;
+    switch (event->type) {
+        case LG_EVENT_MOUSE_MOVE:
+            {
+                uint32_t count;
+                if (!GetI32(reader, &event->data.mouse_move.x) ||
+                    !GetI32(reader, &event->data.mouse_move.y) ||
+                    !GetI32(reader, &event->data.mouse_move.delta_x) ||
+                    !GetI32(reader, &event->data.mouse_move.delta_y) ||
+                    !GetU32(reader, &count) || count > MAX_RECORDED_HISTORY ||
+                    reader->size - reader->offset < (size_t)count * 8) {
+                    return false;
+                }
+                event->data.mouse_move.history_count = count;
+                record->history_offset = reader->offset;
+                reader->offset += (size_t)count * 8;
+            }
+            return true;
+
+        case LG_EVENT_MOUSE_BUTTON:
+            {
+                uint8_t button;
+                if (!GetU8(reader, &button) || !GetU8(reader, &flags) ||
+                    !GetI32(reader, &event->data.mouse_button.x) ||
+                    !GetI32(reader, &event->data.mouse_button.y)) {
+                    return false;
+                }
+                event->data.mouse_button.button = (LG_MouseButton)button;
+                event->data.mouse_button.pressed = flags != 0;
+            }
+            return true;
+
+        case LG_EVENT_KEY:
+            if (!GetI32(reader, &event->data.key.key_code) || !GetU8(reader, &flags)) {
+                return false;
+            }
+            event->data.key.pressed = (flags & 1) != 0;
+            event->data.key.ctrl = (flags & 2) != 0;
+            event->data.key.shift = (flags & 4) != 0;
+            event->data.key.alt = (flags & 8) != 0;
+            return true;
+
+        case LG_EVENT_WINDOW_RESIZE:
+            return GetI32(reader, &event->data.window_resize.width) &&
+                   GetI32(reader, &event->data.window_resize.height);
+
+        case LG_EVENT_WINDOW_CLOSE:
+            return true;
+
+        case LG_EVENT_WIDGET_CLICKED:
+            return GetU32(reader, &record->widget) &&
+                   GetI32(reader, &event->data.widget_clicked.x) &&
+                   GetI32(reader, &event->data.widget_clicked.y);
+
+        default:
+            return false;
+    }
+}
+
+/* ========================================================================= */
+/*                        Recording                                          */
+/* ========================================================================= */
+
+/**
+ * @brief Find a window's index among the open windows
+ *
+ * @return The index, or -1 if the window is not in g_windows
+ */
+static int WindowIndex(LG_WindowHandle window) {
+    for (size_t i = 0; i < g_windows.count && i <= UINT16_MAX; i++) {
+        if (g_windows.windows[i] == window) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Encode an event; the caller checks that its type can be recorded
+ */
+static bool WriteRecord(RecordWriter* writer, uint32_t delta_us, int window_index,
+                        LG_WindowHandle window, const LG_Event* event) {
+    if (!PutU32(writer, delta_us) || !PutU8(writer, (uint8_t)event->type) ||
+        !PutU16(writer, (uint16_t)window_index)) {
+        return false;
+    }
+
+    switch (event->type) {
+        case LG_EVENT_MOUSE_MOVE:
+            {
+                const LG_MouseMoveEvent* move = &event->data.mouse_move;
+                size_t count = move->history_count < MAX_RECORDED_HISTORY
+                    ? move->history_count : MAX_RECORDED_HISTORY;
+                if (!PutI32(writer, move->x) || !PutI32(writer, move->y) ||
+                    !PutI32(writer, move->delta_x) || !PutI32(writer, move->delta_y) ||
+                    !PutU32(writer, (uint32_t)count)) {
+                    return false;
+                }
+
+                // Keep the newest samples if the history is cut short
+                const LG_Point* history = move->history + (move->history_count - count);
+                for (size_t i = 0; i < count; i++) {
+                    if (!PutI32(writer, history[i].x) || !PutI32(writer, history[i].y)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+
+        case LG_EVENT_MOUSE_BUTTON:
+            return PutU8(writer, (uint8_t)event->data.mouse_button.button) &&
+                   PutU8(writer, event->data.mouse_button.pressed ? 1 : 0) &&
+                   PutI32(writer, event->data.mouse_button.x) &&
+                   PutI32(writer, event->data.mouse_button.y);
+
+        case LG_EVENT_KEY:
+            {
+                const LG_KeyEvent* key = &event->data.key;
+                uint8_t flags = (uint8_t)((key->pressed ? 1 : 0) | (key->ctrl ? 2 : 0) |
+                                          (key->shift ? 4 : 0) | (key->alt ? 8 : 0));
+                return PutI32(writer, key->key_code) && PutU8(writer, flags);
+            }
+
+        case LG_EVENT_WINDOW_RESIZE:
+            return PutI32(writer, event->data.window_resize.width) &&
+                   PutI32(writer, event->data.window_resize.height);
+
+        case LG_EVENT_WIDGET_CLICKED:
+            {
+                // Looked up here, once per click, rather than kept on every widget
+                LG_WidgetList* widgets = &window->widgets;
+                size_t index = 0;
+                while (index < widgets->count &&
+                       widgets->widgets[index] != event->data.widget_clicked.widget) {
+                    index++;
+                }
+                return PutU32(writer, index < widgets->count ? (uint32_t)index : UINT32_MAX) &&
+                       PutI32(writer, event->data.widget_clicked.x) &&
+                       PutI32(writer, event->data.widget_clicked.y);
+            }
+
+        default:
+            return true;
+    }
+}
+
+void RecordEvent(LG_WindowHandle window, const LG_Event* event) {
+    if (!g_record_file) {
+        return;
+    }
+
+    // User and process events carry pointers that mean nothing in another run
+    switch (event->type) {
+        case LG_EVENT_MOUSE_MOVE:
+        case LG_EVENT_MOUSE_BUTTON:
+        case LG_EVENT_KEY:
+        case LG_EVENT_WINDOW_RESIZE:
+        case LG_EVENT_WINDOW_CLOSE:
+        case LG_EVENT_WIDGET_CLICKED:
+            break;
+        default:
+            return;
+    }
+
+    int window_index = WindowIndex(window);
+    if (window_index < 0) {
+        return;
+    }
+
+    uint64_t now = LG_PlatformGetTime();
+    uint64_t delta = now - g_record_time;
+    g_record_time = now;
+
+    RecordWriter writer;
+    writer.length = 0;
+    if (!WriteRecord(&writer, delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta, window_index,
+                     window, event) || !FlushWriter(&writer)) {
+        fprintf(stderr, "LightGUI: Failed to write recording; recording stopped\n");
+        LG_StopRecording();
+    }
+}
+
+bool LG_StartRecording(const char* path) {
+    if (!path) {
+        return false;
+    }
+    if (g_record_file) {
+        fprintf(stderr, "LightGUI: Already recording\n");
+        return false;
+    }
+    if (g_replaying) {
+        fprintf(stderr, "LightGUI: Cannot record during a replay\n");
+        return false;
+    }
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        fprintf(stderr, "LightGUI: Failed to open %s\n", path);
+        return false;
+    }
+    if (fwrite(RECORDING_MAGIC, 1, RECORDING_MAGIC_SIZE, file) != RECORDING_MAGIC_SIZE) {
+        fprintf(stderr, "LightGUI: Failed to write %s\n", path);
+        fclose(file);
+        return false;
+    }
+
+    g_record_file = file;
+    g_record_time = LG_PlatformGetTime();
+    return true;
+}
+
+void LG_StopRecording(void) {
+    if (!g_record_file) {
+        return;
+    }
+
+    if (fclose(g_record_file) != 0) {
+        fprintf(stderr, "LightGUI: Failed to finish recording\n");
+    }
+    g_record_file = NULL;
+}
+
+/* ========================================================================= */
+/*                        Replay                                             */
+/* ========================================================================= */
+
+static void ReplayLatencySample(uint32_t latency_us) {
+    g_awaiting_present = false;
+
+    if (g_sample_count == g_sample_capacity) {
+        size_t capacity = g_sample_capacity ? g_sample_capacity * 2 : 1024;
+        uint32_t* samples = (uint32_t*)realloc(g_samples, capacity * sizeof(uint32_t));
+        if (!samples) {
+            return;
+        }
+        g_samples = samples;
+        g_sample_capacity = capacity;
+    }
+    g_samples[g_sample_count++] = latency_us;
+}
+
+/**
+ * @brief Read a whole file into memory
+ */
+static uint8_t* ReadFile(const char* path, size_t* size) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        fprintf(stderr, "LightGUI: Failed to open %s\n", path);
+        return NULL;
+    }
+
+    uint8_t* data = NULL;
+    long length = -1;
+    if (fseek(file, 0, SEEK_END) == 0) {
+        length = ftell(file);
+    }
+    if (length >= 0 && fseek(file, 0, SEEK_SET) == 0) {
+        data = (uint8_t*)malloc(length > 0 ? (size_t)length : 1);
+        if (data && fread(data, 1, (size_t)length, file) != (size_t)length) {
+            free(data);
+            data = NULL;
+        }
+    }
+    fclose(file);
+
+    if (!data) {
+        fprintf(stderr, "LightGUI: Failed to read %s\n", path);
+        return NULL;
+    }
+    *size = (size_t)length;
+    return data;
+}
+
+/**
+ * @brief Check that a recording holds nothing but whole, known records
+ */
+static bool ValidRecording(const uint8_t* data, size_t size) {
+    if (size < RECORDING_MAGIC_SIZE || memcmp(data, RECORDING_MAGIC, RECORDING_MAGIC_SIZE) != 0) {
+        return false;
+    }
+
+    RecordReader reader = {data, size, RECORDING_MAGIC_SIZE};
+    Record record;
+    while (reader.offset < reader.size) {
+        if (!ReadRecord(&reader, &record)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Free everything a replay holds, without reporting
+ */
+static void EndReplay(void) {
+    StatsSetLatencySink(NULL);
+    free(g_replay_data);
+    g_replay_data = NULL;
+    g_replay_size = 0;
+    free(g_history);
+    g_history = NULL;
+    g_history_capacity = 0;
+    free(g_samples);
+    g_samples = NULL;
+    g_sample_count = 0;
+    g_sample_capacity = 0;
+    g_replaying = false;
+}
+
+static int CompareSamples(const void* a, const void* b) {
+    uint32_t sa = *(const uint32_t*)a;
+    uint32_t sb = *(const uint32_t*)b;
+    return (sa > sb) - (sa < sb);
+}
+
+/**
+ * @brief Summarize the latency samples and hand the report to the callback
+ */
+static void FinishReplay(void) {
+    LG_ReplayReport report = g_report;
+    report.duration_us = LG_PlatformGetTime() - g_replay_start;
+    report.latency_samples = g_sample_count;
+    if (g_sample_count > 0) {
+        qsort(g_samples, g_sample_count, sizeof(uint32_t), CompareSamples);
+        report.latency_p50_us = g_samples[g_sample_count / 2];
+        report.latency_p90_us = g_samples[(g_sample_count * 90) / 100];
+        report.latency_p99_us = g_samples[(g_sample_count * 99) / 100];
+        report.latency_max_us = g_samples[g_sample_count - 1];
+    }
+
+    // The callback may start another replay
+    LG_ReplayCallback callback = g_replay_callback;
+    void* user_data = g_replay_user_data;
+    EndReplay();
+    if (callback) {
+        callback(&report, user_data);
+    }
+}
+
+/**
+ * @brief Point a replayed motion event at its recorded history
+ */
+static void LoadHistory(const Record* record, LG_Event* event) {
+    LG_MouseMoveEvent* move = &event->data.mouse_move;
+    size_t count = move->history_count;
+    if (count > g_history_capacity) {
+        LG_Point* history = (LG_Point*)realloc(g_history, count * sizeof(LG_Point));
+        if (history) {
+            g_history = history;
+            g_history_capacity = count;
+        }
+    }
+
+    if (count == 0 || count > g_history_capacity) {
+        // Like platform motion, the history always ends with the position
+        g_history_position.x = move->x;
+        g_history_position.y = move->y;
+        move->history = &g_history_position;
+        move->history_count = 1;
+        return;
+    }
+
+    RecordReader reader = {g_replay_data, g_replay_size, record->history_offset};
+    for (size_t i = 0; i < count; i++) {
+        GetI32(&reader, &g_history[i].x);
+        GetI32(&reader, &g_history[i].y);
+    }
+    move->history = g_history;
+}
+
+/**
+ * @brief Deliver a record to its window as the platform would have
+ *
+ * @return false if its window or widget does not exist in this run
+ */
+static bool DispatchRecord(Record* record) {
+    if (record->window >= g_windows.count) {
+        return false;
+    }
+    LG_WindowHandle window = g_windows.windows[record->window];
+    LG_Event* event = &record->event;
+
+    switch (event->type) {
+        case LG_EVENT_WINDOW_RESIZE:
+            // Only surfaces the backend owns outright can be resized from here
+            return LG_InjectEvent(window, event);
+
+        case LG_EVENT_WIDGET_CLICKED:
+            {
+                if (record->widget >= window->widgets.count) {
+                    return false;
+                }
+                LG_WidgetHandle widget = window->widgets.widgets[record->widget];
+                event->data.widget_clicked.widget = widget;
+
+                // The platforms select the clicked row before reporting the click
+                if (widget->type == LG_WIDGET_LIST) {
+                    ListClick(widget, event->data.widget_clicked.y);
+                }
+            }
+            break;
+
+        case LG_EVENT_MOUSE_MOVE:
+            LoadHistory(record, event);
+            window->last_mouse.x = event->data.mouse_move.x;
+            window->last_mouse.y = event->data.mouse_move.y;
+            window->has_mouse_position = true;
+            break;
+
+        default:
+            break;
+    }
+
+    DispatchWindowEvent(window, event);
+    return true;
+}
+
+/**
+ * @brief Check whether the input dispatched last has been rendered
+ */
+static bool ReplayRendered(void) {
+    if (!g_awaiting_present || g_stats.frames != g_dispatch_frames) {
+        return true;
+    }
+
+    // Input that damaged nothing will never be presented
+    for (size_t i = 0; i < g_windows.count; i++) {
+        LG_WindowHandle window = g_windows.windows[i];
+        if (window->resize_pending || (window->visible && window->damage.count > 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get the recorded time of the next record, from its delta
+ */
+static uint64_t NextRecordTime(void) {
+    RecordReader reader = {g_replay_data, g_replay_size, g_replay_offset};
+    uint32_t delta_us = 0;
+    GetU32(&reader, &delta_us);
+    return g_replay_clock + delta_us;
+}
+
+void RunReplay(void) {
+    if (!g_replaying) {
+        return;
+    }
+
+    uint64_t now = LG_PlatformGetTime();
+    while (g_replay_offset < g_replay_size) {
+        if (g_replay_speed == LG_REPLAY_REALTIME && g_replay_start + NextRecordTime() > now) {
+            break;
+        }
+
+        RecordReader reader = {g_replay_data, g_replay_size, g_replay_offset};
+        Record record;
+        ReadRecord(&reader, &record);
+        g_replay_offset = reader.offset;
+        g_replay_clock += record.delta_us;
+
+        g_awaiting_present = true;
+        g_dispatch_frames = g_stats.frames;
+        if (DispatchRecord(&record)) {
+            g_report.events++;
+        } else {
+            g_report.skipped_events++;
+        }
+
+        // The callback may have stopped the replay, or started another
+        if (!g_replaying || g_replay_speed == LG_REPLAY_FAST) {
+            return;
+        }
+    }
+
+    if (g_replay_offset == g_replay_size && ReplayRendered()) {
+        FinishReplay();
+    }
+}
+
+int ReplayWaitTimeout(int timeout_ms) {
+    if (!g_replaying) {
+        return timeout_ms;
+    }
+    if (g_replay_offset == g_replay_size) {
+        // Don't block before the next iteration reports a finished replay
+        return ReplayRendered() ? 0 : timeout_ms;
+    }
+    if (g_replay_speed == LG_REPLAY_FAST) {
+        return 0;
+    }
+
+    uint64_t now = LG_PlatformGetTime();
+    uint64_t due = g_replay_start + NextRecordTime();
+    int64_t wait_ms = due > now ? (int64_t)((due - now + 999) / 1000) : 0;
+    if (timeout_ms >= 0 && wait_ms >= timeout_ms) {
+        return timeout_ms;
+    }
+    return wait_ms > INT32_MAX ? INT32_MAX : (int)wait_ms;
+}
+
+bool LG_StartReplay(const char* path, LG_ReplaySpeed speed, LG_ReplayCallback callback,
+                    void* user_data) {
+    if (!path) {
+        return false;
+    }
+    if (g_replaying) {
+        fprintf(stderr, "LightGUI: A replay is already running\n");
+        return false;
+    }
+    if (g_record_file) {
+        fprintf(stderr, "LightGUI: Cannot replay while recording\n");
+        return false;
+    }
+
+    size_t size;
+    uint8_t* data = ReadFile(path, &size);
+    if (!data) {
+        return false;
+    }
+    if (!ValidRecording(data, size)) {
+        fprintf(stderr, "LightGUI: %s is not a valid recording\n", path);
+        free(data);
+        return false;
+    }
+
+    g_replay_data = data;
+    g_replay_size = size;
+    g_replay_offset = RECORDING_MAGIC_SIZE;
+    g_replay_speed = speed;
+    g_replay_callback = callback;
+    g_replay_user_data = user_data;
+    g_replay_start = LG_PlatformGetTime();
+    g_replay_clock = 0;
+    memset(&g_report, 0, sizeof(g_report));
+    g_awaiting_present = false;
+    g_replaying = true;
+    StatsSetLatencySink(ReplayLatencySample);
+    return true;
+}
+
+void LG_StopReplay(void) {
+    if (g_replaying) {
+        EndReplay();
+    }
+}
+
+void ReplayTerminate(void) {
+    LG_StopRecording();
+    LG_StopReplay();
+}
@@ -0,0 +1,311 @@
+/**
+ * @file spatial.c
+ * @brief Per-window spatial index over widget rectangles
+ *
+ * Widgets are bucketed into a uniform grid of square cells. Cells are
+ * stored in an open-addressing hash table keyed by cell coordinates, so
+ * widgets outside the window (scrolled lists, negative positions) need no
+ * special casing. A point lookup touches one cell; a rectangle lookup
+ * touches the cells it covers. Results are ordered by z_order so callers
+ * see widgets bottom to top, the order in which they were created.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Cell edge length in pixels */
+#define LG_SPATIAL_CELL_SIZE 64
+
+/**
+ * @brief One grid cell and the widgets overlapping it
+ */
+typedef struct {
+    int cx;
+    int cy;
+    bool used;  // The slot holds a cell (possibly with no widgets left)
+    LG_WidgetHandle* widgets;
+    int count;
+    int capacity;
+} SpatialCell;
+
+struct LG_SpatialIndex {
+    SpatialCell* cells;
+    size_t capacity;  // Power of two
+    size_t used;
+    unsigned int stamp;  // Marks widgets already collected by the current query
+    LG_WidgetHandle* results;  // Storage for query results
+    size_t result_capacity;
+};
+
+static int CellCoord(int value) {
+    // Floor division, also for negative coordinates
+    return value >= 0 ? value / LG_SPATIAL_CELL_SIZE
+                      : -((-value + LG_SPATIAL_CELL_SIZE - 1) / LG_SPATIAL_CELL_SIZE);
+}
+
+static size_t CellHash(int cx, int cy) {
+    uint32_t h = (uint32_t)cx * 0x9E3779B1u ^ (uint32_t)cy * 0x85EBCA77u;
+    return (size_t)(h ^ (h >> 15));
+}
+
+/**
+ * @brief Find a cell, or the empty slot where it would go
+ */
+static SpatialCell* FindSlot(SpatialCell* cells, size_t capacity, int cx, int cy) {
+    size_t mask = capacity - 1;
+    size_t i = CellHash(cx, cy) & mask;
+    while (cells[i].used && (cells[i].cx != cx || cells[i].cy != cy)) {
+        i = (i + 1) & mask;
+    }
+    return &cells[i];
+}
+
+static bool GrowCells(LG_SpatialIndex* index) {
+    size_t capacity = index->capacity ? index->capacity * 2 : 64;
+    SpatialCell* cells = (SpatialCell*)calloc(capacity, sizeof(SpatialCell));
+    if (!cells) {
+        fprintf(stderr, "LightGUI: Failed to grow spatial index\n");
+        return false;
+    }
+
+    for (size_t i = 0; i < index->capacity; i++) {
+        SpatialCell* cell = &index->cells[i];
+        if (cell->used) {
+            *FindSlot(cells, capacity, cell->cx, cell->cy) = *cell;
+        }
+    }
+
+    free(index->cells);
+    index->cells = cells;
+    index->capacity = capacity;
+    return true;
+}
+
+static SpatialCell* GetCell(LG_SpatialIndex* index, int cx, int cy, bool create) {
+    if (index->capacity) {
+        SpatialCell* cell = FindSlot(index->cells, index->capacity, cx, cy);
+        if (cell->used || !create) {
+            return cell->used ? cell : NULL;
+        }
+    } else if (!create) {
+        return NULL;
+    }
+
+    // Keep the load factor below 3/4 so probes stay short
+    if ((index->used + 1) * 4 > index->capacity * 3 && !GrowCells(index)) {
+        return NULL;
+    }
+
+    SpatialCell* cell = FindSlot(index->cells, index->capacity, cx, cy);
+    cell->cx = cx;
+    cell->cy = cy;
+    cell->used = true;
+    index->used++;
+    return cell;
+}
+
+/**
+ * @brief Get the range of cells covered by a rectangle
+ */
+static void CellRange(LG_Rect rect, int* cx0, int* cy0, int* cx1, int* cy1) {
+    int width = rect.width > 0 ? rect.width : 1;
+    int height = rect.height > 0 ? rect.height : 1;
+    *cx0 = CellCoord(rect.x);
+    *cy0 = CellCoord(rect.y);
+    *cx1 = CellCoord(rect.x + width - 1);
+    *cy1 = CellCoord(rect.y + height - 1);
+}
+
+static void CellAdd(SpatialCell* cell, LG_WidgetHandle widget) {
+    if (cell->count == cell->capacity) {
+        int capacity = cell->capacity ? cell->capacity * 2 : 4;
+        LG_WidgetHandle* widgets = (LG_WidgetHandle*)realloc(
+            cell->widgets, (size_t)capacity * sizeof(LG_WidgetHandle));
+        if (!widgets) {
+            fprintf(stderr, "LightGUI: Failed to grow spatial index cell\n");
+            return;
+        }
+        cell->widgets = widgets;
+        cell->capacity = capacity;
+    }
+    cell->widgets[cell->count++] = widget;
+}
+
+static void CellRemove(SpatialCell* cell, LG_WidgetHandle widget) {
+    for (int i = 0; i < cell->count; i++) {
+        if (cell->widgets[i] == widget) {
+            // Order within a cell does not matter; results are sorted by z_order
+            cell->widgets[i] = cell->widgets[--cell->count];
+            return;
+        }
+    }
+}
+
+static bool RectContainsPoint(LG_Rect rect, int x, int y) {
+    return x >= rect.x && x < rect.x + rect.width &&
+           y >= rect.y && y < rect.y + rect.height;
+}
+
+static void IndexRect(LG_SpatialIndex* index, LG_WidgetHandle widget, LG_Rect rect, bool add) {
+    int cx0, cy0, cx1, cy1;
+    CellRange(rect, &cx0, &cy0, &cx1, &cy1);
+
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            SpatialCell* cell = GetCell(index, cx, cy, add);
+            if (!cell) continue;
+
+            if (add) {
+                CellAdd(cell, widget);
+            } else {
+                CellRemove(cell, widget);
+            }
+        }
+    }
+}
+
+void SpatialInsert(LG_WindowHandle window, LG_WidgetHandle widget) {
+    if (!window->spatial) {
+        window->spatial = (LG_SpatialIndex*)calloc(1, sizeof(LG_SpatialIndex));
+        if (!window->spatial) {
+            fprintf(stderr, "LightGUI: Failed to allocate spatial index\n");
+            return;
+        }
+    }
+
+    IndexRect(window->spatial, widget, widget->rect, true);
+}
+
+void SpatialRemove(LG_WindowHandle window, LG_WidgetHandle widget) {
+    if (window->spatial) {
+        IndexRect(window->spatial, widget, widget->rect, false);
+    }
+}
+
+void SpatialMove(LG_WindowHandle window, LG_WidgetHandle widget, LG_Rect old_rect) {
+    if (!window->spatial) {
+        return;
+    }
+
+    int old_cx0, old_cy0, old_cx1, old_cy1;
+    int new_cx0, new_cy0, new_cx1, new_cy1;
+    CellRange(old_rect, &old_cx0, &old_cy0, &old_cx1, &old_cy1);
+    CellRange(widget->rect, &new_cx0, &new_cy0, &new_cx1, &new_cy1);
+
+    // Small moves usually stay within the same cells
+    if (old_cx0 == new_cx0 && old_cy0 == new_cy0 && old_cx1 == new_cx1 && old_cy1 == new_cy1) {
+        return;
+    }
+
+    IndexRect(window->spatial, widget, old_rect, false);
+    IndexRect(window->spatial, widget, widget->rect, true);
+}
+
+void SpatialDestroy(LG_WindowHandle window) {
+    LG_SpatialIndex* index = window->spatial;
+    if (!index) {
+        return;
+    }
+
+    for (size_t i = 0; i < index->capacity; i++) {
+        free(index->cells[i].widgets);
+    }
+    free(index->cells);
+    free(index->results);
+    free(index);
+    window->spatial = NULL;
+}
+
+LG_WidgetHandle SpatialHitTest(LG_WindowHandle window, int x, int y) {
+    if (!window->spatial) {
+        return NULL;
+    }
+
+    SpatialCell* cell = GetCell(window->spatial, CellCoord(x), CellCoord(y), false);
+    if (!cell) {
+        return NULL;
+    }
+
+    // The topmost widget is the one with the highest z_order
+    LG_WidgetHandle hit = NULL;
+    for (int i = 0; i < cell->count; i++) {
+        LG_WidgetHandle widget = cell->widgets[i];
+        if (widget->windowless && widget->visible && RectContainsPoint(widget->rect, x, y) &&
+            (!hit || widget->z_order > hit->z_order)) {
+            hit = widget;
+        }
+    }
+    return hit;
+}
+
+static int CompareZOrder(const void* a, const void* b) {
+    unsigned int za = (*(const LG_WidgetHandle*)a)->z_order;
+    unsigned int zb = (*(const LG_WidgetHandle*)b)->z_order;
+    return (za > zb) - (za < zb);
+}
+
+static bool AddResult(LG_SpatialIndex* index, size_t count, LG_WidgetHandle widget) {
+    if (count == index->result_capacity) {
+        size_t capacity = index->result_capacity ? index->result_capacity * 2 : 32;
+        LG_WidgetHandle* results = (LG_WidgetHandle*)realloc(
+            index->results, capacity * sizeof(LG_WidgetHandle));
+        if (!results) {
+            return false;
+        }
+        index->results = results;
+        index->result_capacity = capacity;
+    }
+    index->results[count] = widget;
+    return true;
+}
+
+size_t SpatialQuery(LG_WindowHandle window, const LG_Rect* rects, int rect_count,
+                    LG_WidgetHandle** results) {
+    *results = NULL;
+    LG_SpatialIndex* index = window->spatial;
+    if (!index || rect_count <= 0) {
+        return 0;
+    }
+
+    // A fresh stamp makes every widget "not yet collected" without a reset pass
+    if (++index->stamp == 0) {
+        for (size_t i = 0; i < window->widgets.count; i++) {
+            window->widgets.widgets[i]->query_stamp = 0;
+        }
+        index->stamp = 1;
+    }
+
+    size_t count = 0;
+    for (int r = 0; r < rect_count; r++) {
+        int cx0, cy0, cx1, cy1;
+        CellRange(rects[r], &cx0, &cy0, &cx1, &cy1);
+
+        for (int cy = cy0; cy <= cy1; cy++) {
+            for (int cx = cx0; cx <= cx1; cx++) {
+                SpatialCell* cell = GetCell(index, cx, cy, false);
+                if (!cell) continue;
+
+                for (int i = 0; i < cell->count; i++) {
+                    LG_WidgetHandle widget = cell->widgets[i];
+                    if (widget->query_stamp == index->stamp ||
+                        !RectIntersect(widget->rect, rects[r], NULL)) {
+                        continue;
+                    }
+
+                    widget->query_stamp = index->stamp;
+                    if (AddResult(index, count, widget)) {
+                        count++;
+                    }
+                }
+            }
+        }
+    }
+
+    if (count > 1) {
+        qsort(index->results, count, sizeof(LG_WidgetHandle), CompareZOrder);
+    }
+    *results = index->results;
+    return count;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file stats.c
+ * @brief Runtime counters and input latency tracking for LG_GetStats
+ *
+ * The hot paths update g_stats directly; they only add to integers and
+ * read the monotonic clock around the phases being timed. Input latency
+ * is measured from the first input event the core receives after a
+ * present until the next flush that presents something, and the last
+ * LG_LATENCY_WINDOW samples are kept for the rolling histogram.
+ */
+
+#include "lightgui_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+LG_Stats g_stats;
+
+static bool g_latency_tracking = false;
+static uint64_t g_input_time = 0;  // Arrival of the oldest input not yet presented, or 0
+static bool g_presented = false;  // Something was presented since the last flush
+static uint32_t g_latency_samples[LG_LATENCY_WINDOW];  // Microseconds, oldest overwritten
+static size_t g_latency_next = 0;
+static size_t g_latency_count = 0;
+static LatencySink g_latency_sink = NULL;  // Also gets every sample, e.g. for a replay
+
+void StatsInputReceived(void) {
+    if ((g_latency_tracking || g_latency_sink) && !g_input_time) {
+        g_input_time = LG_PlatformGetTime();
+    }
+}
+
+void StatsPresented(uint64_t pixels) {
+    g_stats.pixels_presented += pixels;
+    g_presented = true;
+}
+
+void StatsFlushed(void) {
+    if (!g_presented) {
+        return;
+    }
+    g_presented = false;
+
+    if (!g_input_time) {
+        return;
+    }
+
+    uint64_t latency = LG_PlatformGetTime() - g_input_time;
+    uint32_t sample = latency > UINT32_MAX ? UINT32_MAX : (uint32_t)latency;
+    g_input_time = 0;
+
+    if (g_latency_tracking) {
+        g_latency_samples[g_latency_next] = sample;
+        g_latency_next = (g_latency_next + 1) % LG_LATENCY_WINDOW;
+        if (g_latency_count < LG_LATENCY_WINDOW) {
+            g_latency_count++;
+        }
+    }
+    if (g_latency_sink) {
+        g_latency_sink(sample);
+    }
+}
+
+void LG_SetLatencyTracking(bool enabled) {
+    g_latency_tracking = enabled;
+    if (!enabled && !g_latency_sink) {
+        g_input_time = 0;
+    }
+}
+
+void StatsSetLatencySink(LatencySink sink) {
+    g_latency_sink = sink;
+    if (!sink && !g_latency_tracking) {
+        g_input_time = 0;
+    }
+}
+
+static int CompareSamples(const void* a, const void* b) {
+    uint32_t sa = *(const uint32_t*)a;
+    uint32_t sb = *(const uint32_t*)b;
+    return (sa > sb) - (sa < sb);
+}
+
+/**
+ * @brief Get the histogram bucket of a latency sample
+ */
+static int LatencyBucket(uint32_t latency_us) {
+    // Bucket 0 is below 1 ms; each further bucket doubles the upper bound
+    uint32_t ms = latency_us / 1000;
+    int bucket = 0;
+    while (ms > 0 && bucket < LG_LATENCY_BUCKETS - 1) {
+        ms >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void LG_GetStats(LG_Stats* stats) {
+    if (!stats) {
+        return;
+    }
+
+    *stats = g_stats;
+
+    stats->live_widgets = 0;
+    stats->native_widgets = 0;
+    for (size_t i = 0; i < g_windows.count; i++) {
+        size_t live = PoolLiveCount(g_windows.windows[i]->widget_pool);
+        stats->live_widgets += live;
+        stats->native_widgets += live - g_windows.windows[i]->unrealized_count;
+    }
+    stats->raster_kernels = RasterKernelName();
+
+    // Summarize the rolling window of latency samples
+    stats->latency_samples = g_latency_count;
+    if (g_latency_count == 0) {
+        return;
+    }
+
+    uint32_t sorted[LG_LATENCY_WINDOW];
+    memcpy(sorted, g_latency_samples, g_latency_count * sizeof(uint32_t));
+    qsort(sorted, g_latency_count, sizeof(uint32_t), CompareSamples);
+
+    for (size_t i = 0; i < g_latency_count; i++) {
+        stats->latency_histogram[LatencyBucket(sorted[i])]++;
+    }
+    stats->latency_p50_us = sorted[g_latency_count / 2];
+    stats->latency_p99_us = sorted[(g_latency_count * 99) / 100];
+    stats->latency_max_us = sorted[g_latency_count - 1];
+}
+
+void LG_ResetStats(void) {
+    memset(&g_stats, 0, sizeof(g_stats));
+    g_latency_next = 0;
+    g_latency_count = 0;
+    g_input_time = 0;
+}
@@ -0,0 +1,400 @@
+/**
+ * @file timer.c
+ * @brief Timers and widget animations driven by the event loop
+ *
+ * Timers sit in a binary min-heap ordered by deadline, so finding the next
+ * one due is O(1) and adding, firing or removing one is O(log n). The
+ * event loop blocks until the earliest deadline and no longer, and never
+ * wakes for timers that are not due.
+ *
+ * Animations are stepped once per frame by the frame loop rather than by
+ * timers, so they move in step with the display and each step damages
+ * only the widgets it changes.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* heap_index of a timer whose callback is running */
+#define TIMER_NOT_QUEUED ((size_t)-1)
+
+/**
+ * @brief A timer added with LG_AddTimer
+ */
+struct LG_Timer {
+    uint64_t deadline;  // LG_PlatformGetTime() when next due
+    uint64_t interval_us;
+    LG_TimerCallback callback;
+    void* user_data;
+    size_t heap_index;  // Position in g_timers, or TIMER_NOT_QUEUED
+    bool removed;  // Removed from inside its own callback
+};
+
+/**
+ * @brief One property of a widget moving toward a target
+ */
+typedef struct {
+    LG_WidgetHandle widget;
+    LG_AnimateProperty property;
+    int from[4];  // One value for geometry, r, g, b and a for colors
+    int to[4];
+    uint64_t start;  // LG_PlatformGetTime() when started
+    uint64_t duration_us;
+} Animation;
+
+static LG_TimerHandle* g_timers = NULL;  // Min-heap on deadline
+static size_t g_timer_count = 0;
+static size_t g_timer_capacity = 0;
+
+static Animation* g_animations = NULL;
+static size_t g_animation_count = 0;
+static size_t g_animation_capacity = 0;
+
+/* ========================================================================= */
+/*                        Timer Heap                                         */
+/* ========================================================================= */
+
+static void PlaceTimer(size_t index, LG_TimerHandle timer) {
+    g_timers[index] = timer;
+    timer->heap_index = index;
+}
+
+static void SiftUp(size_t index) {
+    LG_TimerHandle timer = g_timers[index];
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (g_timers[parent]->deadline <= timer->deadline) {
+            break;
+        }
+        PlaceTimer(index, g_timers[parent]);
+        index = parent;
+    }
+    PlaceTimer(index, timer);
+}
+
+static void SiftDown(size_t index) {
+    LG_TimerHandle timer = g_timers[index];
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= g_timer_count) {
+            break;
+        }
+        if (child + 1 < g_timer_count && g_timers[child + 1]->deadline < g_timers[child]->deadline) {
+            child++;
+        }
+        if (timer->deadline <= g_timers[child]->deadline) {
+            break;
+        }
+        PlaceTimer(index, g_timers[child]);
+        index = child;
+    }
+    PlaceTimer(index, timer);
+}
+
+static bool PushTimer(LG_TimerHandle timer) {
+    if (g_timer_count == g_timer_capacity) {
+        size_t capacity = g_timer_capacity ? g_timer_capacity * 2 : 16;
+        LG_TimerHandle* timers = (LG_TimerHandle*)realloc(g_timers, capacity * sizeof(LG_TimerHandle));
+        if (!timers) {
+            return false;
+        }
+        g_timers = timers;
+        g_timer_capacity = capacity;
+    }
+
+    g_timers[g_timer_count] = timer;
+    SiftUp(g_timer_count++);
+    return true;
+}
+
+/**
+ * @brief Take a timer out of the heap, wherever it is
+ */
+static void UnqueueTimer(LG_TimerHandle timer) {
+    size_t index = timer->heap_index;
+    timer->heap_index = TIMER_NOT_QUEUED;
+
+    LG_TimerHandle last = g_timers[--g_timer_count];
+    if (index == g_timer_count) {
+        return;
+    }
+
+    // The last timer fills the hole and moves whichever way it belongs
+    PlaceTimer(index, last);
+    if (index > 0 && g_timers[(index - 1) / 2]->deadline > last->deadline) {
+        SiftUp(index);
+    } else {
+        SiftDown(index);
+    }
+}
+
+/* ========================================================================= */
+/*                        Timers                                             */
+/* ========================================================================= */
+
+LG_TimerHandle LG_AddTimer(int interval_ms, LG_TimerCallback callback, void* user_data) {
+    if (!callback) {
+        return NULL;
+    }
+
+    LG_TimerHandle timer = (LG_TimerHandle)calloc(1, sizeof(struct LG_Timer));
+    if (!timer) {
+        fprintf(stderr, "LightGUI: Failed to allocate timer\n");
+        return NULL;
+    }
+
+    // A zero interval would keep the loop firing the same timer
+    timer->interval_us = (uint64_t)(interval_ms > 0 ? interval_ms : 1) * 1000;
+    timer->deadline = LG_PlatformGetTime() + timer->interval_us;
+    timer->callback = callback;
+    timer->user_data = user_data;
+
+    if (!PushTimer(timer)) {
+        fprintf(stderr, "LightGUI: Failed to grow timer heap\n");
+        free(timer);
+        return NULL;
+    }
+    return timer;
+}
+
+void LG_RemoveTimer(LG_TimerHandle timer) {
+    if (!timer) {
+        return;
+    }
+
+    // RunTimers frees a timer removed by its own callback once that returns
+    if (timer->heap_index == TIMER_NOT_QUEUED) {
+        timer->removed = true;
+        return;
+    }
+
+    UnqueueTimer(timer);
+    free(timer);
+}
+
+int TimersWaitTimeout(int timeout_ms) {
+    if (g_timer_count == 0) {
+        return timeout_ms;
+    }
+
+    // Rounded up, so the wait never ends just before the deadline
+    uint64_t now = LG_PlatformGetTime();
+    uint64_t deadline = g_timers[0]->deadline;
+    int64_t wait_ms = deadline > now ? (int64_t)((deadline - now + 999) / 1000) : 0;
+    if (timeout_ms >= 0 && wait_ms >= timeout_ms) {
+        return timeout_ms;
+    }
+    return wait_ms > INT32_MAX ? INT32_MAX : (int)wait_ms;
+}
+
+void RunTimers(void) {
+    if (g_timer_count == 0) {
+        return;
+    }
+
+    // Only timers due now; rescheduled ones land after now, so this ends
+    uint64_t now = LG_PlatformGetTime();
+    while (g_timer_count > 0 && g_timers[0]->deadline <= now) {
+        LG_TimerHandle timer = g_timers[0];
+        UnqueueTimer(timer);
+
+        uint64_t start = LG_PlatformGetTime();
+        timer->callback(timer, timer->user_data);
+        g_stats.callback_us += LG_PlatformGetTime() - start;
+
+        if (timer->removed) {
+            free(timer);
+            continue;
+        }
+
+        // Keep the original cadence, skipping ticks that were missed entirely
+        timer->deadline += timer->interval_us;
+        if (timer->deadline <= now) {
+            timer->deadline = now + timer->interval_us;
+        }
+        if (!PushTimer(timer)) {
+            fprintf(stderr, "LightGUI: Failed to grow timer heap\n");
+            free(timer);
+        }
+    }
+}
+
+/* ========================================================================= */
+/*                        Animations                                         */
+/* ========================================================================= */
+
+static bool IsColorProperty(LG_AnimateProperty property) {
+    return property == LG_ANIMATE_BACKGROUND_COLOR || property == LG_ANIMATE_TEXT_COLOR;
+}
+
+/**
+ * @brief Read the current value of an animated property
+ */
+static void GetProperty(LG_WidgetHandle widget, LG_AnimateProperty property, int value[4]) {
+    switch (property) {
+        case LG_ANIMATE_X:      value[0] = widget->rect.x; break;
+        case LG_ANIMATE_Y:      value[0] = widget->rect.y; break;
+        case LG_ANIMATE_WIDTH:  value[0] = widget->rect.width; break;
+        case LG_ANIMATE_HEIGHT: value[0] = widget->rect.height; break;
+        case LG_ANIMATE_BACKGROUND_COLOR:
+        case LG_ANIMATE_TEXT_COLOR: {
+            LG_Color color = property == LG_ANIMATE_TEXT_COLOR ? widget->text_color : widget->bg_color;
+            value[0] = color.r;
+            value[1] = color.g;
+            value[2] = color.b;
+            value[3] = color.a;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Set an animated property through the regular setter, if it changed
+ *
+ * The setters damage only the widget's old and new rectangles.
+ */
+static void SetProperty(LG_WidgetHandle widget, LG_AnimateProperty property, const int value[4]) {
+    int current[4] = {0, 0, 0, 0};
+    GetProperty(widget, property, current);
+    if (memcmp(current, value, sizeof(current)) == 0) {
+        return;
+    }
+
+    LG_Color color = LG_CreateColor((uint8_t)value[0], (uint8_t)value[1], (uint8_t)value[2],
+                                    (uint8_t)value[3]);
+    switch (property) {
+        case LG_ANIMATE_X:      LG_SetWidgetPosition(widget, value[0], widget->rect.y); break;
+        case LG_ANIMATE_Y:      LG_SetWidgetPosition(widget, widget->rect.x, value[0]); break;
+        case LG_ANIMATE_WIDTH:  LG_SetWidgetSize(widget, value[0], widget->rect.height); break;
+        case LG_ANIMATE_HEIGHT: LG_SetWidgetSize(widget, widget->rect.width, value[0]); break;
+        case LG_ANIMATE_BACKGROUND_COLOR: LG_SetWidgetBackgroundColor(widget, color); break;
+        case LG_ANIMATE_TEXT_COLOR:       LG_SetWidgetTextColor(widget, color); break;
+    }
+}
+
+/**
+ * @brief Remove the animation at index, moving the last one into its place
+ */
+static void RemoveAnimation(size_t index) {
+    g_animations[index] = g_animations[--g_animation_count];
+}
+
+/**
+ * @brief Start animating a property from its current value
+ */
+static bool StartAnimation(LG_WidgetHandle widget, LG_AnimateProperty property,
+                           const int target[4], int duration_ms) {
+    // A new animation of the same property takes over from the old one
+    for (size_t i = 0; i < g_animation_count; i++) {
+        if (g_animations[i].widget == widget && g_animations[i].property == property) {
+            RemoveAnimation(i);
+            break;
+        }
+    }
+
+    if (duration_ms <= 0) {
+        SetProperty(widget, property, target);
+        return true;
+    }
+
+    if (g_animation_count == g_animation_capacity) {
+        size_t capacity = g_animation_capacity ? g_animation_capacity * 2 : 16;
+        Animation* animations = (Animation*)realloc(g_animations, capacity * sizeof(Animation));
+        if (!animations) {
+            fprintf(stderr, "LightGUI: Failed to grow animation list\n");
+            return false;
+        }
+        g_animations = animations;
+        g_animation_capacity = capacity;
+    }
+
+    Animation* animation = &g_animations[g_animation_count++];
+    memset(animation, 0, sizeof(*animation));
+    animation->widget = widget;
+    animation->property = property;
+    GetProperty(widget, property, animation->from);
+    memcpy(animation->to, target, sizeof(animation->to));
+    animation->start = LG_PlatformGetTime();
+    animation->duration_us = (uint64_t)duration_ms * 1000;
+    return true;
+}
+
+bool LG_Animate(LG_WidgetHandle widget, LG_AnimateProperty property, int target, int duration_ms) {
+    if (!widget || IsColorProperty(property)) {
+        return false;
+    }
+
+    int value[4] = {target, 0, 0, 0};
+    return StartAnimation(widget, property, value, duration_ms);
+}
+
+bool LG_AnimateColor(LG_WidgetHandle widget, LG_AnimateProperty property, LG_Color target,
+                     int duration_ms) {
+    if (!widget || !IsColorProperty(property)) {
+        return false;
+    }
+
+    int value[4] = {target.r, target.g, target.b, target.a};
+    return StartAnimation(widget, property, value, duration_ms);
+}
+
+bool AnimationsRunning(void) {
+    return g_animation_count > 0;
+}
+
+void StepAnimations(uint64_t now) {
+    size_t i = 0;
+    while (i < g_animation_count) {
+        Animation* animation = &g_animations[i];
+        uint64_t elapsed = now > animation->start ? now - animation->start : 0;
+        bool done = elapsed >= animation->duration_us;
+
+        // Eased in and out, so motion starts and stops without a jolt
+        float t = done ? 1.0f : (float)elapsed / (float)animation->duration_us;
+        float eased = t * t * (3.0f - 2.0f * t);
+
+        int value[4];
+        for (int k = 0; k < 4; k++) {
+            float delta = (float)(animation->to[k] - animation->from[k]) * eased;
+            value[k] = animation->from[k] + (int)(delta < 0 ? delta - 0.5f : delta + 0.5f);
+        }
+
+        // Copied out first, since removal moves another animation into this slot
+        LG_WidgetHandle widget = animation->widget;
+        LG_AnimateProperty property = animation->property;
+        if (done) {
+            RemoveAnimation(i);
+        } else {
+            i++;
+        }
+        SetProperty(widget, property, value);
+    }
+}
+
+void CancelWidgetAnimations(LG_WidgetHandle widget) {
+    size_t i = 0;
+    while (i < g_animation_count) {
+        if (g_animations[i].widget == widget) {
+            RemoveAnimation(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+void TimersTerminate(void) {
+    for (size_t i = 0; i < g_timer_count; i++) {
+        free(g_timers[i]);
+    }
+    free(g_timers);
+    g_timers = NULL;
+    g_timer_count = 0;
+    g_timer_capacity = 0;
+
+    free(g_animations);
+    g_animations = NULL;
+    g_animation_count = 0;
+    g_animation_capacity = 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file workers.c
+ * @brief Worker threads that rasterize windows in parallel
+ *
+ * The pool runs one batch at a time: the main thread publishes the items,
+ * wakes the workers and works through the batch alongside them, taking
+ * the next item under the lock. It returns once every item has finished,
+ * so the core never runs while a worker is still drawing. Batches are one
+ * item per damaged window, so a lock per item costs nothing measurable.
+ */
+
+#include "lightgui_internal.h"
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+typedef HANDLE WorkerThread;
+static SRWLOCK g_lock = SRWLOCK_INIT;
+static CONDITION_VARIABLE g_work_ready = CONDITION_VARIABLE_INIT;  // A batch started or stopping
+static CONDITION_VARIABLE g_work_done = CONDITION_VARIABLE_INIT;  // The last item finished
+#else
+typedef pthread_t WorkerThread;
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_work_ready = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_work_done = PTHREAD_COND_INITIALIZER;
+#endif
+
+static WorkerThread g_threads[LG_MAX_RENDER_THREADS];
+static int g_thread_count = 0;
+static bool g_stopping = false;
+
+/* The current batch; guarded by g_lock */
+static void (*g_func)(void* item) = NULL;
+static void** g_items = NULL;
+static size_t g_item_count = 0;
+static size_t g_next_item = 0;
+static size_t g_finished_items = 0;
+static unsigned g_batch = 0;  // Incremented for every batch
+
+/* ========================================================================= */
+/*                        Locking                                            */
+/* ========================================================================= */
+
+static void Lock(void) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(&g_lock);
+#else
+    pthread_mutex_lock(&g_lock);
+#endif
+}
+
+static void Unlock(void) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(&g_lock);
+#else
+    pthread_mutex_unlock(&g_lock);
+#endif
+}
+
+#ifdef _WIN32
+static void Wait(CONDITION_VARIABLE* cond) {
+    SleepConditionVariableSRW(cond, &g_lock, INFINITE, 0);
+}
+
+static void WakeAll(CONDITION_VARIABLE* cond) {
+    WakeAllConditionVariable(cond);
+}
+#else
+static void Wait(pthread_cond_t* cond) {
+    pthread_cond_wait(cond, &g_lock);
+}
+
+static void WakeAll(pthread_cond_t* cond) {
+    pthread_cond_broadcast(cond);
+}
+#endif
+
+/* ========================================================================= */
+/*                        Batches                                            */
+/* ========================================================================= */
+
+/**
+ * @brief Run items of the current batch until none are left; called locked
+ */
+static void RunItems(void) {
+    while (g_next_item < g_item_count) {
+        void (*func)(void* item) = g_func;
+        void* item = g_items[g_next_item++];
+
+        Unlock();
+        func(item);
+        Lock();
+
+        if (++g_finished_items == g_item_count) {
+            WakeAll(&g_work_done);
+        }
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI WorkerMain(LPVOID arg) {
+#else
+static void* WorkerMain(void* arg) {
+#endif
+    (void)arg;
+
+    Lock();
+    unsigned seen = g_batch;
+    while (!g_stopping) {
+        if (g_batch == seen) {
+            Wait(&g_work_ready);
+            continue;
+        }
+        seen = g_batch;
+        RunItems();
+    }
+    Unlock();
+
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+void WorkersRun(void (*func)(void* item), void** items, size_t count) {
+    if (g_thread_count == 0 || count < 2) {
+        for (size_t i = 0; i < count; i++) {
+            func(items[i]);
+        }
+        return;
+    }
+
+    Lock();
+    g_func = func;
+    g_items = items;
+    g_item_count = count;
+    g_next_item = 0;
+    g_finished_items = 0;
+    g_batch++;
+    WakeAll(&g_work_ready);
+
+    RunItems();
+    while (g_finished_items < g_item_count) {
+        Wait(&g_work_done);
+    }
+    g_items = NULL;
+    g_item_count = 0;
+    Unlock();
+}
+
+/* ========================================================================= */
+/*                        Thread Management                                  */
+/* ========================================================================= */
+
+static int ProcessorCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+void WorkersStop(void) {
+    if (g_thread_count == 0) {
+        return;
+    }
+
+    Lock();
+    g_stopping = true;
+    WakeAll(&g_work_ready);
+    Unlock();
+
+    for (int i = 0; i < g_thread_count; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(g_threads[i], INFINITE);
+        CloseHandle(g_threads[i]);
+#else
+        pthread_join(g_threads[i], NULL);
+#endif
+    }
+
+    g_thread_count = 0;
+    g_stopping = false;
+}
+
+bool WorkersStart(int threads) {
+    if (threads == 0) {
+        threads = ProcessorCount();
+    }
+    if (threads > LG_MAX_RENDER_THREADS) {
+        threads = LG_MAX_RENDER_THREADS;
+    }
+
+    // The main thread takes part in every batch, so it is one of the threads
+    int workers = threads > 1 ? threads - 1 : 0;
+    if (workers == g_thread_count) {
+        return true;
+    }
+
+    WorkersStop();
+    for (int i = 0; i < workers; i++) {
+#ifdef _WIN32
+        g_threads[i] = CreateThread(NULL, 0, WorkerMain, NULL, 0, NULL);
+        bool created = g_threads[i] != NULL;
+#else
+        bool created = pthread_create(&g_threads[i], NULL, WorkerMain, NULL) == 0;
+#endif
+        if (!created) {
+            fprintf(stderr, "LightGUI: Failed to start render thread\n");
+            WorkersStop();
+            return false;
+        }
+        g_thread_count++;
+    }
+    return true;
+}
+
+int WorkersCount(void) {
+    return g_thread_count;
+}